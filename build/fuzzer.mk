@@ -35,7 +35,7 @@ FUZZ_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(FUZZER_SRC_DIR)/FuzzAirspaceParser.cpp
-FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
+FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE THREAD ZZIP GEO MATH UTIL
 $(eval $(call link-program,FuzzAirspaceParser,FUZZ_AIRSPACE_PARSER))
 
 FUZZ_TOPOGRAPHY_FILE_SOURCES = \
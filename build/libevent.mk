@@ -7,6 +7,7 @@ EVENT_SOURCES = \
 ifeq ($(USE_POLL_EVENT),y)
 EVENT_SOURCES += \
 	$(SRC)/ui/event/poll/Timer.cpp \
+	$(SRC)/ui/event/poll/IdleEvent.cpp \
 	$(SRC)/ui/event/poll/Loop.cpp \
 	$(SRC)/ui/event/poll/Queue.cpp
 POLL_EVENT_CPPFLAGS = -DUSE_POLL_EVENT
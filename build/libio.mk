@@ -17,9 +17,11 @@ IO_SOURCES = \
 	$(IO_SRC_DIR)/FileTransaction.cpp \
 	$(IO_SRC_DIR)/FileCache.cpp \
 	$(IO_SRC_DIR)/ZipArchive.cpp \
+	$(IO_SRC_DIR)/ZipIndex.cpp \
 	$(IO_SRC_DIR)/ZipReader.cpp \
 	$(IO_SRC_DIR)/StringConverter.cpp \
 	$(IO_SRC_DIR)/ConvertLineReader.cpp \
+	$(IO_SRC_DIR)/ReadAheadReader.cpp \
 	$(IO_SRC_DIR)/FileLineReader.cpp \
 	$(IO_SRC_DIR)/KeyValueFileReader.cpp \
 	$(IO_SRC_DIR)/KeyValueFileWriter.cpp \
@@ -29,3 +31,9 @@ IO_SOURCES = \
 IO_CPPFLAGS_INTERNAL = $(ZLIB_CPPFLAGS)
 
 $(eval $(call link-library,io,IO))
+
+# ReadAheadReader runs a Thread; the library is listed again in
+# LDLIBS, because make drops duplicate prerequisites, which may leave
+# it in front of other libraries which need it
+IO_LDADD += $(THREAD_LDADD)
+IO_LDLIBS += $(THREAD_LDADD)
@@ -17,7 +17,8 @@ UTIL_SOURCES = \
 	$(UTIL_SRC_DIR)/StringBuilder.cxx \
 	$(UTIL_SRC_DIR)/StringCompare.cxx \
 	$(UTIL_SRC_DIR)/StringStrip.cxx \
-	$(UTIL_SRC_DIR)/StringUtil.cpp
+	$(UTIL_SRC_DIR)/StringUtil.cpp \
+	$(UTIL_SRC_DIR)/NGramIndex.cpp
 
 ifeq ($(HAVE_MSVCRT),y)
 UTIL_SOURCES += \
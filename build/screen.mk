@@ -50,6 +50,8 @@ ifeq ($(LIBJPEG),y)
 SCREEN_CUSTOM_SOURCES_IMG += $(CANVAS_SRC_DIR)/custom/LibJPEG.cpp
 endif
 
+SCREEN_CUSTOM_SOURCES_IMG += $(CANVAS_SRC_DIR)/custom/ResourceImageCache.cpp
+
 ifeq ($(TIFF),y)
 SCREEN_CUSTOM_SOURCES_IMG += $(CANVAS_SRC_DIR)/custom/LibTiff.cpp
 endif
@@ -102,13 +102,20 @@ TEST_NAMES = \
 	TestValidity TestUTM \
 	TestAllocatedGrid \
 	TestRadixTree TestGeoBounds TestGeoClip \
+	TestPackedPointIndex \
+	TestNGramIndex \
+	TestTaskScheduler \
+	TestIdleEvent \
+	TestReadAheadReader \
+	TestVarioSynthesiser \
+	TestAdaptiveLatency \
 	TestLogger TestGRecord TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
 	TestColorRamp TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
-	TestMacCready TestOrderedTask TestAATPoint \
+	TestMacCready TestOrderedTask TestAbortTask TestAATPoint \
 	TestPlanes \
 	TestTaskPoint \
 	TestTaskWaypoint \
@@ -118,6 +125,12 @@ TEST_NAMES = \
 	TestMETARParser \
 	TestIGCParser \
 	TestStrings TestUTF8 \
+	TestXMLPullParser \
+	TestTaskIndex \
+	TestFlightIndex \
+	TestZipIndex \
+	TestLabelBlock \
+	TestResourceImageCache \
 	TestCRC \
 	TestUnitsFormatter \
 	TestGeoPointFormatter \
@@ -201,7 +214,7 @@ TEST_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAirspaceParser.cpp
 TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-TEST_AIRSPACE_PARSER_DEPENDS = OPERATION IO OS AIRSPACE ZZIP GEO MATH UTIL
+TEST_AIRSPACE_PARSER_DEPENDS = OPERATION IO OS AIRSPACE THREAD ZZIP GEO MATH UTIL
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
 TEST_DATE_TIME_SOURCES = \
@@ -248,6 +261,15 @@ TEST_ORDERED_TASK_OBJS = $(call SRC_TO_OBJ,$(TEST_ORDERED_TASK_SOURCES))
 TEST_ORDERED_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
 $(eval $(call link-program,TestOrderedTask,TEST_ORDERED_TASK))
 
+TEST_ABORT_TASK_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAbortTask.cpp
+TEST_ABORT_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+$(eval $(call link-program,TestAbortTask,TEST_ABORT_TASK))
+
 TEST_AAT_POINT_SOURCES = \
 	$(SRC)/Engine/Util/Gradient.cpp \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
@@ -322,7 +344,7 @@ TEST_ROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/harness_airspace.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_route.cpp
-TEST_ROUTE_DEPENDS = TERRAIN OPERATION IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+TEST_ROUTE_DEPENDS = TERRAIN OPERATION IO ZZIP OS ROUTE AIRSPACE THREAD GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
@@ -498,6 +520,72 @@ TEST_UTF8_SOURCES = \
 TEST_UTF8_DEPENDS = UTIL
 $(eval $(call link-program,TestUTF8,TEST_UTF8))
 
+TEST_XML_PULL_PARSER_SOURCES = \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestXMLPullParser.cpp
+TEST_XML_PULL_PARSER_DEPENDS = IO OS UTIL
+$(eval $(call link-program,TestXMLPullParser,TEST_XML_PULL_PARSER))
+
+TEST_TASK_INDEX_SOURCES = \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/XML/DataNode.cpp \
+	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/Task/Serialiser.cpp \
+	$(SRC)/Task/Deserialiser.cpp \
+	$(SRC)/Task/LoadFile.cpp \
+	$(SRC)/Task/TaskFile.cpp \
+	$(SRC)/Task/TaskFileXCSoar.cpp \
+	$(SRC)/Task/TaskFileIGC.cpp \
+	$(SRC)/Task/TaskFileSeeYou.cpp \
+	$(SRC)/Task/TaskIndex.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/io/FileCache.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTaskIndex.cpp
+TEST_TASK_INDEX_DEPENDS = TASK ROUTE GLIDE WAYPOINT OPERATION IO OS THREAD ZZIP GEO TIME MATH UTIL
+$(eval $(call link-program,TestTaskIndex,TEST_TASK_INDEX))
+
+TEST_FLIGHT_INDEX_SOURCES = \
+	$(SRC)/Logger/FlightParser.cpp \
+	$(SRC)/Logger/FlightIndex.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlightIndex.cpp
+TEST_FLIGHT_INDEX_DEPENDS = IO OS TIME UTIL
+$(eval $(call link-program,TestFlightIndex,TEST_FLIGHT_INDEX))
+
+TEST_ZIP_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestZipIndex.cpp
+TEST_ZIP_INDEX_DEPENDS = IO OS ZZIP UTIL
+$(eval $(call link-program,TestZipIndex,TEST_ZIP_INDEX))
+
+TEST_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLabelBlock.cpp
+$(eval $(call link-program,TestLabelBlock,TEST_LABEL_BLOCK))
+
+TEST_RESOURCE_IMAGE_CACHE_SOURCES = \
+	$(SRC)/ui/canvas/custom/ResourceImageCache.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestResourceImageCache.cpp
+TEST_RESOURCE_IMAGE_CACHE_DEPENDS = THREAD OS IO UTIL
+$(eval $(call link-program,TestResourceImageCache,TEST_RESOURCE_IMAGE_CACHE))
+
 TEST_POLARS_SOURCES = \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
@@ -616,6 +704,51 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_PACKED_POINT_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPackedPointIndex.cpp
+TEST_PACKED_POINT_INDEX_DEPENDS = UTIL
+$(eval $(call link-program,TestPackedPointIndex,TEST_PACKED_POINT_INDEX))
+
+TEST_NGRAM_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestNGramIndex.cpp
+TEST_NGRAM_INDEX_DEPENDS = UTIL
+$(eval $(call link-program,TestNGramIndex,TEST_NGRAM_INDEX))
+
+TEST_TASK_SCHEDULER_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTaskScheduler.cpp
+TEST_TASK_SCHEDULER_DEPENDS = THREAD UTIL
+$(eval $(call link-program,TestTaskScheduler,TEST_TASK_SCHEDULER))
+
+TEST_IDLE_EVENT_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestIdleEvent.cpp
+TEST_IDLE_EVENT_DEPENDS = ASYNC OS IO THREAD UTIL
+$(eval $(call link-program,TestIdleEvent,TEST_IDLE_EVENT))
+
+TEST_READ_AHEAD_READER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestReadAheadReader.cpp
+TEST_READ_AHEAD_READER_DEPENDS = IO UTIL
+$(eval $(call link-program,TestReadAheadReader,TEST_READ_AHEAD_READER))
+
+TEST_VARIO_SYNTHESISER_SOURCES = \
+	$(SRC)/Audio/ToneSynthesiser.cpp \
+	$(SRC)/Audio/VarioSynthesiser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestVarioSynthesiser.cpp
+TEST_VARIO_SYNTHESISER_DEPENDS = MATH UTIL
+$(eval $(call link-program,TestVarioSynthesiser,TEST_VARIO_SYNTHESISER))
+
+TEST_ADAPTIVE_LATENCY_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAdaptiveLatency.cpp
+TEST_ADAPTIVE_LATENCY_DEPENDS = UTIL
+$(eval $(call link-program,TestAdaptiveLatency,TEST_ADAPTIVE_LATENCY))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -725,6 +858,7 @@ DEBUG_PROGRAM_NAMES = \
 	FlightTable \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkZipSeek \
 	DumpTextFile DumpTextZip DumpTextInflate \
 	DumpHexColor \
 	RunXMLParser \
@@ -818,7 +952,7 @@ DEBUG_PROGRAM_NAMES += RunWPASupplicant
 endif
 
 ifeq ($(HAVE_PCM_PLAYER)$(TARGET_IS_ANDROID),yn)
-DEBUG_PROGRAM_NAMES += PlayTone PlayVario DumpVario
+DEBUG_PROGRAM_NAMES += PlayTone PlayVario DumpVario RunPCMMixer
 endif
 
 ifeq ($(LUA),y)
@@ -901,6 +1035,11 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_ZIP_SEEK_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkZipSeek.cpp
+BENCHMARK_ZIP_SEEK_DEPENDS = IO OS ZZIP UTIL
+$(eval $(call link-program,BenchmarkZipSeek,BENCHMARK_ZIP_SEEK))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1104,8 +1243,9 @@ $(eval $(call link-program,ReadGRecord,READ_GRECORD))
 VERIFY_GRECORD_SOURCES = \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/util/MD5.cpp \
+	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/VerifyGRecord.cpp
-VERIFY_GRECORD_DEPENDS = IO OS UTIL
+VERIFY_GRECORD_DEPENDS = IO OS THREAD UTIL
 $(eval $(call link-program,VerifyGRecord,VERIFY_GRECORD))
 
 APPEND_GRECORD_SOURCES = \
@@ -1242,7 +1382,7 @@ RUN_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/FakeLanguage.cpp \
 	$(TEST_SRC_DIR)/RunAirspaceParser.cpp
 RUN_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE OPERATION IO OS ZZIP GEO MATH UTIL
+RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE OPERATION IO OS THREAD ZZIP GEO MATH UTIL
 $(eval $(call link-program,RunAirspaceParser,RUN_AIRSPACE_PARSER))
 
 ENUMERATE_PORTS_SOURCES = \
@@ -1496,6 +1636,8 @@ RUN_FLIGHT_LOGGER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/CirclingComputer.cpp \
 	$(SRC)/Logger/FlightLogger.cpp \
+	$(SRC)/Logger/FlightParser.cpp \
+	$(SRC)/Logger/FlightIndex.cpp \
 	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/RunFlightLogger.cpp
 RUN_FLIGHT_LOGGER_LDADD = $(DEBUG_REPLAY_LDADD)
@@ -1826,8 +1968,8 @@ RUN_MAP_WINDOW_DEPENDS = \
 	SCREEN EVENT \
 	RESOURCE \
 	OPERATION \
-	ASYNC OS IO THREAD \
-	TASK ROUTE GLIDE WAYPOINT AIRSPACE \
+	ASYNC OS IO \
+	TASK ROUTE GLIDE WAYPOINT AIRSPACE THREAD \
 	JASPER ZZIP LIBNMEA GEO MATH TIME UTIL
 $(eval $(call link-program,RunMapWindow,RUN_MAP_WINDOW))
 
@@ -2239,8 +2381,8 @@ RUN_ANALYSIS_DEPENDS = \
 	LOOK \
 	OPERATION \
 	SCREEN EVENT RESOURCE LIBCOMPUTER LIBNMEA ASYNC IO DATA_FIELD \
-	OS THREAD \
-	CONTEST TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
+	OS \
+	CONTEST TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE THREAD ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
@@ -2287,7 +2429,7 @@ RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(TEST_SRC_DIR)/Fonts.cpp \
 	$(TEST_SRC_DIR)/RunAirspaceWarningDialog.cpp
 RUN_AIRSPACE_WARNING_DIALOG_LDADD = $(FAKE_LIBS)
-RUN_AIRSPACE_WARNING_DIALOG_DEPENDS = OPERATION FORM WIDGET DATA_FIELD SCREEN AUDIO EVENT RESOURCE ASYNC IO OS THREAD AIRSPACE ZZIP UTIL GEO MATH TIME
+RUN_AIRSPACE_WARNING_DIALOG_DEPENDS = OPERATION FORM WIDGET DATA_FIELD SCREEN AUDIO EVENT RESOURCE ASYNC IO OS AIRSPACE THREAD ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAirspaceWarningDialog,RUN_AIRSPACE_WARNING_DIALOG))
 
 RUN_PROFILE_LIST_DIALOG_SOURCES = \
@@ -2323,6 +2465,13 @@ PLAY_TONE_SOURCES = \
 PLAY_TONE_DEPENDS = AUDIO MATH SCREEN EVENT ASYNC THREAD OS IO UTIL
 $(eval $(call link-program,PlayTone,PLAY_TONE))
 
+RUN_PCM_MIXER_SOURCES = \
+	$(SRC)/Hardware/DisplayDPI.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/RunPCMMixer.cpp
+RUN_PCM_MIXER_DEPENDS = AUDIO MATH SCREEN EVENT ASYNC THREAD OS IO UTIL
+$(eval $(call link-program,RunPCMMixer,RUN_PCM_MIXER))
+
 PLAY_VARIO_SOURCES = \
 	$(SRC)/Hardware/DisplayDPI.cpp \
 	$(DEBUG_REPLAY_SOURCES) \
@@ -2,6 +2,7 @@ ZZIPSRC	= $(SRC)/zzip
 ZZIP_SOURCES = \
 	$(ZZIPSRC)/fetch.c \
 	$(ZZIPSRC)/file.c 		\
+	$(ZZIPSRC)/index.c \
 	$(ZZIPSRC)/plugin.c \
 	$(ZZIPSRC)/zip.c \
 	$(ZZIPSRC)/stat.c
@@ -75,7 +75,8 @@ void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              AtmosphericPressure press,
-             OperationEnvironment &operation)
+             OperationEnvironment &operation,
+             TaskScheduler *scheduler)
 {
   LogFormat("ReadAirspace");
   operation.SetText(_("Loading Airspace File..."));
@@ -101,11 +102,11 @@ ReadAirspace(Airspaces &airspaces,
   }
 
   if (airspace_ok) {
-    airspaces.Optimise();
+    airspaces.Optimise(scheduler);
     airspaces.SetFlightLevels(press);
 
     if (terrain != NULL)
-      airspaces.SetGroundLevels(*terrain);
+      airspaces.SetGroundLevels(*terrain, scheduler);
   } else
     // there was a problem
     airspaces.Clear();
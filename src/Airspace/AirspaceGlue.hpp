@@ -27,12 +27,17 @@ class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
 class OperationEnvironment;
+class TaskScheduler;
 
 /**
  * Reads the airspace files into the memory
+ *
+ * @param scheduler an optional #TaskScheduler used to prepare the
+ * airspaces in parallel
  */
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              AtmosphericPressure press,
-             OperationEnvironment &operation);
+             OperationEnvironment &operation,
+             TaskScheduler *scheduler=nullptr);
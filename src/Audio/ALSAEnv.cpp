@@ -37,6 +37,7 @@ namespace ALSAEnv
 
 static constexpr char ALSA_DEVICE_ENV[] = "ALSA_DEVICE";
 static constexpr char ALSA_LATENCY_ENV[] = "ALSA_LATENCY";
+static constexpr char ALSA_MAX_LATENCY_ENV[] = "ALSA_MAX_LATENCY";
 
 static constexpr char DEFAULT_ALSA_DEVICE[] = "default";
 static constexpr unsigned DEFAULT_ALSA_LATENCY = 100000;
@@ -72,6 +73,24 @@ static unsigned InitALSALatency()
   return latency;
 }
 
+static unsigned InitALSAMaxLatency()
+{
+  const char *latency_env_value = getenv(ALSA_MAX_LATENCY_ENV);
+  if ((nullptr == latency_env_value) || ('\0' == *latency_env_value))
+    return 0;
+
+  char *p;
+  unsigned latency = ParseUnsigned(latency_env_value, &p);
+  if (*p != '\0') {
+    LogFormat("Invalid %s value \"%s\"", ALSA_MAX_LATENCY_ENV,
+              latency_env_value);
+    return 0;
+  }
+
+  LogFormat("Using adaptive ALSA PCM latency up to %u μs", latency);
+  return latency;
+}
+
 const char *GetALSADeviceName()
 {
   static const char *alsa_device = InitALSADeviceName();
@@ -85,4 +104,10 @@ unsigned GetALSALatency()
   return alsa_latency;
 }
 
+unsigned GetALSAMaxLatency()
+{
+  static unsigned alsa_max_latency = InitALSAMaxLatency();
+  return alsa_max_latency;
+}
+
 }
@@ -49,4 +49,15 @@ namespace ALSAEnv
    * unsigned, or 10000 if not set, or unparsable. The unit is μs.
    */
   unsigned GetALSALatency();
+
+  /**
+   * Get the maximum ALSA latency in μs for the adaptive mode.  If this
+   * is larger than GetALSALatency(), playback starts with the smaller
+   * buffer and the buffer is enlarged each time an underrun occurs.
+   *
+   * @return Value of the environment variable "ALSA_MAX_LATENCY",
+   * parsed as unsigned, or 0 (adaptive mode disabled) if not set or
+   * unparsable. The unit is μs.
+   */
+  unsigned GetALSAMaxLatency();
 }
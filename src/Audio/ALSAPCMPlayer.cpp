@@ -118,16 +118,87 @@ ALSAPCMPlayer::StopEventHandling()
   poll_events.clear();
 }
 
+void
+ALSAPCMPlayer::UpdateFill(snd_pcm_uframes_t n_available) noexcept
+{
+  const snd_pcm_uframes_t n_frames = buffer_size / channels;
+  const unsigned fill = n_available < n_frames
+    ? static_cast<unsigned>(n_frames - n_available)
+    : 0;
+
+  fill_frames.store(fill, std::memory_order_relaxed);
+  if (fill < min_fill_frames.load(std::memory_order_relaxed))
+    min_fill_frames.store(fill, std::memory_order_relaxed);
+}
+
+void
+ALSAPCMPlayer::UpdateLatency() noexcept
+{
+  snd_pcm_sframes_t delay;
+  if (snd_pcm_delay(alsa_handle.get(), &delay) == 0 && delay >= 0)
+    latency_us.store(static_cast<unsigned>(uint64_t(delay) * 1000000
+                                           / sample_rate),
+                     std::memory_order_relaxed);
+}
+
+bool
+ALSAPCMPlayer::Reconfigure()
+{
+  assert(alsa_handle);
+
+  const unsigned latency = adaptive_latency.GetLatency();
+  LogFormat("Increasing ALSA PCM latency to %u μs", latency);
+
+  snd_pcm_drop(alsa_handle.get());
+
+  channels = 1;
+  if (!SetParameters(*alsa_handle, sample_rate, big_endian_source,
+                     latency, channels))
+    return false;
+
+  snd_pcm_sframes_t n_available = snd_pcm_avail(alsa_handle.get());
+  if (n_available <= 0) {
+    LogFormat("snd_pcm_avail(0x%p) failed: %ld - %s",
+              alsa_handle.get(),
+              static_cast<long>(n_available),
+              snd_strerror(static_cast<int>(n_available)));
+    return false;
+  }
+
+  buffer_size = static_cast<snd_pcm_uframes_t>(n_available * channels);
+  buffer = std::unique_ptr<int16_t[]>(new int16_t[buffer_size]);
+  buffer_frames.store(static_cast<unsigned>(n_available),
+                      std::memory_order_relaxed);
+
+  size_t n_read = FillPCMBuffer(buffer.get(),
+                                static_cast<size_t>(n_available));
+  if (!WriteFrames(static_cast<size_t>(n_available)))
+    return false;
+
+  return (n_read == static_cast<size_t>(n_available));
+}
+
 bool
 ALSAPCMPlayer::OnEvent()
 {
   snd_pcm_sframes_t n_available = snd_pcm_avail_update(alsa_handle.get());
   if (n_available < 0) {
+    if (-EPIPE == n_available) {
+      n_underruns.fetch_add(1, std::memory_order_relaxed);
+      UpdateFill(buffer_size / channels);
+
+      /* in adaptive mode, start over with a larger buffer instead of
+         recovering with the one which was too small */
+      if (adaptive_latency.OnUnderrun())
+        return Reconfigure();
+    }
+
     if (!TryRecoverFromError(static_cast<int>(n_available)))
       return false;
 
     n_available = static_cast<snd_pcm_sframes_t>(buffer_size / channels);
-  }
+  } else
+    UpdateFill(static_cast<snd_pcm_uframes_t>(n_available));
 
   if (n_available < 0)
     return false;
@@ -139,6 +210,8 @@ ALSAPCMPlayer::OnEvent()
   if (!WriteFrames(static_cast<size_t>(n_available)))
     return false;
 
+  UpdateLatency();
+
   return (n_read == static_cast<size_t>(n_available));
 }
 
@@ -484,10 +557,18 @@ ALSAPCMPlayer::Start(PCMDataSource &_source)
     assert(new_alsa_handle);
   }
 
-  unsigned latency = ALSAEnv::GetALSALatency();
+  /* the latency reached by the adaptive mode is kept for the lifetime
+     of this object, because the conditions which caused the underruns
+     are likely to persist */
+  if (adaptive_latency.GetLatency() == 0)
+    adaptive_latency = AdaptiveLatency(ALSAEnv::GetALSALatency(),
+                                       ALSAEnv::GetALSAMaxLatency());
+
+  unsigned latency = adaptive_latency.GetLatency();
 
   channels = 1;
-  bool big_endian_source = _source.IsBigEndian();
+  sample_rate = new_sample_rate;
+  big_endian_source = _source.IsBigEndian();
   if (!SetParameters(*new_alsa_handle, new_sample_rate, big_endian_source,
                      latency, channels))
     return false;
@@ -503,6 +584,8 @@ ALSAPCMPlayer::Start(PCMDataSource &_source)
 
   buffer_size = static_cast<snd_pcm_uframes_t>(n_available * channels);
   buffer = std::unique_ptr<int16_t[]>(new int16_t[buffer_size]);
+  buffer_frames.store(static_cast<unsigned>(n_available),
+                      std::memory_order_relaxed);
 
   int poll_fds_count = snd_pcm_poll_descriptors_count(new_alsa_handle.get());
   if (poll_fds_count < 1) {
@@ -558,3 +641,19 @@ ALSAPCMPlayer::Stop()
 
   source = nullptr;
 }
+
+PCMPlayer::Statistics
+ALSAPCMPlayer::GetStatistics() const noexcept
+{
+  Statistics statistics;
+  statistics.underruns = n_underruns.load(std::memory_order_relaxed);
+  statistics.buffer_frames = buffer_frames.load(std::memory_order_relaxed);
+  statistics.fill_frames = fill_frames.load(std::memory_order_relaxed);
+
+  const unsigned min_fill = min_fill_frames.load(std::memory_order_relaxed);
+  if (min_fill != std::numeric_limits<unsigned>::max())
+    statistics.min_fill_frames = min_fill;
+
+  statistics.latency_us = latency_us.load(std::memory_order_relaxed);
+  return statistics;
+}
@@ -24,13 +24,16 @@ Copyright_License {
 #pragma once
 
 #include "PCMPlayer.hpp"
+#include "AdaptiveLatency.hpp"
 #include "event/SocketEvent.hxx"
 #include "util/Compiler.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <forward_list>
+#include <limits>
 #include <memory>
 #include <alsa/asoundlib.h>
 
@@ -58,6 +61,24 @@ class ALSAPCMPlayer : public PCMPlayer {
   snd_pcm_uframes_t buffer_size;
   std::unique_ptr<int16_t[]> buffer;
 
+  /**
+   * The parameters of the current stream, needed to reconfigure the
+   * device after an underrun.
+   */
+  unsigned sample_rate;
+  bool big_endian_source;
+
+  AdaptiveLatency adaptive_latency{0, 0};
+
+  /**
+   * Counters for GetStatistics(), written by the #EventLoop thread.
+   */
+  std::atomic<unsigned> n_underruns{0};
+  std::atomic<unsigned> buffer_frames{0};
+  std::atomic<unsigned> fill_frames{0};
+  std::atomic<unsigned> min_fill_frames{std::numeric_limits<unsigned>::max()};
+  std::atomic<unsigned> latency_us{0};
+
   std::forward_list<SocketEvent> poll_events;
 
   void StopEventHandling();
@@ -78,6 +99,26 @@ class ALSAPCMPlayer : public PCMPlayer {
 
   bool OnEvent();
 
+  /**
+   * Reconfigure the device with the current latency of
+   * #adaptive_latency and fill the new buffer.  Must be called in the
+   * #EventLoop thread.
+   *
+   * @return true if the whole buffer could be filled
+   */
+  bool Reconfigure();
+
+  /**
+   * Update the fill level counters; the parameter is the number of
+   * frames which may be written right now.
+   */
+  void UpdateFill(snd_pcm_uframes_t n_available) noexcept;
+
+  /**
+   * Measure the current output latency.
+   */
+  void UpdateLatency() noexcept;
+
   static bool SetParameters(snd_pcm_t &alsa_handle, unsigned sample_rate,
                             bool big_endian_source, unsigned latency,
                             unsigned &channels);
@@ -89,6 +130,7 @@ public:
   /* virtual methods from class PCMPlayer */
   bool Start(PCMDataSource &source) override;
   void Stop() override;
+  Statistics GetStatistics() const noexcept override;
 
 private:
   void OnSocketReady(unsigned events) noexcept;
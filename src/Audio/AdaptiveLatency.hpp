@@ -0,0 +1,77 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include <algorithm>
+
+/**
+ * Decides the latency of an audio output which starts with a small
+ * buffer and grows it each time an underrun occurs, until a
+ * configured maximum is reached.
+ *
+ * All values are in μs.  This class is not thread-safe.
+ */
+class AdaptiveLatency {
+  unsigned current;
+
+  unsigned maximum;
+
+public:
+  /**
+   * @param maximum the upper limit; if this is not larger than
+   * #initial, the latency is fixed
+   */
+  constexpr AdaptiveLatency(unsigned initial, unsigned _maximum) noexcept
+    :current(initial), maximum(std::max(initial, _maximum)) {}
+
+  [[gnu::pure]]
+  constexpr unsigned GetLatency() const noexcept {
+    return current;
+  }
+
+  /**
+   * May the latency still be increased?
+   */
+  [[gnu::pure]]
+  constexpr bool CanGrow() const noexcept {
+    return current < maximum;
+  }
+
+  /**
+   * Notify the policy about a buffer underrun.  Doubles the latency,
+   * but not beyond the maximum.
+   *
+   * @return true if the latency has been increased and the output
+   * should be reconfigured
+   */
+  constexpr bool OnUnderrun() noexcept {
+    if (!CanGrow())
+      return false;
+
+    current = current > maximum / 2
+      ? maximum
+      : std::max(current * 2, 1U);
+    return true;
+  }
+};
@@ -24,6 +24,7 @@ Copyright_License {
 #include "GlobalPCMMixer.hpp"
 #include "PCMPlayerFactory.hpp"
 #include "PCMMixer.hpp"
+#include "LogFile.hpp"
 
 #include <cassert>
 #include <memory>
@@ -45,6 +46,13 @@ DeinitialisePCMMixer()
 {
   assert(nullptr != pcm_mixer);
 
+  const auto statistics = pcm_mixer->GetStatistics();
+  if (statistics.buffer_frames > 0)
+    LogFormat("PCM output: %u underruns, buffer %u frames, "
+              "minimum fill %u frames, latency %u us",
+              statistics.underruns, statistics.buffer_frames,
+              statistics.min_fill_frames, statistics.latency_us);
+
   delete pcm_mixer;
   pcm_mixer = nullptr;
 }
@@ -59,6 +59,13 @@ public:
    */
   void Stop(PCMDataSource &source);
 
+  /**
+   * @see PCMPlayer::GetStatistics()
+   */
+  PCMPlayer::Statistics GetStatistics() const noexcept {
+    return player->GetStatistics();
+  }
+
   void SetVolume(unsigned vol_percent) {
     mixer_data_source.SetVolume(vol_percent);
   }
@@ -49,6 +49,35 @@ class PCMDataSource;
  */
 class PCMPlayer {
 public:
+  /**
+   * Counters describing the state of the output buffer.  All frame
+   * counts are per channel.  A player which does not implement these
+   * reports zeroes.
+   */
+  struct Statistics {
+    /**
+     * The number of buffer underruns since the player was created.
+     */
+    unsigned underruns = 0;
+
+    /**
+     * The size of the output buffer.
+     */
+    unsigned buffer_frames = 0;
+
+    /**
+     * The number of frames which were still queued when the player
+     * was last asked for more data, and the minimum of this value.
+     */
+    unsigned fill_frames = 0, min_fill_frames = 0;
+
+    /**
+     * The most recently measured delay [μs] between writing a frame
+     * and hearing it.
+     */
+    unsigned latency_us = 0;
+  };
+
   /**
    * Start playback.
    *
@@ -68,6 +97,14 @@ public:
    */
   virtual void Stop() = 0;
 
+  /**
+   * Obtain a snapshot of the output buffer counters.  This method is
+   * thread-safe.
+   */
+  virtual Statistics GetStatistics() const noexcept {
+    return {};
+  }
+
   virtual ~PCMPlayer() {}
 
 protected:
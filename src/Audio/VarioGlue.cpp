@@ -26,15 +26,26 @@ Copyright_License {
 #include "PCMPlayerFactory.hpp"
 #include "VarioSynthesiser.hpp"
 #include "VarioSettings.hpp"
+#include "LogFile.hpp"
 
 #ifdef ANDROID
 #include "SLES/Init.hpp"
 #endif
 
+#include <atomic>
 #include <cassert>
+#include <thread>
 
 static constexpr unsigned sample_rate = 44100;
 
+using Clock = VarioSynthesiser::Clock;
+
+/**
+ * SetValue() leaves the tone alone while PushValue() has delivered a
+ * sample from the merged device within this duration.
+ */
+static constexpr std::chrono::seconds sensor_timeout{1};
+
 #ifdef ANDROID
 static bool have_sles;
 #endif
@@ -42,6 +53,37 @@ static bool have_sles;
 static PCMPlayer *player;
 static VarioSynthesiser *synthesiser;
 
+/**
+ * The #synthesiser as seen by PushValue().  Device threads may still
+ * be running during Deinitialise(); they register in #push_users
+ * while they use the pointer, and Deinitialise() waits for them
+ * before deleting the object.  This way, PushValue() never waits for
+ * a lock.
+ */
+static std::atomic<VarioSynthesiser *> push_synthesiser;
+static std::atomic<unsigned> push_users;
+
+/**
+ * The device whose samples are accepted by PushValue() (see
+ * DeviceBlackboard::GetVarioSource()), or -1.
+ */
+static std::atomic<int> sensor_source{-1};
+
+/**
+ * The time of the last accepted PushValue() call (see
+ * Clock::time_point::time_since_epoch()); zero if there was none.
+ */
+static std::atomic<Clock::rep> last_sensor_time;
+
+[[gnu::pure]]
+static bool
+IsSensorActive(Clock::time_point now) noexcept
+{
+  const auto last = last_sensor_time.load(std::memory_order_relaxed);
+  return last != 0 &&
+    now - Clock::time_point{Clock::duration{last}} < sensor_timeout;
+}
+
 bool
 AudioVarioGlue::HaveAudioVario()
 {
@@ -66,13 +108,34 @@ AudioVarioGlue::Initialise()
 
   player = PCMPlayerFactory::CreateInstance();
   synthesiser = new VarioSynthesiser(sample_rate);
+  push_synthesiser.store(synthesiser);
 }
 
 void
 AudioVarioGlue::Deinitialise()
 {
+  if (synthesiser != nullptr) {
+    const auto latency = synthesiser->GetQueueLatency();
+    if (latency.n_samples > 0)
+      LogFormat("Audio vario queue latency: average %u ms, maximum %u ms",
+                unsigned(latency.total.count() / latency.n_samples),
+                unsigned(latency.max.count()));
+  }
+
+  if (player != nullptr) {
+    const auto statistics = player->GetStatistics();
+    if (statistics.latency_us > 0)
+      LogFormat("Audio vario output latency: %u ms",
+                statistics.latency_us / 1000);
+  }
+
   delete player;
   player = nullptr;
+
+  push_synthesiser.store(nullptr);
+  while (push_users.load() > 0)
+    std::this_thread::yield();
+
   delete synthesiser;
   synthesiser = nullptr;
 }
@@ -101,7 +164,7 @@ AudioVarioGlue::Configure(const VarioSoundSettings &settings)
 }
 
 void
-AudioVarioGlue::SetValue(double vario)
+AudioVarioGlue::SetValue(double vario, int source)
 {
 #ifdef ANDROID
   if (!have_sles)
@@ -111,9 +174,35 @@ AudioVarioGlue::SetValue(double vario)
   assert(player != nullptr);
   assert(synthesiser != nullptr);
 
+  if (source != sensor_source.exchange(source, std::memory_order_relaxed))
+    /* a different device was merged; its samples will be accepted
+       from now on, but this value is the newest one we have */
+    last_sensor_time.store(0, std::memory_order_relaxed);
+  else if (source >= 0 && IsSensorActive(Clock::now()))
+    /* PushValue() has already delivered this value, and it is
+       ramping the tone towards it */
+    return;
+
   synthesiser->SetVario(vario);
 }
 
+void
+AudioVarioGlue::PushValue(unsigned source, double vario) noexcept
+{
+  if ((int)source != sensor_source.load(std::memory_order_relaxed))
+    /* not the device which was merged by the MergeThread */
+    return;
+
+  const auto now = Clock::now();
+  last_sensor_time.store(now.time_since_epoch().count(),
+                         std::memory_order_relaxed);
+
+  ++push_users;
+  if (auto *s = push_synthesiser.load(); s != nullptr)
+    s->PushVario(vario, now);
+  --push_users;
+}
+
 void
 AudioVarioGlue::NoValue()
 {
@@ -125,5 +214,6 @@ AudioVarioGlue::NoValue()
   assert(player != nullptr);
   assert(synthesiser != nullptr);
 
+  sensor_source.store(-1, std::memory_order_relaxed);
   synthesiser->SetSilence();
 }
@@ -47,11 +47,29 @@ namespace AudioVarioGlue {
   void Configure(const VarioSoundSettings &settings);
 
   /**
-   * Update the vario value.
+   * Update the vario value.  This is the merged value chosen by the
+   * #MergeThread, and it decides which device may feed PushValue().
    *
    * @param vario the current vario value [m/s]
+   * @param source the index of the device whose total energy vario
+   * was merged, or -1 if the value has a different origin (e.g. GPS
+   * altitude, replay, simulator)
    */
-  void SetValue(double vario);
+  void SetValue(double vario, int source=-1);
+
+  /**
+   * Submit a vario sample right after it was received from a device,
+   * without waiting for the throttled #MergeThread.  Only samples from
+   * the device which was passed to the last SetValue() call are used;
+   * they carry the same value which the #MergeThread would merge a
+   * little later.  All others are ignored.
+   *
+   * This method does not block, and it may be called from any thread.
+   *
+   * @param source the index of the device
+   * @param vario the current vario value [m/s]
+   */
+  void PushValue(unsigned source, double vario) noexcept;
 
   /**
    * Declare that no vario value is known (e.g. when connection to all
@@ -70,7 +88,10 @@ namespace AudioVarioGlue {
   static inline void Initialise() {}
   static inline void Deinitialise() {}
   static inline void Configure([[maybe_unused]] const VarioSoundSettings &settings) {}
-  static inline void SetValue([[maybe_unused]] double vario) {}
+  static inline void SetValue([[maybe_unused]] double vario,
+                              [[maybe_unused]] int source=-1) {}
+  static inline void PushValue([[maybe_unused]] unsigned source,
+                               [[maybe_unused]] double vario) noexcept {}
   static inline void NoValue() {}
   static inline bool HaveAudioVario() { return false; }
 #endif
@@ -34,6 +34,30 @@ Copyright_License {
  */
 static constexpr int min_vario = -500, max_vario = 500;
 
+/**
+ * The tone moves to a new sample from PushVario() during the interval
+ * since the previous one, but not longer than this [ms].
+ */
+static constexpr uint32_t max_ramp_ms = 100;
+
+/**
+ * While moving to a new vario value, the tone is recalculated after
+ * this number of PCM samples.
+ */
+static constexpr size_t ramp_block = 64;
+
+/**
+ * Convert a time stamp to milliseconds, truncated to 32 bit (wraps
+ * around after 49 days, which is harmless for calculating short
+ * differences).
+ */
+static constexpr uint32_t
+ToMilliseconds(VarioSynthesiser::Clock::time_point t) noexcept
+{
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(t.time_since_epoch()).count();
+}
+
 unsigned
 VarioSynthesiser::VarioToFrequency(int ivario)
 {
@@ -50,6 +74,25 @@ VarioSynthesiser::SetVario(double vario)
 
   const int ivario = Clamp((int)(vario * 100), min_vario, max_vario);
 
+  ramp_remaining = 0;
+  current_vario = ivario;
+  have_current_vario = true;
+
+  UnsafeSetVario(ivario);
+}
+
+void
+VarioSynthesiser::PushVario(double vario, Clock::time_point time) noexcept
+{
+  const int32_t ivario = Clamp((int)(vario * 100), min_vario, max_vario);
+  const uint64_t sample = (uint64_t(ToMilliseconds(time)) << 32) |
+    uint32_t(ivario);
+  pending_sample.store(sample, std::memory_order_release);
+}
+
+void
+VarioSynthesiser::UnsafeSetVario(int ivario)
+{
   if (dead_band_enabled && InDeadBand(ivario)) {
     /* inside the "dead band" */
     UnsafeSetSilence();
@@ -90,6 +133,10 @@ void
 VarioSynthesiser::SetSilence()
 {
   const std::lock_guard lock{mutex};
+
+  ramp_remaining = 0;
+  have_current_vario = false;
+
   UnsafeSetSilence();
 }
 
@@ -108,12 +155,74 @@ VarioSynthesiser::UnsafeSetSilence()
   silence_remaining = 0;
 }
 
+void
+VarioSynthesiser::ConsumePendingSample() noexcept
+{
+  const uint64_t sample =
+    pending_sample.exchange(NO_SAMPLE, std::memory_order_acquire);
+  if (sample == NO_SAMPLE)
+    return;
+
+  const int target = (int32_t)(uint32_t)sample;
+  const uint32_t time = sample >> 32;
+
+  const std::chrono::milliseconds delay{
+    uint32_t(ToMilliseconds(Clock::now()) - time)
+  };
+  ++latency.n_samples;
+  latency.total += delay;
+  latency.max = std::max(latency.max, delay);
+
+  /* move to the new value during the sensor's sample interval, so
+     the tone changes continuously instead of in steps */
+  size_t ramp_samples = 0;
+  if (have_previous_sample && have_current_vario)
+    ramp_samples = std::min(uint32_t(time - previous_sample_time),
+                            max_ramp_ms) * sample_rate / 1000;
+
+  previous_sample_time = time;
+  have_previous_sample = true;
+
+  if (ramp_samples == 0) {
+    ramp_remaining = 0;
+    current_vario = target;
+    have_current_vario = true;
+    UnsafeSetVario(target);
+  } else {
+    ramp_target = target;
+    ramp_step = (target - current_vario) / ramp_samples;
+    ramp_remaining = ramp_samples;
+  }
+}
 
 void
 VarioSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
   const std::lock_guard lock{mutex};
 
+  ConsumePendingSample();
+
+  while (ramp_remaining > 0 && n > 0) {
+    const size_t o = std::min({n, ramp_remaining, ramp_block});
+
+    ramp_remaining -= o;
+    current_vario = ramp_remaining > 0
+      ? current_vario + ramp_step * o
+      : ramp_target;
+
+    UnsafeSetVario((int)current_vario);
+    UnsafeSynthesise(buffer, o);
+    buffer += o;
+    n -= o;
+  }
+
+  if (n > 0)
+    UnsafeSynthesise(buffer, n);
+}
+
+void
+VarioSynthesiser::UnsafeSynthesise(int16_t *buffer, size_t n)
+{
   assert(audible_count > 0 || silence_count > 0);
 
   if (silence_count == 0) {
@@ -26,10 +26,49 @@ Copyright_License {
 #include "ToneSynthesiser.hpp"
 #include "thread/Mutex.hxx"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
 /**
  * This class generates vario sound.
  */
 class VarioSynthesiser final : public ToneSynthesiser {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * How long samples from PushVario() wait until Synthesise() begins
+   * rendering them.  This is only the part of the latency caused by
+   * this class; the time the rendered PCM data spends in the buffer
+   * of the #PCMPlayer is not included (see
+   * PCMPlayer::Statistics::latency_us).
+   */
+  struct QueueLatency {
+    /**
+     * The number of samples consumed from PushVario().
+     */
+    unsigned n_samples = 0;
+
+    /**
+     * The sum and the maximum of the delays between PushVario() and
+     * the Synthesise() call which began rendering the sample.
+     */
+    std::chrono::milliseconds total{}, max{};
+  };
+
+private:
+  static constexpr uint64_t NO_SAMPLE = ~uint64_t(0);
+
+  /**
+   * The most recent sample submitted by PushVario() (vario [cm/s] in
+   * the lower 32 bits, time stamp [ms] in the upper 32 bits), or
+   * #NO_SAMPLE.  This is lock-free, so device threads never have to
+   * wait for the audio thread; a sample which has not been rendered
+   * yet is simply replaced.
+   */
+  std::atomic<uint64_t> pending_sample{NO_SAMPLE};
+
   /**
    * This mutex protects all atttributes below.  It is locked
    * automatically by all public methods.
@@ -87,6 +126,27 @@ class VarioSynthesiser final : public ToneSynthesiser {
    */
   int min_dead, max_dead;
 
+  /**
+   * The vario value currently being rendered [cm/s].  While
+   * #ramp_remaining is non-zero, it moves towards #ramp_target by
+   * #ramp_step per sample.
+   */
+  double current_vario = 0;
+  bool have_current_vario = false;
+
+  double ramp_step;
+  int ramp_target;
+  size_t ramp_remaining = 0;
+
+  /**
+   * The time stamp of the previous sample consumed from
+   * #pending_sample [ms].
+   */
+  uint32_t previous_sample_time;
+  bool have_previous_sample = false;
+
+  QueueLatency latency;
+
 public:
   explicit VarioSynthesiser(unsigned sample_rate)
     :ToneSynthesiser(sample_rate),
@@ -105,6 +165,22 @@ public:
    */
   void SetVario(double vario);
 
+  /**
+   * Submit a vario sample as soon as it was received from a sensor.
+   * Unlike SetVario(), this never blocks; it may be called from any
+   * thread.  The tone moves to the new value smoothly, over the
+   * interval since the previous sample.
+   *
+   * @param vario the current vario value [m/s]
+   * @param time the time the sample was received
+   */
+  void PushVario(double vario, Clock::time_point time=Clock::now()) noexcept;
+
+  QueueLatency GetQueueLatency() noexcept {
+    const std::lock_guard lock{mutex};
+    return latency;
+  }
+
   /**
    * Produce silence from now on.
    */
@@ -146,11 +222,26 @@ public:
   virtual void Synthesise(int16_t *buffer, size_t n);
 
 private:
+  /**
+   * Same as SetVario(), but doesn't lock the mutex.
+   *
+   * @param ivario the current vario value [cm/s]
+   */
+  void UnsafeSetVario(int ivario);
+
   /**
    * Same as SetSilence(), but doesn't lock the mutex.
    */
   void UnsafeSetSilence();
 
+  /**
+   * Fetch the sample submitted by PushVario() and begin moving the
+   * tone towards it.
+   */
+  void ConsumePendingSample() noexcept;
+
+  void UnsafeSynthesise(int16_t *buffer, size_t n);
+
   /**
    * Convert a vario value to a tone frequency.
    *
@@ -206,12 +206,19 @@ DeviceBlackboard::Merge() noexcept
   NMEAInfo &basic = SetBasic();
 
   real_data.Reset();
-  for (auto &basic : per_device_data) {
+  vario_source = -1;
+  for (std::size_t i = 0; i < per_device_data.size(); ++i) {
+    auto &basic = per_device_data[i];
     if (!basic.alive)
       continue;
 
     basic.UpdateClock();
     basic.Expire();
+
+    /* NMEAInfo::Complement() keeps the first valid value */
+    if (vario_source < 0 && basic.total_energy_vario_available)
+      vario_source = (int)i;
+
     real_data.Complement(basic);
   }
 
@@ -220,6 +227,7 @@ DeviceBlackboard::Merge() noexcept
   if (replay_data.alive) {
     replay_data.Expire();
     basic = replay_data;
+    vario_source = -1;
 
     /* WrapClock operates on the replay_data copy to avoid feeding
        back BrokenDate modifications to the NMEA parser, as this would
@@ -229,6 +237,7 @@ DeviceBlackboard::Merge() noexcept
     simulator_data.UpdateClock();
     simulator_data.Expire();
     basic = simulator_data;
+    vario_source = -1;
   } else {
     basic = real_data;
   }
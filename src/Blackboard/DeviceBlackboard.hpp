@@ -75,6 +75,13 @@ class DeviceBlackboard
    */
   WrapClock real_clock, replay_clock;
 
+  /**
+   * The index of the device whose total energy vario was picked by
+   * the last Merge() call, or -1 if there is none (or if replay or
+   * simulator data is being used).
+   */
+  int vario_source = -1;
+
 public:
   Mutex mutex;
 
@@ -186,4 +193,12 @@ public:
    * Caller must lock the blackboard.
    */
   void Merge() noexcept;
+
+  /**
+   * Returns the index of the device whose total energy vario was
+   * merged by Merge(), or -1.  Caller must lock the blackboard.
+   */
+  int GetVarioSource() const noexcept {
+    return vario_source;
+  }
 };
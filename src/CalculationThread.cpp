@@ -38,13 +38,18 @@ CalculationThread::CalculationThread(GlideComputer &_glide_computer)
                 /* throttle more on the Kobo, because the EPaper
                    screen cannot be updated that often */
                 std::chrono::milliseconds{900},
-#else
-                std::chrono::milliseconds{450},
-#endif
                 std::chrono::milliseconds{100},
                 std::chrono::milliseconds{50}),
+#else
+                /* the slow calculations are done by the
+                   IdleCalculationThread, therefore this thread can
+                   keep up with 20 Hz sensors */
+                std::chrono::milliseconds{50},
+                std::chrono::milliseconds{10}),
+#endif
    force(false),
-   glide_computer(_glide_computer) {
+   glide_computer(_glide_computer),
+   idle_thread(_glide_computer, *this) {
 }
 
 void
@@ -104,6 +109,9 @@ CalculationThread::Tick() noexcept
     // perform idle call if time advanced and slow calculations need to be updated
     do_idle |= glide_computer.ProcessGPS(force);
 
+  // merge the latest results of the slow calculations
+  const bool idle_updated = idle_thread.CollectResults();
+
   // values changed, so copy them back now: ONLY CALCULATED INFO
   // should be changed in DoCalculations, so we only need to write
   // that one back (otherwise we may write over new data)
@@ -113,14 +121,15 @@ CalculationThread::Tick() noexcept
   }
 
   // if (new GPS data)
-  if (gps_updated || force)
+  if (gps_updated || force || idle_updated)
     // inform map new data is ready
     TriggerCalculatedUpdate();
 
-  if (do_idle) {
-    // do slow calculations last, to minimise latency
-    glide_computer.ProcessIdle();
-  }
+  if (do_idle)
+    /* hand a snapshot to the IdleCalculationThread; it will trigger
+       us again when the results are ready */
+    idle_thread.Submit(glide_computer.Basic(), glide_computer.Calculated(),
+                       glide_computer.GetComputerSettings());
 }
 
 void
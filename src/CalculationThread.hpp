@@ -23,6 +23,7 @@ Copyright_License {
 
 #pragma once
 
+#include "IdleCalculationThread.hpp"
 #include "thread/WorkerThread.hpp"
 #include "thread/Mutex.hxx"
 #include "Computer/Settings.hpp"
@@ -30,9 +31,14 @@ Copyright_License {
 class GlideComputer;
 
 /**
- * The CalculationThread handles all expensive calculations
- * that should not be done directly in the device thread.
- * Data transfer is handled by a blackboard system.
+ * The CalculationThread handles all calculations that should not be
+ * done directly in the device thread.  Data transfer is handled by a
+ * blackboard system.
+ *
+ * This thread runs the fast calculations (vario, netto, wind, task
+ * and final glide) at sensor rate; the slow ones are delegated to
+ * the #IdleCalculationThread, which is owned by this object and
+ * started, stopped and suspended together with it.
  */
 class CalculationThread final : public WorkerThread {
   /**
@@ -55,6 +61,8 @@ class CalculationThread final : public WorkerThread {
   /** Pointer to the GlideComputer that should be used */
   GlideComputer &glide_computer;
 
+  IdleCalculationThread idle_thread;
+
 public:
   CalculationThread(GlideComputer &_glide_computer);
 
@@ -67,6 +75,28 @@ public:
   void Start(bool suspended=false) {
     WorkerThread::Start(suspended);
     SetLowPriority();
+
+    idle_thread.Start(suspended);
+  }
+
+  void BeginStop() noexcept {
+    idle_thread.BeginStop();
+    WorkerThread::BeginStop();
+  }
+
+  void Join() noexcept {
+    WorkerThread::Join();
+    idle_thread.Join();
+  }
+
+  void Suspend() noexcept {
+    WorkerThread::Suspend();
+    idle_thread.Suspend();
+  }
+
+  void Resume() noexcept {
+    idle_thread.Resume();
+    WorkerThread::Resume();
   }
 
   void ForceTrigger();
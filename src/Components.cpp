@@ -30,6 +30,7 @@ Copyright_License {
 #include "thread/Handle.hpp"
 
 FileCache *file_cache;
+TaskScheduler *task_scheduler;
 TopographyStore *topography;
 RasterTerrain *terrain;
 AsyncTerrainOverviewLoader *terrain_loader;
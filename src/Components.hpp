@@ -24,6 +24,7 @@ Copyright_License {
 #pragma once
 
 class FileCache;
+class TaskScheduler;
 class TopographyStore;
 class RasterTerrain;
 class AsyncTerrainOverviewLoader;
@@ -46,6 +47,14 @@ namespace TIM { class Glue; }
 
 // other global objects
 extern FileCache *file_cache;
+
+/**
+ * A pool of worker threads which may be used by all subsystems to
+ * parallelise their work.  May be nullptr during early startup and
+ * late shutdown.
+ */
+extern TaskScheduler *task_scheduler;
+
 extern Airspaces airspace_database;
 extern Waypoints way_points;
 extern ProtectedTaskManager *protected_task_manager;
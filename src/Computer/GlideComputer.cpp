@@ -129,8 +129,6 @@ GlideComputer::ProcessGPS(bool force)
                                     SetCalculated(),
                                     settings);
 
-  stats_computer.ProcessClimbEvents(calculated);
-
   cu_computer.Compute(basic, calculated, settings);
 
   // Calculate the team code
@@ -159,29 +157,43 @@ GlideComputer::ProcessGPS(bool force)
 }
 
 void
-GlideComputer::ProcessIdle(bool exhaustive)
+GlideComputer::ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
+                           const ComputerSettings &settings,
+                           bool exhaustive)
 {
-  const MoreData &basic = Basic();
-  DerivedInfo &calculated = SetCalculated();
+  task_computer.ProcessRoute(basic, calculated, settings);
+
+  stats_computer.ProcessClimbEvents(calculated);
 
   // Log GPS fixes for internal usage
   // (snail trail, stats, contest, ...)
   stats_computer.DoLogging(basic, calculated);
-  log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  log_computer.Run(basic, calculated, settings.logger);
 
-  task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
-                            exhaustive);
+  task_computer.ProcessIdle(basic, calculated, settings, exhaustive);
 
-  warning_computer.Update(GetComputerSettings(), basic,
+  warning_computer.Update(settings, basic,
                           calculated, calculated.airspace_warnings);
 
-  idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
+  idle_condition_monitors.Update(basic, calculated, settings);
 
   // Calculate summary of flight
   if (basic.location_available)
     retrospective.UpdateSample(basic.location);
 }
 
+void
+GlideComputer::CopyIdleResults(DerivedInfo &dest,
+                               const DerivedInfo &src) noexcept
+{
+  dest.terrain_base_valid = src.terrain_base_valid;
+  dest.terrain_base = src.terrain_base;
+  dest.terrain_warning_location = src.terrain_warning_location;
+  dest.planned_route = src.planned_route;
+  dest.contest_stats = src.contest_stats;
+  dest.airspace_warnings = src.airspace_warnings;
+}
+
 bool
 GlideComputer::DetermineTeamCodeRefLocation()
 {
@@ -348,14 +360,23 @@ GlideComputer::CalculateWorkingBand()
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
   const ComputerSettings &settings = GetComputerSettings();
+  const FlightStatistics &flightstats = stats_computer.GetFlightStats();
+
+  /* the FlightStatistics are updated by the IdleCalculationThread */
+  double min_working, max_working;
+  {
+    const std::lock_guard lock{flightstats.mutex};
+    min_working = flightstats.GetMinWorkingHeight();
+    max_working = flightstats.GetMaxWorkingHeight();
+  }
 
-  calculated.common_stats.height_min_working = stats_computer.GetFlightStats().GetMinWorkingHeight();
+  calculated.common_stats.height_min_working = min_working;
   if (calculated.terrain_base_valid) {
     calculated.common_stats.height_min_working = std::max(calculated.common_stats.height_min_working,
                                                           calculated.GetTerrainBaseFallback()+settings.task.safety_height_arrival);
   }
   calculated.common_stats.height_max_working = std::max(calculated.common_stats.height_min_working,
-                                                        stats_computer.GetFlightStats().GetMaxWorkingHeight());
+                                                        max_working);
 
   calculated.common_stats.height_fraction_working = 1; // fallback;
 
@@ -373,10 +394,17 @@ GlideComputer::CalculateVarioScale()
 {
   DerivedInfo &calculated = SetCalculated();
   const GlidePolar &glide_polar = GetComputerSettings().polar.glide_polar_task;
+  const FlightStatistics &flightstats = stats_computer.GetFlightStats();
+
+  double positive, negative;
+  {
+    const std::lock_guard lock{flightstats.mutex};
+    positive = flightstats.GetVarioScalePositive();
+    negative = flightstats.GetVarioScaleNegative();
+  }
+
   calculated.common_stats.vario_scale_positive =
-      std::max(stats_computer.GetFlightStats().GetVarioScalePositive(),
-               glide_polar.GetMC());
+      std::max(positive, glide_polar.GetMC());
   calculated.common_stats.vario_scale_negative =
-      std::min(stats_computer.GetFlightStats().GetVarioScaleNegative(),
-               -glide_polar.GetSBestLD());
+      std::min(negative, -glide_polar.GetSBestLD());
 }
@@ -48,9 +48,21 @@ class RasterTerrain;
 class GlideComputer : public GlideComputerBlackboard
 {
   GlideComputerAirData air_data_computer;
+
+  /**
+   * Only used by ProcessIdle(), i.e. by the IdleCalculationThread.
+   */
   WarningComputer warning_computer;
+
   TaskComputer task_computer;
+
+  /**
+   * Only used by ProcessIdle(); the FlightStatistics it contains
+   * may be accessed by other threads while holding
+   * FlightStatistics::mutex.
+   */
   StatsComputer stats_computer;
+
   LogComputer log_computer;
   CuComputer cu_computer;
 
@@ -59,6 +71,9 @@ class GlideComputer : public GlideComputerBlackboard
 
   const Waypoints &waypoints;
 
+  /**
+   * Only used by ProcessIdle().
+   */
   Retrospective retrospective;
   int team_code_ref_id;
   bool team_code_ref_found;
@@ -86,7 +101,10 @@ public:
   }
 
   /**
-   * Resets the GlideComputer data
+   * Resets the GlideComputer data.  This accesses the attributes
+   * owned by the IdleCalculationThread, therefore it must not be
+   * called while the calculation threads are running.
+   *
    * @param full Reset all data?
    */
   void ResetFlight(const bool full=true);
@@ -109,9 +127,39 @@ public:
   bool ProcessGPS(bool force=false); // returns true if idle needs processing
 
   /**
-   * Process slow calculations. Called by the CalculationThread.
+   * Process slow calculations (route, reach, contest, airspace
+   * warnings, logging).  Called by the #IdleCalculationThread with
+   * its own copy of the blackboard, which may run concurrently with
+   * ProcessGPS().  Only the attributes copied by CopyIdleResults()
+   * are modified.
    */
-  void ProcessIdle(bool exhaustive=false);
+  void ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
+                   const ComputerSettings &settings,
+                   bool exhaustive=false);
+
+  /**
+   * Process slow calculations on this object's blackboard.  This is
+   * only allowed if ProcessGPS() does not run concurrently.
+   */
+  void ProcessIdle(bool exhaustive=false) {
+    ProcessIdle(Basic(), SetCalculated(), GetComputerSettings(),
+                exhaustive);
+  }
+
+  /**
+   * Copy the attributes calculated by ProcessIdle() from one
+   * #DerivedInfo object to another.
+   */
+  static void CopyIdleResults(DerivedInfo &dest,
+                              const DerivedInfo &src) noexcept;
+
+  /**
+   * Merge the results of ProcessIdle() on another #DerivedInfo
+   * object into this object's blackboard.
+   */
+  void ReadIdleResults(const DerivedInfo &src) noexcept {
+    CopyIdleResults(SetCalculated(), src);
+  }
 
   void ProcessExhaustive() {
     ProcessIdle(true);
@@ -29,13 +29,25 @@ Copyright_License {
 #include "Logger/Logger.hpp"
 
 LogComputer::LogComputer()
-  :logger(NULL) {}
+  :fast_log_num(0), logger(NULL) {}
 
 void
 LogComputer::Reset()
 {
   last_location = GeoPoint::Invalid();
-  fast_log_num = 0;
+  fast_log_num.store(0, std::memory_order_relaxed);
+}
+
+inline bool
+LogComputer::ConsumeFastLogging() noexcept
+{
+  unsigned n = fast_log_num.load(std::memory_order_relaxed);
+  while (n > 0 &&
+         !fast_log_num.compare_exchange_weak(n, n - 1,
+                                             std::memory_order_relaxed))
+    ;
+
+  return n > 0;
 }
 
 void
@@ -62,10 +74,9 @@ LogComputer::Run(const MoreData &basic, const DerivedInfo &calculated,
 
   // log points more often in circling mode
   std::chrono::steady_clock::duration period;
-  if (fast_log_num) {
+  if (ConsumeFastLogging())
     period = std::chrono::seconds(1);
-    fast_log_num--;
-  } else
+  else
     period = calculated.circling
       ? std::chrono::seconds(settings_logger.time_step_circling)
       : std::chrono::seconds(settings_logger.time_step_cruise);
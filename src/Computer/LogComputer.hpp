@@ -26,6 +26,7 @@ Copyright_License {
 #include "Geo/GeoPoint.hpp"
 #include "time/GPSClock.hpp"
 
+#include <atomic>
 #include <cassert>
 
 struct NMEAInfo;
@@ -39,8 +40,12 @@ class LogComputer {
 
   GPSClock log_clock;
 
-  /** number of points to log at high rate */
-  unsigned fast_log_num;
+  /**
+   * Number of points to log at high rate.  This is set by the
+   * #CalculationThread (SetFastLogging()) and consumed by the
+   * #IdleCalculationThread (Run()).
+   */
+  std::atomic<unsigned> fast_log_num;
 
   Logger *logger;
 
@@ -60,6 +65,14 @@ public:
            const LoggerSettings &settings_logger);
 
   void SetFastLogging() {
-    fast_log_num = 5;
+    fast_log_num.store(5, std::memory_order_relaxed);
   }
+
+private:
+  /**
+   * Consume one fast logging point.
+   *
+   * @return true if fast logging was requested
+   */
+  bool ConsumeFastLogging() noexcept;
 };
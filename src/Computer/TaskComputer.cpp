@@ -44,9 +44,9 @@ TaskComputer::TaskComputer(ProtectedTaskManager &_task,
                            const ProtectedAirspaceWarningManager *warnings)
   :task(_task),
    route(airspace_database, warnings),
-   contest(trace.GetFull(), trace.GetContest(), trace.GetSprint())
+   contest(trace.GetContestFull(), trace.GetContest(), trace.GetSprint())
 {
-  task.SetRoutePlanner(&route.GetRoutePlanner());
+  task.SetRoutePlanner(&route.GetProtectedRoutePlanner());
 }
 
 void
@@ -69,7 +69,7 @@ TaskComputer::ProcessBasicTask(const MoreData &basic,
                                const ComputerSettings &settings_computer,
                                bool force)
 {
-  trace.Update(settings_computer, basic, calculated);
+  trace.Update(basic, calculated);
 
   ProtectedTaskManager::ExclusiveLease _task(task);
 
@@ -103,18 +103,10 @@ TaskComputer::ProcessBasicTask(const MoreData &basic,
 }
 
 void
-TaskComputer::ProcessMoreTask(const MoreData &basic,
+TaskComputer::ProcessMoreTask([[maybe_unused]] const MoreData &basic,
                               DerivedInfo &calculated,
                               const ComputerSettings &settings_computer)
 {
-  const GlidePolar &glide_polar = settings_computer.polar.glide_polar_task;
-  const GlidePolar &safety_polar = calculated.glide_polar_safety;
-
-  route.ProcessRoute(basic, calculated,
-                     settings_computer.task.glide,
-                     settings_computer.task.route_planner,
-                     glide_polar, safety_polar);
-
   if (settings_computer.features.block_stf_enabled)
     calculated.V_stf = calculated.common_stats.V_block;
   else
@@ -126,6 +118,19 @@ TaskComputer::ProcessMoreTask(const MoreData &basic,
   }
 }
 
+void
+TaskComputer::ProcessRoute(const MoreData &basic, DerivedInfo &calculated,
+                           const ComputerSettings &settings_computer)
+{
+  const GlidePolar &glide_polar = settings_computer.polar.glide_polar_task;
+  const GlidePolar &safety_polar = calculated.glide_polar_safety;
+
+  route.ProcessRoute(basic, calculated,
+                     settings_computer.task.glide,
+                     settings_computer.task.route_planner,
+                     glide_polar, safety_polar);
+}
+
 [[gnu::pure]]
 static TracePoint
 Predicted(const ContestSettings &settings,
@@ -151,6 +156,8 @@ TaskComputer::ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
                           const ComputerSettings &settings_computer,
                           bool exhaustive)
 {
+  trace.UpdateContest(settings_computer);
+
   contest.SetPredicted(Predicted(settings_computer.contest, basic,
                                  calculated.task_stats.current_leg));
 
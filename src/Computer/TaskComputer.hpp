@@ -88,6 +88,13 @@ public:
   void ProcessMoreTask(const MoreData &basic, DerivedInfo &calculated,
                        const ComputerSettings &settings_computer);
 
+  /**
+   * Calculate the terrain reach and the planned route.  This is
+   * expensive and is therefore done by the #IdleCalculationThread.
+   */
+  void ProcessRoute(const MoreData &basic, DerivedInfo &calculated,
+                    const ComputerSettings &settings_computer);
+
   void ResetFlight(const bool full=true);
 
   void SetTerrain(const RasterTerrain* _terrain);
@@ -101,6 +108,10 @@ public:
    */
   void ProcessAutoTask(const NMEAInfo &basic, const DerivedInfo &calculated);
 
+  /**
+   * Update the contest traces and solve the contests.  Called by the
+   * #IdleCalculationThread.
+   */
   void ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
                    const ComputerSettings &settings_computer,
                    bool exhaustive=false);
@@ -39,8 +39,16 @@ static constexpr unsigned sprint_trace_size =
 static constexpr auto full_trace_no_thin_time =
   HasLittleMemory() ? std::chrono::minutes{1} : std::chrono::minutes{2};
 
+/**
+ * The maximum number of points queued for the
+ * #IdleCalculationThread.  More points are dropped if that thread
+ * falls behind.
+ */
+static constexpr std::size_t max_pending = 256;
+
 TraceComputer::TraceComputer()
  :full(full_trace_no_thin_time, Trace::null_time, full_trace_size),
+  contest_full(full_trace_no_thin_time, Trace::null_time, full_trace_size),
   contest({}, Trace::null_time, contest_trace_size),
   sprint({}, std::chrono::minutes{150}, sprint_trace_size)
 {
@@ -52,8 +60,10 @@ TraceComputer::Reset()
   {
     const std::lock_guard lock{mutex};
     full.clear();
+    pending.clear();
   }
 
+  contest_full.clear();
   contest.clear();
   sprint.clear();
 }
@@ -75,27 +85,48 @@ TraceComputer::LockedCopyTo(TracePointVector &v,
   full.GetPoints(v, min_time, location, resolution);
 }
 
+bool
+TraceComputer::IsLoggable(const MoreData &basic,
+                          const DerivedInfo &calculated) noexcept
+{
+  return basic.time_available && basic.location_available &&
+    basic.NavAltitudeAvailable() && calculated.flight.flying;
+}
+
 void
-TraceComputer::Update(const ComputerSettings &settings_computer,
-                      const MoreData &basic, const DerivedInfo &calculated)
+TraceComputer::Update(const MoreData &basic, const DerivedInfo &calculated)
 {
   /* time warps are handled by the Trace class */
 
-  if (!basic.time_available || !basic.location_available ||
-      !basic.NavAltitudeAvailable() ||
-      !calculated.flight.flying)
+  if (!IsLoggable(basic, calculated))
     return;
 
   const TracePoint point(basic);
 
+  const std::lock_guard lock{mutex};
+  full.push_back(point);
+
+  if (pending.size() < max_pending)
+    pending.push_back(point);
+}
+
+void
+TraceComputer::UpdateContest(const ComputerSettings &settings_computer)
+{
   {
     const std::lock_guard lock{mutex};
-    full.push_back(point);
+    incoming.swap(pending);
   }
 
-  // only contest requires trace_sprint
-  if (settings_computer.contest.enable) {
-    sprint.push_back(point);
-    contest.push_back(point);
+  for (const auto &point : incoming) {
+    contest_full.push_back(point);
+
+    // only contest requires trace_sprint
+    if (settings_computer.contest.enable) {
+      sprint.push_back(point);
+      contest.push_back(point);
+    }
   }
+
+  incoming.clear();
 }
@@ -26,6 +26,8 @@ Copyright_License {
 #include "thread/Mutex.hxx"
 #include "Engine/Trace/Trace.hpp"
 
+#include <vector>
+
 struct ComputerSettings;
 struct MoreData;
 struct DerivedInfo;
@@ -35,13 +37,37 @@ struct DerivedInfo;
  */
 class TraceComputer {
   /**
-   * This mutex protects trace_full: it must be locked while editing
-   * the trace, and while reading it from a thread other than the
-   * #CalculationThread.
+   * This mutex protects #full and #pending: it must be locked while
+   * editing them, and while reading #full from a thread other than
+   * the #CalculationThread.
    */
   mutable Mutex mutex;
 
-  Trace full, contest, sprint;
+  /**
+   * The full trace, fed by the #CalculationThread.  It is used for
+   * display.
+   */
+  Trace full;
+
+  /**
+   * Points appended to #full which have not yet been passed to the
+   * #IdleCalculationThread.  Protected by #mutex.
+   */
+  std::vector<TracePoint> pending;
+
+  /**
+   * The #IdleCalculationThread's copy of #pending; it is kept here
+   * only to reuse its allocation.
+   */
+  std::vector<TracePoint> incoming;
+
+  /**
+   * The traces used by the contest solver.  They are fed with the
+   * #pending points and are accessed only by the
+   * #IdleCalculationThread, so the solver never reads a trace which
+   * is being modified by another thread.
+   */
+  Trace contest_full, contest, sprint;
 
 public:
   TraceComputer();
@@ -58,9 +84,18 @@ public:
     return full;
   }
 
+  /**
+   * Returns an unprotected reference to the contest solver's copy of
+   * the full trace.  This object may be used only inside the
+   * #IdleCalculationThread.
+   */
+  const Trace &GetContestFull() const {
+    return contest_full;
+  }
+
   /**
    * Returns an unprotected reference to the contest trace.  This
-   * object may be used only inside the #CalculationThread.
+   * object may be used only inside the #IdleCalculationThread.
    */
   const Trace &GetContest() const {
     return contest;
@@ -68,7 +103,7 @@ public:
 
   /**
    * Returns an unprotected reference to the sprint trace.  This
-   * object may be used only inside the #CalculationThread.
+   * object may be used only inside the #IdleCalculationThread.
    */
   const Trace &GetSprint() const {
     return sprint;
@@ -90,6 +125,20 @@ public:
                     std::chrono::duration<unsigned> min_time,
                     const GeoPoint &location, double resolution) const;
 
-  void Update(const ComputerSettings &settings_computer,
-              const MoreData &basic, const DerivedInfo &calculated);
+  /**
+   * Append the current location to the full trace.
+   */
+  void Update(const MoreData &basic, const DerivedInfo &calculated);
+
+  /**
+   * Append the points recorded by Update() since the last call to
+   * the contest solver's traces.  Must be called in the thread which
+   * solves the contests.
+   */
+  void UpdateContest(const ComputerSettings &settings_computer);
+
+private:
+  [[gnu::pure]]
+  static bool IsLoggable(const MoreData &basic,
+                         const DerivedInfo &calculated) noexcept;
 };
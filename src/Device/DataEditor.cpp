@@ -23,14 +23,20 @@ Copyright_License {
 
 #include "DataEditor.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
+#include "Audio/VarioGlue.hpp"
 
 DeviceDataEditor::DeviceDataEditor(DeviceBlackboard &_blackboard,
-                                   std::size_t idx) noexcept
+                                   std::size_t _idx) noexcept
   :blackboard(_blackboard), lock(blackboard.mutex),
-   basic(blackboard.SetRealState(idx)) {}
+   basic(blackboard.SetRealState(_idx)), idx(_idx),
+   old_total_energy_vario(basic.total_energy_vario_available) {}
 
 void
 DeviceDataEditor::Commit() const noexcept
 {
+  /* don't make the audio vario wait for the MergeThread */
+  if (basic.total_energy_vario_available.Modified(old_total_energy_vario))
+    AudioVarioGlue::PushValue(idx, basic.total_energy_vario);
+
   blackboard.ScheduleMerge();
 }
@@ -23,8 +23,11 @@ Copyright_License {
 
 #pragma once
 
+#include "NMEA/Validity.hpp"
 #include "thread/Mutex.hxx"
 
+#include <cstddef>
+
 class DeviceBlackboard;
 struct NMEAInfo;
 
@@ -35,6 +38,14 @@ class DeviceDataEditor {
 
   NMEAInfo &basic;
 
+  const std::size_t idx;
+
+  /**
+   * The total energy vario validity before editing; used to detect
+   * new samples for the audio vario.
+   */
+  const Validity old_total_energy_vario;
+
 public:
   DeviceDataEditor(DeviceBlackboard &blackboard,
                    std::size_t idx) noexcept;
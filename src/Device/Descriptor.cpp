@@ -45,6 +45,7 @@ Copyright_License {
 #include "system/Path.hpp"
 #include "../Simulator.hpp"
 #include "Input/InputQueue.hpp"
+#include "Audio/VarioGlue.hpp"
 #include "LogFile.hpp"
 #include "Job/Job.hpp"
 
@@ -1351,6 +1352,8 @@ DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
     auto basic = device_blackboard->LockGetDeviceDataUpdateClock(index);
 
     const ExternalSettings old_settings = basic.settings;
+    const Validity old_total_energy_vario =
+      basic.total_energy_vario_available;
 
     /* call Device::DataReceived() without holding
        DeviceBlackboard::mutex to avoid blocking all other threads */
@@ -1358,6 +1361,10 @@ DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
       if (!config.sync_from_device)
         basic.settings = old_settings;
 
+      /* don't make the audio vario wait for the MergeThread */
+      if (basic.total_energy_vario_available.Modified(old_total_energy_vario))
+        AudioVarioGlue::PushValue(index, basic.total_energy_vario);
+
       device_blackboard->LockSetDeviceDataScheuduleMerge(index, basic);
     }
 
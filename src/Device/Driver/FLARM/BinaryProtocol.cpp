@@ -196,14 +196,14 @@ FlarmDevice::ReceiveFrameHeader(FLARM::FrameHeader &header,
 }
 
 FLARM::MessageType
-FlarmDevice::WaitForACKOrNACK(uint16_t sequence_number,
+FlarmDevice::ReceiveACKOrNACK(uint16_t &sequence_number,
                               AllocatedArray<uint8_t> &data, uint16_t &length,
                               OperationEnvironment &env,
                               std::chrono::steady_clock::duration _timeout)
 {
   const TimeoutClock timeout(_timeout);
 
-  // Receive frames until timeout or expected frame found
+  // Receive frames until timeout or a valid (N)ACK frame found
   while (!timeout.HasExpired()) {
     // Wait until the next start byte comes around
     WaitForStartByte(env, timeout.GetRemainingOrZero());
@@ -239,10 +239,34 @@ FlarmDevice::WaitForACKOrNACK(uint16_t sequence_number,
     if (length < 2)
       continue;
 
+    // The payload starts with the acknowledged sequence number
+    sequence_number =
+      FromLE16(*((const uint16_t *)(const void *)data.data()));
+    return (FLARM::MessageType)header.type;
+  }
+
+  return FLARM::MT_ERROR;
+}
+
+FLARM::MessageType
+FlarmDevice::WaitForACKOrNACK(uint16_t sequence_number,
+                              AllocatedArray<uint8_t> &data, uint16_t &length,
+                              OperationEnvironment &env,
+                              std::chrono::steady_clock::duration _timeout)
+{
+  const TimeoutClock timeout(_timeout);
+
+  // Receive frames until timeout or expected frame found
+  while (!timeout.HasExpired()) {
+    uint16_t received_sequence_number;
+    const auto type = ReceiveACKOrNACK(received_sequence_number, data, length,
+                                       env, timeout.GetRemainingOrZero());
+    if (type == FLARM::MT_ERROR)
+      break;
+
     // Check whether the received ACK is for the right sequence number
-    if (FromLE16(*((const uint16_t *)(const void *)data.data())) ==
-        sequence_number)
-      return (FLARM::MessageType)header.type;
+    if (received_sequence_number == sequence_number)
+      return type;
   }
 
   return FLARM::MT_ERROR;
@@ -55,6 +55,18 @@ class FlarmDevice: public AbstractDevice
 
   uint16_t sequence_number = 0;
 
+  /**
+   * Shall DownloadFlight() keep several requests in flight?  Cleared
+   * when the FLARM turns out not to support that (old firmware).
+   */
+  bool pipelined_download = true;
+
+  /**
+   * The number of consecutive pipelined downloads which had to be
+   * repeated with the stop-and-wait method.
+   */
+  uint8_t pipelined_failures = 0;
+
   /**
    * Settings that were received in PDVSC sentences.
    */
@@ -214,6 +226,21 @@ private:
                           OperationEnvironment &env,
                           std::chrono::steady_clock::duration timeout);
 
+  /**
+   * Waits for the next ACK or NACK message from the FLARM, regardless
+   * of its sequence number
+   * @param sequence_number Receives the sequence number of the
+   * acknowledged request
+   * @param data An AllocatedArray where the received payload will be stored in
+   * @param length The length of the received payload
+   * @return Message type if N(ACK) was received properly, otherwise 0x00
+   */
+  FLARM::MessageType
+  ReceiveACKOrNACK(uint16_t &sequence_number, AllocatedArray<uint8_t> &data,
+                   uint16_t &length,
+                   OperationEnvironment &env,
+                   std::chrono::steady_clock::duration timeout);
+
   /**
    * Waits for an ACK or NACK message from the FLARM with the right
    * sequence number
@@ -285,6 +312,38 @@ private:
    */
   bool DownloadFlight(Path path, OperationEnvironment &env);
 
+  enum class DownloadResult : uint8_t {
+    SUCCESS,
+    FAILED,
+
+    /**
+     * An answer was missing or corrupt (e.g. a transmission error);
+     * the flight has to be downloaded again.
+     */
+    RETRY,
+
+    /**
+     * The FLARM has rejected the pipelined requests; it has to be
+     * downloaded again with DownloadFlight().
+     */
+    UNSUPPORTED,
+  };
+
+  /**
+   * Like DownloadFlight(), but keeps several GetIGCData requests in
+   * flight to hide the round-trip latency.
+   */
+  DownloadResult DownloadFlightPipelined(Path path,
+                                         OperationEnvironment &env);
+
+  /**
+   * Receive and discard the answers to requests which are still in
+   * flight, up to the one with the specified sequence number, so they
+   * don't get mixed up with the answer to the next command.
+   */
+  void DrainAnswers(uint16_t last_sequence_number,
+                    OperationEnvironment &env);
+
 public:
   /**
    * Reads a RecordedFlightList from the Flarm
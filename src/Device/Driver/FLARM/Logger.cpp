@@ -28,10 +28,29 @@
 #include "io/BufferedOutputStream.hxx"
 #include "system/Path.hpp"
 #include "Operation/Operation.hpp"
+#include "time/TimeoutClock.hpp"
 
 #include <cstdlib>
 #include <cstring>
 
+/**
+ * The maximum number of GetIGCData requests which are sent without
+ * waiting for an answer.
+ */
+static constexpr unsigned DOWNLOAD_WINDOW = 8;
+
+/**
+ * Give up after this number of consecutive NACKs.
+ */
+static constexpr unsigned DOWNLOAD_MAX_NACKS = 3;
+
+/**
+ * Disable pipelined downloads after this number of consecutive
+ * failures.  Old firmware which drops requests while it is busy
+ * fails every time, while a transmission error is rare.
+ */
+static constexpr unsigned DOWNLOAD_MAX_FAILURES = 2;
+
 static bool
 ParseDate(const char *str, BrokenDate &date)
 {
@@ -354,6 +373,137 @@ FlarmDevice::DownloadFlight(Path path, OperationEnvironment &env)
   return true;
 }
 
+FlarmDevice::DownloadResult
+FlarmDevice::DownloadFlightPipelined(Path path, OperationEnvironment &env)
+{
+  FileOutputStream fos(path);
+  BufferedOutputStream os(fos);
+
+  env.SetProgressRange(100);
+
+  /* the FLARM answers the requests in the order they were sent;
+     "expected" is the sequence number of the oldest unanswered
+     one */
+  uint16_t expected = sequence_number;
+  unsigned n_pending = 0, n_nacks = 0;
+  bool received_data = false;
+
+  AllocatedArray<uint8_t> data;
+
+  while (true) {
+    try {
+      // Keep the window full
+      for (; n_pending < DOWNLOAD_WINDOW; ++n_pending) {
+        FLARM::FrameHeader header = PrepareFrameHeader(FLARM::MT_GETIGCDATA);
+        SendStartByte();
+        SendFrameHeader(header, env, std::chrono::seconds(1));
+      }
+    } catch (const DeviceTimeout &) {
+      break;
+    }
+
+    uint16_t acknowledged;
+    uint16_t length;
+    FLARM::MessageType type;
+    try {
+      type = ReceiveACKOrNACK(acknowledged, data, length,
+                              env, std::chrono::seconds(10));
+    } catch (const DeviceTimeout &) {
+      type = FLARM::MT_ERROR;
+    }
+
+    if (type == FLARM::MT_ERROR)
+      break;
+
+    // Ignore answers to requests sent before this download
+    if (uint16_t(acknowledged - expected) >= n_pending)
+      continue;
+
+    /* an answer is missing: either the FLARM has dropped the request
+       (old firmware) or the answer got lost, and the block with it;
+       there is no way to tell, so start over */
+    if (acknowledged != expected)
+      break;
+
+    ++expected;
+    --n_pending;
+
+    if (type == FLARM::MT_NACK) {
+      if (!received_data) {
+        /* the FLARM has accepted SelectRecord, but rejects queued
+           GetIGCData requests */
+        DrainAnswers(sequence_number - 1, env);
+        return DownloadResult::UNSUPPORTED;
+      }
+
+      /* the FLARM has not advanced; the next request retransmits this
+         block */
+      if (++n_nacks > DOWNLOAD_MAX_NACKS) {
+        DrainAnswers(sequence_number - 1, env);
+        return DownloadResult::FAILED;
+      }
+
+      continue;
+    }
+
+    n_nacks = 0;
+
+    if (length <= 3)
+      /* a malformed block */
+      break;
+
+    received_data = true;
+    length -= 3;
+
+    // Read progress (in percent)
+    uint8_t progress = *(data.begin() + 2);
+    env.SetProgressPosition(std::min((unsigned)progress, 100u));
+
+    const char last_char = (char)data[3 + length - 1];
+    bool is_last_packet = (last_char == 0x1A);
+    if (is_last_packet)
+      length--;
+
+    // Read IGC data
+    const char *igc_data = (const char *)data.data() + 3;
+    os.Write(igc_data, length);
+
+    if (is_last_packet) {
+      /* the requests sent after the last block are still in
+         flight */
+      if (n_pending > 0)
+        DrainAnswers(sequence_number - 1, env);
+
+      os.Flush();
+      fos.Commit();
+
+      return DownloadResult::SUCCESS;
+    }
+  }
+
+  DrainAnswers(sequence_number - 1, env);
+  return DownloadResult::RETRY;
+}
+
+void
+FlarmDevice::DrainAnswers(uint16_t last_sequence_number,
+                          OperationEnvironment &env)
+{
+  const TimeoutClock timeout(std::chrono::seconds(2));
+
+  AllocatedArray<uint8_t> data;
+  uint16_t acknowledged, length;
+
+  try {
+    while (!timeout.HasExpired()) {
+      if (ReceiveACKOrNACK(acknowledged, data, length,
+                           env, timeout.GetRemainingOrZero()) == FLARM::MT_ERROR ||
+          acknowledged == last_sequence_number)
+        break;
+    }
+  } catch (const DeviceTimeout &) {
+  }
+}
 
 bool
 FlarmDevice::DownloadFlight(const RecordedFlightInfo &flight,
@@ -362,6 +512,40 @@ FlarmDevice::DownloadFlight(const RecordedFlightInfo &flight,
   if (!BinaryMode(env))
     return false;
 
+  if (pipelined_download) {
+    if (SelectFlight(flight.internal.flarm, env) != FLARM::MT_ACK)
+      return false;
+
+    try {
+      switch (DownloadFlightPipelined(path, env)) {
+      case DownloadResult::SUCCESS:
+        pipelined_failures = 0;
+        return true;
+
+      case DownloadResult::FAILED:
+        mode = Mode::UNKNOWN;
+        return false;
+
+      case DownloadResult::RETRY:
+        /* keep using pipelined downloads, unless this happens
+           every time */
+        if (++pipelined_failures >= DOWNLOAD_MAX_FAILURES)
+          pipelined_download = false;
+        break;
+
+      case DownloadResult::UNSUPPORTED:
+        pipelined_download = false;
+        break;
+      }
+    } catch (...) {
+      mode = Mode::UNKNOWN;
+      throw;
+    }
+
+    /* fall back to stop-and-wait; selecting the flight again restarts
+       the download from the beginning */
+  }
+
   FLARM::MessageType ack_result = SelectFlight(flight.internal.flarm, env);
 
   // If no ACK was received -> cancel
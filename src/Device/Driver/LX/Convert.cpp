@@ -28,11 +28,12 @@ Copyright_License {
 
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 
 #include <stdlib.h>
 #include <string.h>
 
-struct Context {
+struct LX::LXNToIGCConverter::Context {
   uint8_t flight_no;
   char date[7];
   LXN::FlightInfo flight_info;
@@ -44,11 +45,16 @@ struct Context {
   char vendor[3];
   LXN::ExtensionConfig k_ext, b_ext;
 
+  /**
+   * The number of #LXN::EMPTY bytes which have not been written yet.
+   */
+  unsigned empty_run;
+
   Context()
     :flight_no(0),
      time(0), origin_time(0),
      origin_latitude(0), origin_longitude(0),
-     is_event(false) {
+     is_event(false), empty_run(0) {
     memset(date, 0, sizeof(date));
     flight_info.competition_class_id = 0xff;
     memset(vendor, 0, sizeof(vendor));
@@ -57,6 +63,8 @@ struct Context {
   }
 };
 
+using Context = LX::LXNToIGCConverter::Context;
+
 static bool
 ValidString(const char *p, size_t size)
 {
@@ -132,359 +140,480 @@ HandleExtConfig(BufferedOutputStream &os, const struct LXN::ExtConfig &packet,
   os.Write("\r\n");
 }
 
-bool
-LX::ConvertLXNToIGC(const void *_data, size_t _length,
-                    BufferedOutputStream &os)
+/**
+ * The packet is incomplete; more data is needed.
+ */
+static constexpr ptrdiff_t PACKET_INCOMPLETE = 0;
+
+/**
+ * The data is malformed.
+ */
+static constexpr ptrdiff_t PACKET_ERROR = -1;
+
+/**
+ * The end of the flight was found.
+ */
+static constexpr ptrdiff_t PACKET_END = -2;
+
+/**
+ * Convert one LXN packet.
+ *
+ * @return the length of the packet, or one of #PACKET_INCOMPLETE,
+ * #PACKET_ERROR, #PACKET_END
+ */
+static ptrdiff_t
+ConvertPacket(const uint8_t *const begin, const uint8_t *const end,
+              Context &context, BufferedOutputStream &os)
 {
-  const uint8_t *data = (const uint8_t *)_data, *end = data + _length;
-  Context context;
+  const uint8_t *data = begin;
+  union LXN::Packet packet = { data };
   char ch;
   unsigned l;
 
-  while (data < end) {
-    union LXN::Packet packet = { data };
-
-    unsigned packet_length;
-    switch ((LXN::Command)*packet.cmd) {
-    case LXN::EMPTY:
-      packet_length = 0;
-      while (data < end && *data == LXN::EMPTY) {
-        ++packet_length;
-        ++data;
-      }
-
-      os.Format("LFILEMPTY%u\r\n", packet_length);
-      break;
-
-    case LXN::END:
-      return true;
-
-    case LXN::VERSION:
-      data += sizeof(*packet.version);
-      if (data > end)
-        return false;
+  if (context.empty_run > 0 && *data != LXN::EMPTY) {
+    os.Format("LFILEMPTY%u\r\n", context.empty_run);
+    context.empty_run = 0;
+  }
 
-      os.Format("HFRFWFIRMWAREVERSION:%3.1f\r\n"
-                "HFRHWHARDWAREVERSION:%3.1f\r\n",
-                packet.version->software / 10.,
-                packet.version->hardware / 10.);
-      break;
+  switch ((LXN::Command)*packet.cmd) {
+  case LXN::EMPTY:
+    while (data < end && *data == LXN::EMPTY)
+      ++data;
+
+    /* the run may continue in the next chunk; it is written when the
+       next packet begins */
+    context.empty_run += data - begin;
+    break;
+
+  case LXN::END:
+    return PACKET_END;
+
+  case LXN::VERSION:
+    data += sizeof(*packet.version);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    os.Format("HFRFWFIRMWAREVERSION:%3.1f\r\n"
+              "HFRHWHARDWAREVERSION:%3.1f\r\n",
+              packet.version->software / 10.,
+              packet.version->hardware / 10.);
+    break;
+
+  case LXN::START:
+    data += sizeof(*packet.start);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (memcmp(packet.start->streraz, "STReRAZ", 8) != 0)
+      return PACKET_ERROR;
+
+    context.flight_no = packet.start->flight_no;
+    break;
+
+  case LXN::ORIGIN:
+    data += sizeof(*packet.origin);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    context.origin_time = FromBE32(packet.origin->time);
+    context.origin_latitude = (int32_t)FromBE32(packet.origin->latitude);
+    context.origin_longitude = (int32_t)FromBE32(packet.origin->longitude);
+
+    os.Format("L%.*sORIGIN%02d%02d%02d" "%02d%05d%c" "%03d%05d%c\r\n",
+              (int)sizeof(context.vendor), context.vendor,
+              context.origin_time / 3600, context.origin_time % 3600 / 60,
+              context.origin_time % 60,
+              abs(context.origin_latitude) / 60000,
+              abs(context.origin_latitude) % 60000,
+              context.origin_latitude >= 0 ? 'N' : 'S',
+              abs(context.origin_longitude) / 60000,
+              abs(context.origin_longitude) % 60000,
+              context.origin_longitude >= 0 ? 'E' : 'W');
+    break;
+
+  case LXN::SECURITY_OLD:
+    data += sizeof(*packet.security_old);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    os.Format("G%22.22s\r\n", packet.security_old->foo);
+    break;
+
+  case LXN::SERIAL:
+    data += sizeof(*packet.serial);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (!ValidString(packet.serial->serial, sizeof(packet.serial->serial)))
+      return PACKET_ERROR;
+
+    os.Format("A%sFLIGHT:%u\r\nHFDTE%s\r\n",
+              packet.serial->serial, context.flight_no, context.date);
+    break;
+
+  case LXN::POSITION_OK:
+  case LXN::POSITION_BAD:
+    data += sizeof(*packet.position);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    HandlePosition(os, context, *packet.position);
+    break;
+
+  case LXN::SECURITY:
+    data += sizeof(*packet.security);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (packet.security->length > sizeof(packet.security->foo))
+      return PACKET_ERROR;
+
+    if (packet.security->type == LXN::SECURITY_HIGH)
+      ch = '2';
+    else if (packet.security->type == LXN::SECURITY_MED)
+      ch = '1';
+    else if (packet.security->type == LXN::SECURITY_LOW)
+      ch = '0';
+    else
+      return PACKET_ERROR;
+
+    os.Format("G%c", ch);
+
+    for (unsigned i = 0; i < packet.security->length; ++i)
+      os.Format("%02X", packet.security->foo[i]);
+
+    os.Write("\r\n");
+    break;
+
+  case LXN::SECURITY_7000:
+    data += sizeof(*packet.security_7000);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (packet.security_7000->x40 == 0x12) {
+      os.Write("G3");
+      for (unsigned i = 0; i < 20; ++i)
+        os.Format("%02X", packet.security_7000->line1[i]);
 
-    case LXN::START:
-      data += sizeof(*packet.start);
-      if (data > end ||
-          memcmp(packet.start->streraz, "STReRAZ", 8) != 0)
-        return false;
+      os.Write("\r\n");
+    }
+    else if (packet.security_7000->x40 == 0x40) {
+      os.Write("G3");
+      for (auto ch : packet.security_7000->line1)
+        os.Format("%02X", ch);
 
-      context.flight_no = packet.start->flight_no;
-      break;
+      os.Write("\r\nG");
+      for (auto ch : packet.security_7000->line2)
+        os.Format("%02X", ch);
 
-    case LXN::ORIGIN:
-      data += sizeof(*packet.origin);
-      if (data > end)
-        return false;
-
-      context.origin_time = FromBE32(packet.origin->time);
-      context.origin_latitude = (int32_t)FromBE32(packet.origin->latitude);
-      context.origin_longitude = (int32_t)FromBE32(packet.origin->longitude);
-
-      os.Format("L%.*sORIGIN%02d%02d%02d" "%02d%05d%c" "%03d%05d%c\r\n",
-                (int)sizeof(context.vendor), context.vendor,
-                context.origin_time / 3600, context.origin_time % 3600 / 60,
-                context.origin_time % 60,
-                abs(context.origin_latitude) / 60000,
-                abs(context.origin_latitude) % 60000,
-                context.origin_latitude >= 0 ? 'N' : 'S',
-                abs(context.origin_longitude) / 60000,
-                abs(context.origin_longitude) % 60000,
-                context.origin_longitude >= 0 ? 'E' : 'W');
-      break;
-
-    case LXN::SECURITY_OLD:
-      data += sizeof(*packet.security_old);
-      if (data > end)
-        return false;
+      os.Write("\r\nG");
+      for (auto ch : packet.security_7000->line3)
+        os.Format("%02X", ch);
 
-      os.Format("G%22.22s\r\n", packet.security_old->foo);
-      break;
+      os.Write("\r\n");
+    }
+    else
+      os.Write("GSECURITY_NOT_CONVERTED\r\n");
+
+    break;
+
+  case LXN::COMPETITION_CLASS:
+    data += sizeof(*packet.competition_class);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (!ValidString(packet.competition_class->class_id,
+                     sizeof(packet.competition_class->class_id)))
+      return PACKET_ERROR;
+
+    if (context.flight_info.competition_class_id == 7)
+      os.Format("HFFXA%03d\r\n"
+                "HFPLTPILOT:%s\r\n"
+                "HFCM2CREW2:%s\r\n"
+                "HFGTYGLIDERTYPE:%s\r\n"
+                "HFGIDGLIDERID:%s\r\n"
+                "HFDTM%03dGPSDATUM:%s\r\n"
+                "HFCIDCOMPETITIONID:%s\r\n"
+                "HFCCLCOMPETITIONCLASS:%s\r\n"
+                "HFGPSGPS:%s\r\n",
+                context.flight_info.fix_accuracy,
+                context.flight_info.pilot,
+                context.flight_info.copilot,
+                context.flight_info.glider,
+                context.flight_info.registration,
+                context.flight_info.gps_date,
+                LXN::FormatGPSDate(context.flight_info.gps_date),
+                context.flight_info.competition_class,
+                packet.competition_class->class_id,
+                context.flight_info.gps);
+    break;
+
+  case LXN::TASK:
+    data += sizeof(*packet.task);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    context.time = FromBE32(packet.task->time);
+
+    // from a valid IGC file read with LXe:
+    // C 11 08 11 14 11 18 11 08 11 0001 -2
+
+    os.Format("C%02d%02d%02d%02d%02d%02d"
+              "%02d%02d%02d" "%04d%02d\r\n",
+              packet.task->day, packet.task->month, packet.task->year,
+              context.time / 3600, context.time % 3600 / 60, context.time % 60,
+              packet.task->day2, packet.task->month2, packet.task->year2,
+              FromBE16(packet.task->task_id), packet.task->num_tps);
+
+    for (unsigned i = 0; i < sizeof(packet.task->usage); ++i) {
+      if (packet.task->usage[i]) {
+        int latitude = (int32_t)FromBE32(packet.task->latitude[i]);
+        int longitude = (int32_t)FromBE32(packet.task->longitude[i]);
+
+        if (!ValidString(packet.task->name[i], sizeof(packet.task->name[i])))
+          return PACKET_ERROR;
+
+        os.Format("C%02d%05d%c" "%03d%05d%c" "%s\r\n",
+                  abs(latitude) / 60000, abs(latitude) % 60000,
+                  latitude >= 0 ?  'N' : 'S',
+                  abs(longitude) / 60000, abs(longitude) % 60000,
+                  longitude >= 0 ? 'E' : 'W',
+                  packet.task->name[i]);
+      }
+    }
+    break;
+
+  case LXN::EVENT:
+    data += sizeof(*packet.event);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (!ValidString(packet.event->foo, sizeof(packet.event->foo)))
+      return PACKET_ERROR;
+
+    context.event = *packet.event;
+    context.is_event = true;
+    break;
+
+  case LXN::B_EXT:
+    data += sizeof(*packet.b_ext) +
+      context.b_ext.num * sizeof(packet.b_ext->data[0]);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    for (unsigned i = 0; i < context.b_ext.num; ++i)
+      os.Format("%0*u",
+                (int)context.b_ext.extensions[i].width,
+                FromBE16(packet.b_ext->data[i]));
+
+    os.Write("\r\n");
+    break;
+
+  case LXN::K_EXT:
+    data += sizeof(*packet.k_ext) +
+      context.k_ext.num * sizeof(packet.k_ext->data[0]);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    l = context.time + packet.k_ext->foo;
+    os.Format("K%02d%02d%02d", l / 3600, l % 3600 / 60, l % 60);
+
+    for (unsigned i = 0; i < context.k_ext.num; ++i)
+      os.Format("%0*u",
+                context.k_ext.extensions[i].width,
+                FromBE16(packet.k_ext->data[i]));
+
+    os.Write("\r\n");
+    break;
+
+  case LXN::DATE:
+    data += sizeof(*packet.date);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (packet.date->day > 31 || packet.date->month > 12)
+      return PACKET_ERROR;
+
+    snprintf(context.date, sizeof(context.date),
+             "%02d%02d%02d",
+             packet.date->day % 100, packet.date->month % 100,
+             FromBE16(packet.date->year) % 100);
+    break;
+
+  case LXN::FLIGHT_INFO:
+    data += sizeof(*packet.flight_info);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    if (!ValidString(packet.flight_info->pilot,
+                     sizeof(packet.flight_info->pilot)) ||
+        !ValidString(packet.flight_info->copilot,
+                     sizeof(packet.flight_info->copilot)) ||
+        !ValidString(packet.flight_info->glider,
+                     sizeof(packet.flight_info->glider)) ||
+        !ValidString(packet.flight_info->registration,
+                     sizeof(packet.flight_info->registration)) ||
+        !ValidString(packet.flight_info->competition_class,
+                     sizeof(packet.flight_info->competition_class)) ||
+        !ValidString(packet.flight_info->gps, sizeof(packet.flight_info->gps)))
+      return PACKET_ERROR;
+
+    if (packet.flight_info->competition_class_id > 7)
+      return PACKET_ERROR;
+
+    if (packet.flight_info->competition_class_id < 7)
+      os.Format("HFFXA%03d\r\n"
+                "HFPLTPILOT:%s\r\n"
+                "HFCM2CREW2:%s\r\n"
+                "HFGTYGLIDERTYPE:%s\r\n"
+                "HFGIDGLIDERID:%s\r\n"
+                "HFDTM%03dGPSDATUM:%s\r\n"
+                "HFCIDCOMPETITIONID:%s\r\n"
+                "HFCCLCOMPETITIONCLASS:%s\r\n"
+                "HFGPSGPS:%s\r\n",
+                packet.flight_info->fix_accuracy,
+                packet.flight_info->pilot,
+                packet.flight_info->copilot,
+                packet.flight_info->glider,
+                packet.flight_info->registration,
+                packet.flight_info->gps_date,
+                LXN::FormatGPSDate(packet.flight_info->gps_date),
+                packet.flight_info->competition_class,
+                LXN::FormatCompetitionClass(packet.flight_info->competition_class_id),
+                packet.flight_info->gps);
+
+    context.flight_info = *packet.flight_info;
+    break;
+
+  case LXN::K_EXT_CONFIG:
+    data += sizeof(*packet.ext_config);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    HandleExtConfig(os, *packet.ext_config, context.k_ext, 'J', 8);
+    break;
+
+  case LXN::B_EXT_CONFIG:
+    data += sizeof(*packet.ext_config);
+    if (data > end)
+      return PACKET_INCOMPLETE;
+
+    HandleExtConfig(os, *packet.ext_config, context.b_ext, 'I', 36);
+    break;
 
-    case LXN::SERIAL:
-      data += sizeof(*packet.serial);
+#ifdef __clang__
+#pragma GCC diagnostic ignored "-Wcovered-switch-default"
+#endif
+  default:
+    if (*packet.cmd < 0x40) {
+      data += sizeof(*packet.string);
       if (data > end)
-        return false;
+        return PACKET_INCOMPLETE;
 
-      if (!ValidString(packet.serial->serial, sizeof(packet.serial->serial)))
-        return false;
-
-      os.Format("A%sFLIGHT:%u\r\nHFDTE%s\r\n",
-                packet.serial->serial, context.flight_no, context.date);
-      break;
-
-    case LXN::POSITION_OK:
-    case LXN::POSITION_BAD:
-      data += sizeof(*packet.position);
+      data += packet.string->length;
       if (data > end)
-        return false;
-
-      HandlePosition(os, context, *packet.position);
-      break;
-
-    case LXN::SECURITY:
-      data += sizeof(*packet.security);
-      if (data > end ||
-          packet.security->length > sizeof(packet.security->foo))
-        return false;
+        return PACKET_INCOMPLETE;
 
-      if (packet.security->type == LXN::SECURITY_HIGH)
-        ch = '2';
-      else if (packet.security->type == LXN::SECURITY_MED)
-        ch = '1';
-      else if (packet.security->type == LXN::SECURITY_LOW)
-        ch = '0';
-      else
-        return false;
+      os.Format("%.*s\r\n",
+                (int)packet.string->length, packet.string->value);
 
-      os.Format("G%c", ch);
-
-      for (unsigned i = 0; i < packet.security->length; ++i)
-        os.Format("%02X", packet.security->foo[i]);
-
-      os.Write("\r\n");
-      break;
-
-    case LXN::SECURITY_7000:
-      data += sizeof(*packet.security_7000);
-      if (data > end)
-        return false;
-
-      if (packet.security_7000->x40 == 0x12) {
-        os.Write("G3");
-        for (unsigned i = 0; i < 20; ++i)
-          os.Format("%02X", packet.security_7000->line1[i]);
+      if (packet.string->length >= 12 + sizeof(context.vendor) &&
+          memcmp(packet.string->value, "HFFTYFRTYPE:", 12) == 0)
+        memcpy(context.vendor, packet.string->value + 12, sizeof(context.vendor));
+    } else
+      return PACKET_ERROR;
+  }
 
-        os.Write("\r\n");
-      }
-      else if (packet.security_7000->x40 == 0x40) {
-        os.Write("G3");
-        for (auto ch : packet.security_7000->line1)
-          os.Format("%02X", ch);
+  return data - begin;
+}
 
-        os.Write("\r\nG");
-        for (auto ch : packet.security_7000->line2)
-          os.Format("%02X", ch);
+LX::LXNToIGCConverter::LXNToIGCConverter(BufferedOutputStream &_os) noexcept
+  :os(_os), context(std::make_unique<Context>()) {}
 
-        os.Write("\r\nG");
-        for (auto ch : packet.security_7000->line3)
-          os.Format("%02X", ch);
+LX::LXNToIGCConverter::~LXNToIGCConverter() noexcept = default;
 
-        os.Write("\r\n");
-      }
-      else
-        os.Write("GSECURITY_NOT_CONVERTED\r\n");
+inline bool
+LX::LXNToIGCConverter::Convert(const uint8_t *&data, const uint8_t *end,
+                               bool eof)
+{
+  while (data < end) {
+    const ptrdiff_t result = ConvertPacket(data, end, *context, os);
+    if (result == PACKET_INCOMPLETE)
+      return !eof;
 
-      break;
+    if (result == PACKET_END) {
+      finished = true;
+      return true;
+    }
 
-    case LXN::COMPETITION_CLASS:
-      data += sizeof(*packet.competition_class);
-      if (data > end)
-        return false;
-
-      if (!ValidString(packet.competition_class->class_id,
-                       sizeof(packet.competition_class->class_id)))
-        return false;
-
-      if (context.flight_info.competition_class_id == 7)
-        os.Format("HFFXA%03d\r\n"
-                  "HFPLTPILOT:%s\r\n"
-                  "HFCM2CREW2:%s\r\n"
-                  "HFGTYGLIDERTYPE:%s\r\n"
-                  "HFGIDGLIDERID:%s\r\n"
-                  "HFDTM%03dGPSDATUM:%s\r\n"
-                  "HFCIDCOMPETITIONID:%s\r\n"
-                  "HFCCLCOMPETITIONCLASS:%s\r\n"
-                  "HFGPSGPS:%s\r\n",
-                  context.flight_info.fix_accuracy,
-                  context.flight_info.pilot,
-                  context.flight_info.copilot,
-                  context.flight_info.glider,
-                  context.flight_info.registration,
-                  context.flight_info.gps_date,
-                  LXN::FormatGPSDate(context.flight_info.gps_date),
-                  context.flight_info.competition_class,
-                  packet.competition_class->class_id,
-                  context.flight_info.gps);
-      break;
-
-    case LXN::TASK:
-      data += sizeof(*packet.task);
-      if (data > end)
-        return false;
-
-      context.time = FromBE32(packet.task->time);
-
-      // from a valid IGC file read with LXe:
-      // C 11 08 11 14 11 18 11 08 11 0001 -2
-
-      os.Format("C%02d%02d%02d%02d%02d%02d"
-                "%02d%02d%02d" "%04d%02d\r\n",
-                packet.task->day, packet.task->month, packet.task->year,
-                context.time / 3600, context.time % 3600 / 60, context.time % 60,
-                packet.task->day2, packet.task->month2, packet.task->year2,
-                FromBE16(packet.task->task_id), packet.task->num_tps);
-
-      for (unsigned i = 0; i < sizeof(packet.task->usage); ++i) {
-        if (packet.task->usage[i]) {
-          int latitude = (int32_t)FromBE32(packet.task->latitude[i]);
-          int longitude = (int32_t)FromBE32(packet.task->longitude[i]);
-
-          if (!ValidString(packet.task->name[i], sizeof(packet.task->name[i])))
-            return false;
-
-          os.Format("C%02d%05d%c" "%03d%05d%c" "%s\r\n",
-                    abs(latitude) / 60000, abs(latitude) % 60000,
-                    latitude >= 0 ?  'N' : 'S',
-                    abs(longitude) / 60000, abs(longitude) % 60000,
-                    longitude >= 0 ? 'E' : 'W',
-                    packet.task->name[i]);
-        }
-      }
-      break;
+    if (result == PACKET_ERROR)
+      return false;
 
-    case LXN::EVENT:
-      data += sizeof(*packet.event);
-      if (data > end ||
-          !ValidString(packet.event->foo, sizeof(packet.event->foo)))
-        return false;
+    data += result;
+  }
 
-      context.event = *packet.event;
-      context.is_event = true;
-      break;
+  return true;
+}
 
-    case LXN::B_EXT:
-      data += sizeof(*packet.b_ext) +
-        context.b_ext.num * sizeof(packet.b_ext->data[0]);
-      if (data > end)
-        return false;
+bool
+LX::LXNToIGCConverter::Feed(std::span<const std::byte> src)
+{
+  if (finished)
+    /* ignore everything after the PACKET_END packet */
+    return true;
 
-      for (unsigned i = 0; i < context.b_ext.num; ++i)
-        os.Format("%0*u",
-                  (int)context.b_ext.extensions[i].width,
-                  FromBE16(packet.b_ext->data[i]));
+  if (failed)
+    return false;
 
-      os.Write("\r\n");
-      break;
+  const uint8_t *data = (const uint8_t *)src.data(), *end = data + src.size();
 
-    case LXN::K_EXT:
-      data += sizeof(*packet.k_ext) +
-        context.k_ext.num * sizeof(packet.k_ext->data[0]);
-      if (data > end)
-        return false;
+  if (!pending.empty()) {
+    /* complete the packet left over from the previous chunk */
+    pending.insert(pending.end(), data, end);
+    data = pending.data();
+    end = data + pending.size();
+  }
 
-      l = context.time + packet.k_ext->foo;
-      os.Format("K%02d%02d%02d", l / 3600, l % 3600 / 60, l % 60);
+  const uint8_t *p = data;
+  if (!Convert(p, end, false)) {
+    failed = true;
+    return false;
+  }
 
-      for (unsigned i = 0; i < context.k_ext.num; ++i)
-        os.Format("%0*u",
-                  context.k_ext.extensions[i].width,
-                  FromBE16(packet.k_ext->data[i]));
+  if (finished) {
+    pending.clear();
+    return true;
+  }
 
-      os.Write("\r\n");
-      break;
-
-    case LXN::DATE:
-      data += sizeof(*packet.date);
-      if (data > end ||
-          packet.date->day > 31 || packet.date->month > 12)
-        return false;
-
-      snprintf(context.date, sizeof(context.date),
-               "%02d%02d%02d",
-               packet.date->day % 100, packet.date->month % 100,
-               FromBE16(packet.date->year) % 100);
-      break;
-
-    case LXN::FLIGHT_INFO:
-      data += sizeof(*packet.flight_info);
-      if (data > end ||
-          !ValidString(packet.flight_info->pilot,
-                       sizeof(packet.flight_info->pilot)) ||
-          !ValidString(packet.flight_info->copilot,
-                       sizeof(packet.flight_info->copilot)) ||
-          !ValidString(packet.flight_info->glider,
-                       sizeof(packet.flight_info->glider)) ||
-          !ValidString(packet.flight_info->registration,
-                       sizeof(packet.flight_info->registration)) ||
-          !ValidString(packet.flight_info->competition_class,
-                       sizeof(packet.flight_info->competition_class)) ||
-          !ValidString(packet.flight_info->gps, sizeof(packet.flight_info->gps)))
-        return false;
-
-      if (packet.flight_info->competition_class_id > 7)
-        return false;
-
-      if (packet.flight_info->competition_class_id < 7)
-        os.Format("HFFXA%03d\r\n"
-                  "HFPLTPILOT:%s\r\n"
-                  "HFCM2CREW2:%s\r\n"
-                  "HFGTYGLIDERTYPE:%s\r\n"
-                  "HFGIDGLIDERID:%s\r\n"
-                  "HFDTM%03dGPSDATUM:%s\r\n"
-                  "HFCIDCOMPETITIONID:%s\r\n"
-                  "HFCCLCOMPETITIONCLASS:%s\r\n"
-                  "HFGPSGPS:%s\r\n",
-                  packet.flight_info->fix_accuracy,
-                  packet.flight_info->pilot,
-                  packet.flight_info->copilot,
-                  packet.flight_info->glider,
-                  packet.flight_info->registration,
-                  packet.flight_info->gps_date,
-                  LXN::FormatGPSDate(packet.flight_info->gps_date),
-                  packet.flight_info->competition_class,
-                  LXN::FormatCompetitionClass(packet.flight_info->competition_class_id),
-                  packet.flight_info->gps);
-
-      context.flight_info = *packet.flight_info;
-      break;
-
-    case LXN::K_EXT_CONFIG:
-      data += sizeof(*packet.ext_config);
-      if (data > end)
-        return false;
+  /* keep the incomplete packet until more data arrives */
+  if (data == pending.data())
+    pending.erase(pending.begin(), pending.begin() + (p - data));
+  else
+    pending.assign(p, end);
 
-      HandleExtConfig(os, *packet.ext_config, context.k_ext, 'J', 8);
-      break;
+  return true;
+}
 
-    case LXN::B_EXT_CONFIG:
-      data += sizeof(*packet.ext_config);
-      if (data > end)
-        return false;
+bool
+LX::LXNToIGCConverter::Finish()
+{
+  if (finished)
+    return true;
 
-      HandleExtConfig(os, *packet.ext_config, context.b_ext, 'I', 36);
-      break;
+  if (failed)
+    return false;
 
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wcovered-switch-default"
-#endif
-    default:
-      if (*packet.cmd < 0x40) {
-        data += sizeof(*packet.string);
-        if (data > end)
-          return false;
-
-        data += packet.string->length;
-        if (data > end)
-          return false;
-
-        os.Format("%.*s\r\n",
-                  (int)packet.string->length, packet.string->value);
-
-        if (packet.string->length >= 12 + sizeof(context.vendor) &&
-            memcmp(packet.string->value, "HFFTYFRTYPE:", 12) == 0)
-          memcpy(context.vendor, packet.string->value + 12, sizeof(context.vendor));
-      } else
-        return false;
-    }
-  }
+  const uint8_t *p = pending.data(), *end = p + pending.size();
+  failed = !Convert(p, end, true) || !finished;
+  pending.clear();
+  return !failed;
+}
 
-  return false;
+bool
+LX::ConvertLXNToIGC(const void *data, size_t length,
+                    BufferedOutputStream &os)
+{
+  LXNToIGCConverter converter(os);
+  return converter.Feed({(const std::byte *)data, length}) &&
+    converter.Finish();
 }
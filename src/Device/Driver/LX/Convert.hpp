@@ -24,10 +24,72 @@ Copyright_License {
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
 
 class BufferedOutputStream;
 
 namespace LX {
+  /**
+   * Converts LXN data to IGC while it is being downloaded.  The data
+   * may be split at arbitrary positions; an incomplete packet at the
+   * end of a chunk is kept until the next one arrives.
+   */
+  class LXNToIGCConverter {
+  public:
+    /**
+     * The conversion state (opaque).
+     */
+    struct Context;
+
+  private:
+    BufferedOutputStream &os;
+
+    const std::unique_ptr<Context> context;
+
+    /**
+     * The beginning of a packet which did not fit into the previous
+     * chunk.
+     */
+    std::vector<uint8_t> pending;
+
+    bool finished = false, failed = false;
+
+  public:
+    explicit LXNToIGCConverter(BufferedOutputStream &_os) noexcept;
+    ~LXNToIGCConverter() noexcept;
+
+    LXNToIGCConverter(const LXNToIGCConverter &) = delete;
+    LXNToIGCConverter &operator=(const LXNToIGCConverter &) = delete;
+
+    /**
+     * Has the end of the flight been found?  Data passed to Feed()
+     * afterwards is ignored.
+     */
+    bool IsFinished() const noexcept {
+      return finished;
+    }
+
+    /**
+     * Convert the next chunk of data.
+     *
+     * @return false if the data is malformed
+     */
+    bool Feed(std::span<const std::byte> src);
+
+    /**
+     * No more data will follow.
+     *
+     * @return true if the flight was converted completely
+     */
+    bool Finish();
+
+  private:
+    bool Convert(const uint8_t *&data, const uint8_t *end, bool eof);
+  };
+
   /**
    * Convert a BLOB of LXN data to IGC, write to a file.
    */
@@ -34,6 +34,7 @@
 #include "io/FileOutputStream.hxx"
 #include "util/ScopeExit.hxx"
 
+#include <algorithm>
 #include <memory>
 
 #include <stdio.h>
@@ -193,30 +194,41 @@ DownloadFlightInner(Port &port, const RecordedFlightInfo &flight,
       return false;
 
   unsigned lengths[LX::MemorySection::N];
-  unsigned total_length = 0;
+  unsigned total_length = 0, max_length = 0;
   for (unsigned i = 0; i < LX::MemorySection::N; ++i) {
     lengths[i] = FromBE16(memory_section.lengths[i]);
     total_length += lengths[i];
+    max_length = std::max(max_length, lengths[i]);
   }
 
   env.SetProgressRange(total_length);
 
-  const auto data = std::make_unique<uint8_t[]>(total_length);
-  uint8_t *p = data.get();
+  /* convert each section right after it has been received, so only
+     one section needs to be buffered */
+  LX::LXNToIGCConverter converter(os);
+  const auto data = std::make_unique<uint8_t[]>(max_length);
+  unsigned position = 0;
   for (unsigned i = 0; i < LX::MemorySection::N && lengths[i] > 0; ++i) {
     if (!LX::ReceivePacketRetry(port, (LX::Command)(LX::READ_LOGGER_DATA + i),
-                                p, lengths[i], env,
+                                data.get(), lengths[i], env,
                                 std::chrono::seconds(20),
                                 std::chrono::seconds(2),
                                 std::chrono::minutes(5), 2)) {
       return false;
     }
 
-    p += lengths[i];
-    env.SetProgressPosition(p - data.get());
+    if (!converter.Feed({(const std::byte *)data.get(), lengths[i]}))
+      return false;
+
+    position += lengths[i];
+    env.SetProgressPosition(position);
+
+    if (converter.IsFinished())
+      /* the remaining sections contain nothing of interest */
+      break;
   }
 
-  return LX::ConvertLXNToIGC(data.get(), total_length, os);
+  return converter.Finish();
 }
 
 bool
@@ -29,7 +29,7 @@ Copyright_License {
 #include "Widget/TwoWidgets.hpp"
 #include "UIGlobals.hpp"
 #include "Language/Language.hpp"
-#include "ui/event/Timer.hpp"
+#include "ui/event/IdleEvent.hpp"
 #include "ui/event/PeriodicTimer.hpp"
 
 #include <cassert>
@@ -45,14 +45,14 @@ class ListPickerWidget : public ListWidget {
   WndForm &dialog;
 
   /**
-   * This timer is used to postpone the initial UpdateHelp() call.
+   * This event is used to postpone the initial UpdateHelp() call.
    * This is necessary because the TwoWidgets instance is not fully
    * initialised yet in Show(), and recursively calling into Widget
    * methods is dangerous anyway.
    */
-  UI::Timer postpone_update_help{[this]{
+  UI::IdleEvent postpone_update_help{[this]{
     UpdateHelp(GetList().GetCursorIndex());
-  }};
+  }, UI::IdleEvent::Priority::HIGH, "ListPicker help"};
 
   const TCHAR *const caption, *const help_text;
   ItemHelpCallback_t item_help_callback;
@@ -109,7 +109,7 @@ public:
     ListWidget::Show(rc);
 
     visible = true;
-    postpone_update_help.Schedule({});
+    postpone_update_help.Schedule();
   }
 
   void Hide() noexcept override {
@@ -39,8 +39,11 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "Interface.hpp"
 #include "Renderer/TextRowRenderer.hpp"
+#include "Formatter/UserUnits.hpp"
 #include "Look/DialogLook.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "ui/event/IdleEvent.hpp"
+#include "ui/event/Notify.hpp"
 #include "util/StringCompare.hxx"
 #include "UIGlobals.hpp"
 
@@ -63,7 +66,21 @@ class TaskListPanel final
   std::unique_ptr<OrderedTask> &active_task;
   bool *task_modified;
 
-  TaskStore task_store;
+  /**
+   * Merges the new items of #task_store into the list, after pending
+   * input has been handled.
+   */
+  UI::IdleEvent update_list{[this]{ OnIndexed(); },
+                            UI::IdleEvent::Priority::NORMAL, "task list"};
+
+  /**
+   * Notifies the main thread about new items in #task_store.  It is
+   * declared before #task_store, because the #TaskStore destructor
+   * stops the indexer thread, which uses it.
+   */
+  UI::Notify index_notify{[this]{ update_list.Schedule(); }};
+
+  TaskStore task_store{[this]{ index_notify.SendNotification(); }};
   unsigned serial;
 
   /**
@@ -119,6 +136,8 @@ protected:
   const TCHAR *get_cursor_name();
 
 private:
+  void OnIndexed() noexcept;
+
   /* virtual methods from class ListControl::Handler */
   void OnPaintItem([[maybe_unused]] Canvas &canvas, [[maybe_unused]] const PixelRect rc,
                    [[maybe_unused]] unsigned idx) noexcept override;
@@ -174,7 +193,17 @@ TaskListPanel::OnPaintItem(Canvas &canvas, const PixelRect rc,
 {
   assert(DrawListIndex <= task_store.Size());
 
-  row_renderer.DrawTextRow(canvas, rc, task_store.GetName(DrawListIndex));
+  PixelRect name_rc = rc;
+
+  /* show the distance from the task index, without loading the
+     task */
+  const auto &summary = task_store.GetSummary(DrawListIndex);
+  if (summary.IsValid())
+    name_rc.right =
+      row_renderer.DrawRightColumn(canvas, rc,
+                                   FormatUserDistanceSmart(summary.distance_nominal).c_str());
+
+  row_renderer.DrawTextRow(canvas, name_rc, task_store.GetName(DrawListIndex));
 }
 
 void
@@ -199,6 +228,32 @@ TaskListPanel::RefreshView()
     two_widgets->UpdateLayout();
 }
 
+void
+TaskListPanel::OnIndexed() noexcept
+{
+  if (!GetList().IsVisible()) {
+    /* Show() will refresh the list */
+    task_store.Update();
+    return;
+  }
+
+  /* keep the cursor on the same task while the list fills up */
+  const unsigned cursor_index = GetList().GetCursorIndex();
+  const tstring cursor_name = cursor_index < task_store.Size()
+    ? task_store.GetName(cursor_index)
+    : _T("");
+
+  if (!task_store.Update())
+    return;
+
+  GetList().SetLength(task_store.Size());
+  if (!cursor_name.empty())
+    if (const int i = task_store.Find(cursor_name.c_str()); i >= 0)
+      GetList().SetCursorIndex(i);
+
+  RefreshView();
+}
+
 void
 TaskListPanel::LoadTask()
 {
@@ -219,10 +274,18 @@ TaskListPanel::LoadTask()
                   MB_YESNO | MB_ICONQUESTION) != IDYES)
     return;
 
-  // create new task first to guarantee pointers are different
-  active_task = orig->Clone(CommonInterface::GetComputerSettings().task);
-
+  /* the preview was loaded from the task index; load the task file
+     to get the exact coordinates */
   const unsigned cursor_index = GetList().GetCursorIndex();
+  auto task = task_store.LoadTask(cursor_index,
+                                  CommonInterface::GetComputerSettings().task);
+  if (task == nullptr) {
+    ShowMessageBox(_("Failed to load file."), _("Task Browser"),
+                   MB_OK | MB_ICONEXCLAMATION);
+    return;
+  }
+
+  active_task = std::move(task);
   active_task->SetName(task_store.GetName(cursor_index));
 
   RefreshView();
@@ -255,7 +318,7 @@ TaskListPanel::DeleteTask()
 
   File::Delete(path);
 
-  task_store.Scan(more);
+  task_store.Scan(CommonInterface::GetComputerSettings().task, more);
   RefreshView();
 }
 
@@ -303,7 +366,7 @@ TaskListPanel::RenameTask()
   File::Rename(task_store.GetPath(cursor_index),
                AllocatedPath::Build(tasks_path, newname));
 
-  task_store.Scan(more);
+  task_store.Scan(CommonInterface::GetComputerSettings().task, more);
   RefreshView();
 }
 
@@ -314,7 +377,7 @@ TaskListPanel::OnMoreClicked()
 
   more_button->SetCaption(more ? _("Less") : _("More"));
 
-  task_store.Scan(more);
+  task_store.Scan(CommonInterface::GetComputerSettings().task, more);
   RefreshView();
 }
 
@@ -339,7 +402,7 @@ TaskListPanel::Show(const PixelRect &rc) noexcept
   if (serial != task_list_serial) {
     serial = task_list_serial;
     // Scan XCSoarData for available tasks
-    task_store.Scan(more);
+    task_store.Scan(CommonInterface::GetComputerSettings().task, more);
   }
 
   dialog.ShowTaskView(get_cursor_task());
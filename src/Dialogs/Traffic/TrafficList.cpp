@@ -51,6 +51,8 @@ Copyright_License {
 #include "Components.hpp"
 #include "Pan.hpp"
 
+#include <iterator>
+
 using namespace std::chrono;
 
 enum Controls {
@@ -381,6 +383,25 @@ TrafficListWidget::UpdateList()
 
     for (unsigned i = 0; i < count; ++i)
       AddItem(ids[i]);
+
+    /* add FlarmNet records whose callsign, registration or pilot
+       contains the filter string, tolerating one typing error; skip
+       those found by the exact lookup above, so they don't use up
+       the remaining slots */
+    if (count < std::size(ids)) {
+      const FlarmNetRecord *records[std::size(ids)];
+      const unsigned n =
+        traffic_databases->flarm_net.Search(callsign, 1, records,
+                                            std::size(records));
+      for (unsigned i = 0; i < n && count < std::size(ids); ++i) {
+        const FlarmId id = records[i]->GetId();
+        if (FindItem(id) != items.end())
+          continue;
+
+        AddItem(id);
+        ++count;
+      }
+    }
   } else {
     /* if no filter was set, show a list of current traffic and known
        traffic */
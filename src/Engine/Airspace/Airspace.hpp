@@ -27,6 +27,7 @@
 
 #ifdef DO_PRINT
 #include <iostream>
+#include <utility>
 #endif
 
 struct GeoPoint;
@@ -63,6 +64,13 @@ public:
   Airspace(AirspacePtr _airspace,
            const FlatProjection &projection) noexcept;
 
+  /**
+   * Constructor for an airspace whose bounding box has already been
+   * calculated with AbstractAirspace::GetBoundingBox().
+   */
+  Airspace(AirspacePtr _airspace, const FlatBoundingBox &box) noexcept
+    :FlatBoundingBox(box), airspace(std::move(_airspace)) {}
+
   /**
    * Checks whether an aircraft is inside the airspace.
    *
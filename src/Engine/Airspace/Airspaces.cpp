@@ -24,12 +24,16 @@
 #include "AbstractAirspace.hpp"
 #include "AirspaceIntersectionVisitor.hpp"
 #include "Navigation/Aircraft.hpp"
+#include "thread/TaskScheduler.hpp"
 
 #include <boost/geometry/algorithms/distance.hpp>
 #include <boost/geometry/algorithms/intersection.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 #include <boost/geometry/geometries/segment.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace bgi = boost::geometry::index;
 
 Airspaces::~Airspaces() noexcept = default;
@@ -86,7 +90,7 @@ Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
 }
 
 void
-Airspaces::Optimise() noexcept
+Airspaces::Optimise(TaskScheduler *scheduler) noexcept
 {
   if (IsEmpty())
     /* avoid assertion failure in uninitialised task_projection */
@@ -102,13 +106,33 @@ Airspaces::Optimise() noexcept
     airspace_tree.clear();
   }
 
-  for (auto &i : tmp_as) {
-    Airspace as(std::move(i), task_projection);
-    airspace_tree.insert(as);
-  }
+  /* projecting the airspace borders is the expensive part; each
+     airspace has its own border, so this can be done in parallel */
+  std::vector<FlatBoundingBox> boxes(tmp_as.size());
+  const auto project = [this, &boxes](std::size_t begin, std::size_t end){
+    for (std::size_t i = begin; i < end; ++i)
+      boxes[i] = tmp_as[i]->GetBoundingBox(task_projection);
+  };
+
+  if (scheduler != nullptr)
+    scheduler->ParallelFor(0, tmp_as.size(), 0, project);
+  else
+    project(0, tmp_as.size());
+
+  AirspaceVector envelopes;
+  envelopes.reserve(tmp_as.size());
+  for (std::size_t i = 0; i < tmp_as.size(); ++i)
+    envelopes.emplace_back(std::move(tmp_as[i]), boxes[i]);
 
   tmp_as.clear();
 
+  if (airspace_tree.empty())
+    /* bulk-load the tree, which is much faster than inserting one by
+       one and results in a better tree */
+    airspace_tree = AirspaceTree(envelopes.begin(), envelopes.end());
+  else
+    airspace_tree.insert(envelopes.begin(), envelopes.end());
+
   ++serial;
 }
 
@@ -188,18 +212,9 @@ Airspaces::ClearClearances() noexcept
 
 [[gnu::pure]]
 static bool
-AirspacePointersEquals(const Airspace &a, const Airspace &b) noexcept
+AirspacePointersLess(const Airspace &a, const Airspace &b) noexcept
 {
-  return &a.GetAirspace() == &b.GetAirspace();
-}
-
-[[gnu::pure]]
-static bool
-CompareAirspaceVectors(const AirspacesInterface::AirspaceVector &a,
-                       const AirspacesInterface::AirspaceVector &b) noexcept
-{
-  return a.size() == b.size() &&
-    std::is_permutation(a.begin(), a.end(), b.begin(), AirspacePointersEquals);
+  return &a.GetAirspace() < &b.GetAirspace();
 }
 
 inline AirspacesInterface::AirspaceVector
@@ -222,21 +237,57 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
 {
   qnh = master.qnh;
   activity_mask = master.activity_mask;
-  task_projection = master.task_projection;
 
   AirspaceVector contents_master;
   for (const auto &i : master.QueryWithinRange(location, range))
     if (condition(i.GetAirspace()))
       contents_master.push_back(i);
 
-  if (CompareAirspaceVectors(contents_master, AsVector()))
+  if (master.task_projection.GetCenter() != task_projection.GetCenter()) {
+    /* the bounding boxes and clearances of all airspaces in this
+       tree were calculated with another projection: rebuild
+       everything */
+    task_projection = master.task_projection;
+
+    const bool was_empty = airspace_tree.empty();
+    for (const auto &i : QueryAll())
+      i.ClearClearance();
+    airspace_tree.clear();
+
+    if (was_empty && contents_master.empty())
+      return false;
+
+    airspace_tree.insert(contents_master.begin(), contents_master.end());
+    ++serial;
+    return true;
+  }
+
+  /* compare both sets and apply only the difference, so clearances
+     of airspaces which remain in range are preserved */
+
+  AirspaceVector contents_self = AsVector();
+  std::sort(contents_master.begin(), contents_master.end(),
+            AirspacePointersLess);
+  std::sort(contents_self.begin(), contents_self.end(),
+            AirspacePointersLess);
+
+  AirspaceVector removed, added;
+  std::set_difference(contents_self.begin(), contents_self.end(),
+                      contents_master.begin(), contents_master.end(),
+                      std::back_inserter(removed), AirspacePointersLess);
+  std::set_difference(contents_master.begin(), contents_master.end(),
+                      contents_self.begin(), contents_self.end(),
+                      std::back_inserter(added), AirspacePointersLess);
+
+  if (removed.empty() && added.empty())
     return false;
 
-  for (auto &i : QueryAll())
+  for (const auto &i : removed) {
     i.ClearClearance();
-  airspace_tree.clear();
+    airspace_tree.remove(i);
+  }
 
-  for (const auto &i : contents_master)
+  for (const auto &i : added)
     airspace_tree.insert(i);
 
   ++serial;
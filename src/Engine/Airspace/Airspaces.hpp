@@ -34,6 +34,7 @@
 
 class RasterTerrain;
 class AirspaceIntersectionVisitor;
+class TaskScheduler;
 
 /**
  * Container for airspaces using kd-tree representation internally for
@@ -85,8 +86,11 @@ public:
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
    * any searches, but can be done once after a batch insert/delete.
+   *
+   * @param scheduler if not nullptr, then the airspaces are projected
+   * in parallel
    */
-  void Optimise() noexcept;
+  void Optimise(TaskScheduler *scheduler=nullptr) noexcept;
 
   /**
    * Clear the airspace store, deleting airspace objects if m_owner is true
@@ -114,8 +118,11 @@ public:
    * Set terrain altitude for all AGL-referenced airspace altitudes
    *
    * @param terrain Terrain model for lookup
+   * @param scheduler if not nullptr, then the terrain lookups are
+   * done in parallel
    */
-  void SetGroundLevels(const RasterTerrain &terrain) noexcept;
+  void SetGroundLevels(const RasterTerrain &terrain,
+                       TaskScheduler *scheduler=nullptr) noexcept;
 
   /**
    * Set QNH pressure for all FL-referenced airspace altitudes.
@@ -204,7 +211,9 @@ public:
   void ClearClearances() noexcept;
 
   /**
-   * Copy/delete objects in this database based on query of master
+   * Copy/delete objects in this database based on query of master.
+   * Only airspaces which entered or left the range are inserted or
+   * removed; the clearances of all others are preserved.
    *
    * @param master Airspaces object to copy from
    * @param location location of aircraft, from which to search
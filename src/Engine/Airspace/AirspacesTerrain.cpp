@@ -21,19 +21,81 @@
 */
 
 #include "Airspaces.hpp"
+#include "AbstractAirspace.hpp"
 #include "Terrain/RasterTerrain.hpp"
+#include "thread/TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct GroundLevelRequest {
+  AbstractAirspace *airspace;
+
+  FlatGeoPoint location;
+
+  /**
+   * Position on a Z-order curve, to sort requests by spatial
+   * locality.
+   */
+  uint64_t key;
+};
+
+}
+
+/**
+ * Interleave the bits of both coordinates (Morton code), so nearby
+ * points get similar keys.
+ */
+[[gnu::const]]
+static uint64_t
+ZOrder(uint32_t x, uint32_t y) noexcept
+{
+  uint64_t result = 0;
+  for (unsigned i = 0; i < 32; ++i)
+    result |= (uint64_t((x >> i) & 1) << (2 * i)) |
+      (uint64_t((y >> i) & 1) << (2 * i + 1));
+  return result;
+}
 
 void
-Airspaces::SetGroundLevels(const RasterTerrain &terrain) noexcept
+Airspaces::SetGroundLevels(const RasterTerrain &terrain,
+                           TaskScheduler *scheduler) noexcept
 {
-  for (auto &v : QueryAll()) {
+  std::vector<GroundLevelRequest> requests;
+  for (const auto &v : QueryAll()) {
     // If we don't need the ground level we don't have to calculate it
     if (!v.NeedGroundLevel())
       continue;
 
-    FlatGeoPoint c_flat = v.GetCenter();
-    GeoPoint g = task_projection.Unproject(c_flat);
-    v.SetGroundLevel(terrain.GetTerrainHeight(g).GetValueOr0());
+    const FlatGeoPoint c = v.GetCenter();
+    requests.push_back({&v.GetAirspace(), c,
+                        ZOrder(uint32_t(c.x) ^ 0x80000000,
+                               uint32_t(c.y) ^ 0x80000000)});
   }
-}
 
+  /* look up neighbouring airspaces one after another, so each chunk
+     touches only a few terrain tiles */
+  std::sort(requests.begin(), requests.end(),
+            [](const GroundLevelRequest &a, const GroundLevelRequest &b){
+              return a.key < b.key;
+            });
+
+  const auto lookup = [this, &terrain, &requests](std::size_t begin,
+                                                  std::size_t end){
+    /* lock the terrain only once per chunk */
+    const RasterTerrain::Lease map(terrain);
+
+    for (std::size_t i = begin; i < end; ++i) {
+      const GeoPoint g = task_projection.Unproject(requests[i].location);
+      requests[i].airspace->SetGroundLevel(map->GetHeight(g).GetValueOr0());
+    }
+  };
+
+  if (scheduler != nullptr)
+    scheduler->ParallelFor(0, requests.size(), 0, lookup);
+  else
+    lookup(0, requests.size());
+}
@@ -24,6 +24,8 @@
 #include "util/AllocatedArray.hxx"
 #include "util/StringUtil.hpp"
 
+#include <algorithm>
+
 static constexpr std::size_t NORMALIZE_BUFFER_SIZE = 4096;
 
 // global, used for test harness
@@ -102,19 +104,50 @@ Waypoints::Waypoints()
 void
 Waypoints::Optimise()
 {
-  if (waypoint_tree.IsEmpty() || waypoint_tree.HaveBounds())
-    /* empty or already optimised */
+  if (waypoint_tree.IsEmpty())
     return;
 
-  task_projection.Update();
+  if (!waypoint_tree.HaveBounds()) {
+    task_projection.Update();
 
-  for (auto &i : waypoint_tree) {
-    // TODO: eliminate this const_cast hack
-    Waypoint &w = const_cast<Waypoint &>(*i);
-    w.Project(task_projection);
+    for (auto &i : waypoint_tree) {
+      // TODO: eliminate this const_cast hack
+      Waypoint &w = const_cast<Waypoint &>(*i);
+      w.Project(task_projection);
+    }
+
+    waypoint_tree.Optimise();
   }
 
-  waypoint_tree.Optimise();
+  if (packed_index.IsEmpty())
+    packed_index.Build(waypoint_tree.begin(), waypoint_tree.end());
+
+  if (name_index_waypoints.empty())
+    BuildNameIndex();
+}
+
+void
+Waypoints::BuildNameIndex()
+{
+  name_ngram_index.Clear();
+  name_index_waypoints.assign(waypoint_tree.begin(), waypoint_tree.end());
+
+  AllocatedArray<TCHAR> buffer;
+  for (uint32_t i = 0; i < name_index_waypoints.size(); ++i) {
+    const Waypoint &wp = *name_index_waypoints[i];
+
+    buffer.GrowDiscard(wp.name.length() + 1);
+    NormalizeSearchString(buffer.data(), wp.name.c_str());
+    name_ngram_index.Add(i, buffer.data());
+
+    if (!wp.shortname.empty()) {
+      buffer.GrowDiscard(wp.shortname.length() + 1);
+      NormalizeSearchString(buffer.data(), wp.shortname.c_str());
+      name_ngram_index.Add(i, buffer.data());
+    }
+  }
+
+  name_ngram_index.Build();
 }
 
 void
@@ -136,6 +169,7 @@ Waypoints::Append(WaypointPtr wp)
   w.id = next_id++;
 
   waypoint_tree.Add(wp);
+  InvalidateIndexes();
   name_tree.Add(wp);
 
   ++serial;
@@ -148,8 +182,15 @@ Waypoints::GetNearest(const GeoPoint &loc, double range) const
     return nullptr;
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  if (!packed_index.IsEmpty()) {
+    const PackedWaypointIndex::Point point(flat_location.x, flat_location.y);
+    const auto found = packed_index.FindNearest(point, mrange);
+    return found.first != nullptr ? *found.first : nullptr;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const auto found = waypoint_tree.FindNearest(point, mrange);
 
   if (found.first == waypoint_tree.end())
@@ -178,12 +219,19 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
     return nullptr;
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
-  const auto found = waypoint_tree.FindNearestIf(point, mrange,
-                                                 [predicate](const WaypointPtr &ptr){
-                                                   return predicate(*ptr);
-                                                 });
+  const auto p = [predicate](const WaypointPtr &ptr){
+    return predicate(*ptr);
+  };
+
+  if (!packed_index.IsEmpty()) {
+    const PackedWaypointIndex::Point point(flat_location.x, flat_location.y);
+    const auto found = packed_index.FindNearestIf(point, mrange, p);
+    return found.first != nullptr ? *found.first : nullptr;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const auto found = waypoint_tree.FindNearestIf(point, mrange, p);
 
   if (found.first == waypoint_tree.end())
     return nullptr;
@@ -191,6 +239,66 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
   return *found.first;
 }
 
+void
+Waypoints::VisitNearest(const GeoPoint &loc, double range,
+                        bool (*predicate)(const Waypoint &),
+                        const WaypointNearestVisitor &visitor) const
+{
+  if (IsEmpty())
+    return;
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  if (!packed_index.IsEmpty()) {
+    const PackedWaypointIndex::Point point(flat_location.x, flat_location.y);
+    packed_index.VisitNearestIf(point, mrange,
+                                [predicate](const WaypointPtr &ptr){
+                                  return predicate == nullptr ||
+                                    predicate(*ptr);
+                                },
+                                [&visitor](const WaypointPtr &ptr, unsigned){
+                                  return visitor(ptr);
+                                });
+    return;
+  }
+
+  /* not optimised: collect all candidates and sort them */
+  std::vector<std::pair<unsigned, WaypointPtr>> candidates;
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const auto collect = [&candidates, predicate, &flat_location](const WaypointPtr &ptr){
+    if (predicate == nullptr || predicate(*ptr))
+      candidates.emplace_back(flat_location.DistanceSquared(ptr->flat_location),
+                              ptr);
+  };
+  waypoint_tree.VisitWithinRange(point, mrange, collect);
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto &a, const auto &b){
+                     return a.first < b.first;
+                   });
+
+  for (const auto &i : candidates)
+    if (!visitor(i.second))
+      break;
+}
+
+std::vector<WaypointPtr>
+Waypoints::GetNearestN(const GeoPoint &loc, double range, unsigned n,
+                       bool (*predicate)(const Waypoint &)) const
+{
+  std::vector<WaypointPtr> result;
+  if (n == 0)
+    return result;
+
+  VisitNearest(loc, range, predicate, [&result, n](const WaypointPtr &ptr){
+    result.push_back(ptr);
+    return result.size() < n;
+  });
+
+  return result;
+}
+
 WaypointPtr
 Waypoints::LookupName(const TCHAR *name) const
 {
@@ -255,9 +363,15 @@ Waypoints::VisitWithinRange(const GeoPoint &loc, const double range,
     return; // nothing to do
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
 
+  if (!packed_index.IsEmpty()) {
+    const PackedWaypointIndex::Point point(flat_location.x, flat_location.y);
+    packed_index.VisitWithinRange(point, mrange, visitor);
+    return;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
   waypoint_tree.VisitWithinRange(point, mrange, visitor);
 }
 
@@ -268,6 +382,93 @@ Waypoints::VisitNamePrefix(const TCHAR *prefix,
   name_tree.VisitNormalisedPrefix(prefix, visitor);
 }
 
+/**
+ * Calculate the distance between the normalised query and the
+ * closest substring of the waypoint's name or short name.
+ */
+static unsigned
+NameDistance(const Waypoint &wp, const TCHAR *normalized_query,
+             AllocatedArray<TCHAR> &buffer) noexcept
+{
+  buffer.GrowDiscard(wp.name.length() + 1);
+  NormalizeSearchString(buffer.data(), wp.name.c_str());
+  unsigned distance = ApproximateSubstringDistance(buffer.data(),
+                                                   normalized_query);
+
+  if (distance > 0 && !wp.shortname.empty()) {
+    buffer.GrowDiscard(wp.shortname.length() + 1);
+    NormalizeSearchString(buffer.data(), wp.shortname.c_str());
+    distance = std::min(distance,
+                        ApproximateSubstringDistance(buffer.data(),
+                                                     normalized_query));
+  }
+
+  return distance;
+}
+
+std::vector<WaypointPtr>
+Waypoints::SearchName(const TCHAR *query, unsigned max_errors,
+                      unsigned max_results) const
+{
+  std::vector<WaypointPtr> result;
+
+  const std::size_t length = StringLength(query);
+  if (length == 0 || length >= NORMALIZE_BUFFER_SIZE || max_results == 0)
+    return result;
+
+  TCHAR normalized[NORMALIZE_BUFFER_SIZE];
+  NormalizeSearchString(normalized, query);
+  if (StringIsEmpty(normalized))
+    return result;
+
+  /* a pattern which may be deleted entirely matches everything */
+  if (StringLength(normalized) <= max_errors)
+    max_errors = StringLength(normalized) - 1;
+
+  struct Match {
+    unsigned distance, score;
+    WaypointPtr waypoint;
+  };
+
+  std::vector<Match> matches;
+  AllocatedArray<TCHAR> buffer;
+
+  const auto check = [&](const WaypointPtr &wp, unsigned score){
+    const unsigned distance = NameDistance(*wp, normalized, buffer);
+    if (distance <= max_errors)
+      matches.push_back({distance, score, wp});
+  };
+
+  std::vector<NGramIndex::Candidate> candidates;
+  if (!name_index_waypoints.empty() &&
+      name_ngram_index.FindCandidates(normalized, max_errors, candidates)) {
+    for (const auto &c : candidates)
+      check(name_index_waypoints[c.id], c.score);
+  } else {
+    /* the index is not available or cannot filter this query */
+    for (const auto &wp : waypoint_tree)
+      check(wp, 0);
+  }
+
+  std::stable_sort(matches.begin(), matches.end(),
+                   [](const Match &a, const Match &b){
+                     if (a.distance != b.distance)
+                       return a.distance < b.distance;
+                     if (a.score != b.score)
+                       return a.score > b.score;
+                     return a.waypoint->name < b.waypoint->name;
+                   });
+
+  if (matches.size() > max_results)
+    matches.resize(max_results);
+
+  result.reserve(matches.size());
+  for (auto &i : matches)
+    result.push_back(std::move(i.waypoint));
+
+  return result;
+}
+
 void
 Waypoints::Clear()
 {
@@ -275,6 +476,7 @@ Waypoints::Clear()
   home = nullptr;
   name_tree.Clear();
   waypoint_tree.clear();
+  InvalidateIndexes();
   next_id = 1;
 }
 
@@ -292,12 +494,15 @@ Waypoints::Erase(WaypointPtr &&wp)
 
   name_tree.Remove(std::move(wp));
   waypoint_tree.erase(f.first);
+  InvalidateIndexes();
   ++serial;
 }
 
 void
 Waypoints::EraseUserMarkers()
 {
+  InvalidateIndexes();
+
   waypoint_tree.EraseIf([this](const WaypointPtr &wp){
       if (wp->origin == WaypointOrigin::USER &&
           wp->type == Waypoint::Type::MARKER) {
@@ -340,6 +545,7 @@ Waypoints::Replace(const WaypointPtr &orig, Waypoint &&replacement)
   assert(f.first != waypoint_tree.end());
 
   waypoint_tree.Replace(f.first, std::move(new_ptr));
+  InvalidateIndexes();
 
   ++serial;
 }
@@ -24,15 +24,24 @@
 
 #include "util/RadixTree.hpp"
 #include "util/QuadTree.hxx"
+#include "util/PackedPointIndex.hpp"
+#include "util/NGramIndex.hpp"
 #include "util/Serial.hpp"
 #include "Ptr.hpp"
 #include "Waypoint.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 
 #include <functional>
+#include <vector>
 
 using WaypointVisitor = std::function<void(const WaypointPtr &)>;
 
+/**
+ * A visitor for Waypoints::VisitNearest().  It returns false to stop
+ * the search.
+ */
+using WaypointNearestVisitor = std::function<bool(const WaypointPtr &)>;
+
 /**
  * Container for waypoints using kd-tree representation internally for
  * fast geospatial lookups.
@@ -59,6 +68,12 @@ class Waypoints {
    */
   typedef QuadTree<WaypointPtr, WaypointAccessor> WaypointTree;
 
+  /**
+   * Read-only copy of #WaypointTree which is built by Optimise() and
+   * used for queries until the next modification.
+   */
+  using PackedWaypointIndex = PackedPointIndex<WaypointPtr, WaypointAccessor>;
+
   class WaypointNameTree : public RadixTree<WaypointPtr> {
   public:
     WaypointPtr Get(const TCHAR *name) const;
@@ -77,7 +92,24 @@ class Waypoints {
   unsigned next_id;
 
   WaypointTree waypoint_tree;
+
+  /**
+   * Empty if the #waypoint_tree has been modified since the last
+   * Optimise() call; queries then fall back to #waypoint_tree.
+   */
+  PackedWaypointIndex packed_index;
+
   WaypointNameTree name_tree;
+
+  /**
+   * Trigram index of the normalised names and short names, built by
+   * Optimise().  The ids are indexes into #name_index_waypoints;
+   * both are empty after a modification, and SearchName() then falls
+   * back to a linear scan.
+   */
+  NGramIndex name_ngram_index;
+  std::vector<WaypointPtr> name_index_waypoints;
+
   TaskProjection task_projection;
 
   WaypointPtr home;
@@ -164,6 +196,9 @@ public:
    * Note: currently this code doesn't check for task projections
    * being modified from multiple calls to Optimise() so it should
    * only be called once (until this is fixed).
+   *
+   * Afterwards, spatial queries use a packed read-only index until
+   * the next modification.
    */
   void Optimise();
 
@@ -171,6 +206,7 @@ public:
    * Prepare and enable the next Optimise() call.
    */
   void ScheduleOptimise() {
+    InvalidateIndexes();
     waypoint_tree.Flatten();
     waypoint_tree.ClearBounds();
   }
@@ -305,6 +341,18 @@ public:
    */
   void VisitNamePrefix(const TCHAR *prefix, WaypointVisitor visitor) const;
 
+  /**
+   * Find waypoints whose name or short name contains the query,
+   * tolerating the specified number of typing errors (insertions,
+   * deletions or substitutions).  Exact substring matches come
+   * first.
+   *
+   * @param max_results the maximum number of waypoints returned
+   */
+  std::vector<WaypointPtr> SearchName(const TCHAR *query,
+                                      unsigned max_errors,
+                                      unsigned max_results) const;
+
   /**
    * Returns a set of possible characters following the specified
    * prefix.
@@ -355,6 +403,36 @@ public:
   WaypointPtr GetNearestIf(const GeoPoint &loc, double range,
                            bool (*predicate)(const Waypoint &)) const;
 
+  /**
+   * Call the visitor on waypoints within range, nearest first.
+   * Performs search according to flat-earth internal representation,
+   * so the order is approximate.
+   *
+   * @param loc Location from which to search
+   * @param range Distance in meters of search radius
+   * @param predicate an optional callback that checks whether the
+   * waypoint is suitable for the request
+   * @param visitor Visitor to be called on waypoints within range;
+   * it returns false to stop the search
+   */
+  void VisitNearest(const GeoPoint &loc, double range,
+                    bool (*predicate)(const Waypoint &),
+                    const WaypointNearestVisitor &visitor) const;
+
+  /**
+   * Looks up the nearest waypoints to the search location, nearest
+   * first.
+   *
+   * @param loc Location from which to search
+   * @param range Distance in meters of search radius
+   * @param n the maximum number of waypoints to return
+   * @param predicate an optional callback that checks whether the
+   * waypoint is suitable for the request
+   */
+  std::vector<WaypointPtr> GetNearestN(const GeoPoint &loc, double range,
+                                       unsigned n,
+                                       bool (*predicate)(const Waypoint &)=nullptr) const;
+
   /**
    * Access first waypoint in store, for use in iterators.
    *
@@ -372,4 +450,17 @@ public:
   const_iterator end() const {
     return waypoint_tree.end();
   }
+
+private:
+  /**
+   * Discard the read-only indexes built by Optimise() after a
+   * modification.
+   */
+  void InvalidateIndexes() noexcept {
+    packed_index.clear();
+    name_ngram_index.Clear();
+    name_index_waypoints.clear();
+  }
+
+  void BuildNameIndex();
 };
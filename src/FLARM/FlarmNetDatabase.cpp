@@ -22,9 +22,62 @@ Copyright_License {
 */
 
 #include "FlarmNetDatabase.hpp"
+#include "system/FileMapping.hpp"
+#include "io/BufferedOutputStream.hxx"
 #include "util/StringUtil.hpp"
+#include "util/StringAPI.hxx"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+
+/* the cache file contains raw copies of these */
+static_assert(std::is_trivially_copyable_v<FlarmId>);
+static_assert(std::is_trivially_copyable_v<FlarmNetRecord>);
+static_assert(alignof(FlarmNetRecord) <= alignof(FlarmId));
+
+struct FlarmNetCacheHeader {
+  static constexpr uint32_t MAGIC = 0x464e6462;
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t magic, version;
+
+  /**
+   * The size of #FlarmNetRecord, which depends on the character
+   * type.
+   */
+  uint32_t record_size;
+
+  uint32_t n_records;
+};
+
+FlarmNetDatabase::FlarmNetDatabase() noexcept = default;
+FlarmNetDatabase::~FlarmNetDatabase() noexcept = default;
+
+void
+FlarmNetDatabase::Clear() noexcept
+{
+  owned_ids.clear();
+  owned_records.clear();
+  mapping.reset();
+  UpdateSpans();
+  ClearIndex();
+}
+
+void
+FlarmNetDatabase::Detach() noexcept
+{
+  if (mapping == nullptr)
+    return;
+
+  owned_ids.assign(ids.begin(), ids.end());
+  owned_records.assign(records.begin(), records.end());
+  mapping.reset();
+  UpdateSpans();
+}
 
 void
 FlarmNetDatabase::Insert(const FlarmNetRecord &record)
@@ -34,19 +87,309 @@ FlarmNetDatabase::Insert(const FlarmNetRecord &record)
     /* ignore malformed records */
     return;
 
-  map.insert(std::make_pair(id, record));
+  Detach();
+
+  /* FlarmNet files are usually sorted, which makes this an append */
+  const auto i = std::lower_bound(owned_ids.begin(), owned_ids.end(), id);
+  if (i != owned_ids.end() && *i == id)
+    /* keep the first record */
+    return;
+
+  owned_records.insert(std::next(owned_records.begin(),
+                                 std::distance(owned_ids.begin(), i)),
+                       record);
+  owned_ids.insert(i, id);
+  UpdateSpans();
+  ClearIndex();
+}
+
+void
+FlarmNetDatabase::Append(const FlarmNetRecord &record) noexcept
+{
+  FlarmId id = record.GetId();
+  if (!id.IsDefined())
+    /* ignore malformed records */
+    return;
+
+  Detach();
+
+  owned_ids.push_back(id);
+  owned_records.push_back(record);
+  UpdateSpans();
+  ClearIndex();
+}
+
+void
+FlarmNetDatabase::Finish() noexcept
+{
+  Detach();
+
+  /* FlarmNet files are usually sorted, which makes this a no-op */
+  if (std::adjacent_find(owned_ids.begin(), owned_ids.end(),
+                         std::greater_equal<FlarmId>{}) != owned_ids.end()) {
+    std::vector<uint32_t> order(owned_ids.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    /* stable, so the first of several records with the same id
+       wins */
+    std::stable_sort(order.begin(), order.end(),
+                     [this](uint32_t a, uint32_t b){
+                       return owned_ids[a] < owned_ids[b];
+                     });
+
+    std::vector<FlarmId> new_ids;
+    std::vector<FlarmNetRecord> new_records;
+    new_ids.reserve(order.size());
+    new_records.reserve(order.size());
+
+    for (const uint32_t i : order) {
+      if (!new_ids.empty() && new_ids.back() == owned_ids[i])
+        continue;
+
+      new_ids.push_back(owned_ids[i]);
+      new_records.push_back(owned_records[i]);
+    }
+
+    owned_ids = std::move(new_ids);
+    owned_records = std::move(new_records);
+    UpdateSpans();
+    ClearIndex();
+  }
+}
+
+void
+FlarmNetDatabase::SaveCache(BufferedOutputStream &os) const
+{
+  FlarmNetCacheHeader header{};
+  header.magic = FlarmNetCacheHeader::MAGIC;
+  header.version = FlarmNetCacheHeader::VERSION;
+  header.record_size = sizeof(FlarmNetRecord);
+  header.n_records = records.size();
+
+  os.Write(&header, sizeof(header));
+  os.Write(ids.data(), ids.size_bytes());
+  os.Write(records.data(), records.size_bytes());
+}
+
+/**
+ * Is the string terminated within its buffer?
+ */
+template<typename S>
+static bool
+IsTerminated(const S &s) noexcept
+{
+  const auto *p = s.c_str(), *end = p + s.capacity();
+  return std::find(p, end, _T('\0')) != end;
+}
+
+static bool
+IsTerminated(const FlarmNetRecord &record) noexcept
+{
+  return IsTerminated(record.id) &&
+    IsTerminated(record.pilot) &&
+    IsTerminated(record.airfield) &&
+    IsTerminated(record.plane_type) &&
+    IsTerminated(record.registration) &&
+    IsTerminated(record.callsign) &&
+    IsTerminated(record.frequency);
+}
+
+bool
+FlarmNetDatabase::LoadCache(std::unique_ptr<FileMapping> &&_mapping,
+                            std::size_t offset) noexcept
+{
+  assert(_mapping != nullptr);
+
+  const std::size_t size = _mapping->size();
+  if (offset % alignof(FlarmNetCacheHeader) != 0 ||
+      size < offset + sizeof(FlarmNetCacheHeader))
+    return false;
+
+  const auto &header =
+    *(const FlarmNetCacheHeader *)_mapping->at(offset);
+  if (header.magic != FlarmNetCacheHeader::MAGIC ||
+      header.version != FlarmNetCacheHeader::VERSION ||
+      header.record_size != sizeof(FlarmNetRecord))
+    return false;
+
+  const std::size_t n = header.n_records;
+  offset += sizeof(header);
+  if ((size - offset) / (sizeof(FlarmId) + sizeof(FlarmNetRecord)) < n)
+    return false;
+
+  const std::span<const FlarmId> new_ids{
+    (const FlarmId *)_mapping->at(offset),
+    n,
+  };
+
+  const std::span<const FlarmNetRecord> new_records{
+    (const FlarmNetRecord *)_mapping->at(offset + new_ids.size_bytes()),
+    n,
+  };
+
+  /* binary search requires strictly ascending ids */
+  if (std::adjacent_find(new_ids.begin(), new_ids.end(),
+                         std::greater_equal<FlarmId>{}) != new_ids.end())
+    return false;
+
+  /* the strings are used without a length check */
+  if (!std::all_of(new_records.begin(), new_records.end(),
+                   [](const FlarmNetRecord &r){ return IsTerminated(r); }))
+    return false;
+
+  owned_ids.clear();
+  owned_ids.shrink_to_fit();
+  owned_records.clear();
+  owned_records.shrink_to_fit();
+
+  mapping = std::move(_mapping);
+  ids = new_ids;
+  records = new_records;
+  ClearIndex();
+  return true;
+}
+
+const FlarmNetRecord *
+FlarmNetDatabase::FindRecordById(FlarmId id) const noexcept
+{
+  const auto i = std::lower_bound(ids.begin(), ids.end(), id);
+  return i != ids.end() && *i == id
+    ? &records[std::distance(ids.begin(), i)]
+    : nullptr;
+}
+
+/**
+ * The record fields which are searched by FlarmNetDatabase::Search().
+ */
+static const TCHAR *
+GetSearchField(const FlarmNetRecord &record, unsigned i) noexcept
+{
+  switch (i) {
+  case 0:
+    return record.callsign;
+
+  case 1:
+    return record.registration;
+
+  default:
+    return record.pilot;
+  }
+}
+
+static constexpr unsigned N_SEARCH_FIELDS = 3;
+
+/**
+ * Large enough for the normalised form of each field.
+ */
+using NormalizedField = StaticString<LatinBufferSize(22)>;
+
+void
+FlarmNetDatabase::BuildIndex() const noexcept
+{
+  if (index_valid)
+    return;
+
+  index.Clear();
+
+  NormalizedField buffer;
+  for (uint32_t i = 0; i < records.size(); ++i) {
+    for (unsigned f = 0; f < N_SEARCH_FIELDS; ++f) {
+      NormalizeSearchString(buffer.buffer(), GetSearchField(records[i], f));
+      index.Add(i, buffer);
+    }
+  }
+
+  index.Build();
+  index_valid = true;
+}
+
+/**
+ * Calculate the distance between the normalised query and the
+ * closest substring of one of the record's searchable fields.
+ */
+static unsigned
+SearchDistance(const FlarmNetRecord &record,
+               const TCHAR *normalized_query) noexcept
+{
+  unsigned distance = StringLength(normalized_query);
+
+  NormalizedField buffer;
+  for (unsigned f = 0; f < N_SEARCH_FIELDS && distance > 0; ++f) {
+    NormalizeSearchString(buffer.buffer(), GetSearchField(record, f));
+    distance = std::min(distance,
+                        ApproximateSubstringDistance(buffer,
+                                                     normalized_query));
+  }
+
+  return distance;
+}
+
+unsigned
+FlarmNetDatabase::Search(const TCHAR *query, unsigned max_errors,
+                         const FlarmNetRecord *array[],
+                         unsigned size) const
+{
+  /* longer queries cannot match any field */
+  if (StringLength(query) >= NormalizedField::capacity())
+    return 0;
+
+  NormalizedField normalized;
+  NormalizeSearchString(normalized.buffer(), query);
+
+  const unsigned length = normalized.length();
+  if (length == 0 || size == 0)
+    return 0;
+
+  /* a pattern which may be deleted entirely matches everything */
+  if (length <= max_errors)
+    max_errors = length - 1;
+
+  struct Match {
+    unsigned distance, score;
+    const FlarmNetRecord *record;
+  };
+
+  std::vector<Match> matches;
+
+  const auto check = [&](const FlarmNetRecord &record, unsigned score){
+    const unsigned distance = SearchDistance(record, normalized);
+    if (distance <= max_errors)
+      matches.push_back({distance, score, &record});
+  };
+
+  BuildIndex();
+
+  std::vector<NGramIndex::Candidate> candidates;
+  if (!index.IsEmpty() &&
+      index.FindCandidates(normalized, max_errors, candidates)) {
+    for (const auto &c : candidates)
+      check(records[c.id], c.score);
+  } else {
+    /* the index is not available or cannot filter this query */
+    for (const auto &record : records)
+      check(record, 0);
+  }
+
+  std::stable_sort(matches.begin(), matches.end(),
+                   [](const Match &a, const Match &b){
+                     if (a.distance != b.distance)
+                       return a.distance < b.distance;
+                     return a.score > b.score;
+                   });
+
+  const unsigned count = std::min<std::size_t>(matches.size(), size);
+  for (unsigned i = 0; i < count; ++i)
+    array[i] = matches[i].record;
+
+  return count;
 }
 
 const FlarmNetRecord *
 FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
 {
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
-
-    const FlarmNetRecord &record = i.second;
+  for (const auto &record : records)
     if (StringIsEqual(record.callsign, cn))
       return &record;
-  }
 
   return NULL;
 }
@@ -54,14 +397,14 @@ FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
 unsigned
 FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
                                         const FlarmNetRecord *array[],
-                                        [[maybe_unused]] unsigned size) const
+                                        unsigned size) const
 {
   unsigned count = 0;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
+  for (const auto &record : records) {
+    if (count >= size)
+      break;
 
-    const FlarmNetRecord &record = i.second;
     if (StringIsEqual(record.callsign, cn))
       array[count++] = &record;
   }
@@ -71,16 +414,15 @@ FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
 
 unsigned
 FlarmNetDatabase::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
-                                    [[maybe_unused]] unsigned size) const
+                                    unsigned size) const
 {
   unsigned count = 0;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
+  for (std::size_t i = 0; i < records.size() && count < size; ++i) {
+    assert(ids[i].IsDefined());
 
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = i.first;
+    if (StringIsEqual(records[i].callsign, cn))
+      array[count++] = ids[i];
   }
 
   return count;
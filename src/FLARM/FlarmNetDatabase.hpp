@@ -25,40 +25,120 @@ Copyright_License {
 
 #include "FlarmId.hpp"
 #include "FlarmNetRecord.hpp"
+#include "util/NGramIndex.hpp"
 
-#include <map>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
 #include <tchar.h>
 
+class FileMapping;
+class BufferedOutputStream;
+
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * The records are kept in an array sorted by FLARM id.  It is either
+ * owned by this object (filled by Insert()) or a read-only view of a
+ * cache file mapped into memory (LoadCache()).
  */
 class FlarmNetDatabase {
-  typedef std::map<FlarmId, FlarmNetRecord> RecordMap;
-  RecordMap map;
+  /**
+   * The records added with Insert() or Append(), sorted by id
+   * (except while bulk loading, see Finish()).
+   */
+  std::vector<FlarmId> owned_ids;
+  std::vector<FlarmNetRecord> owned_records;
+
+  /**
+   * The cache file loaded by LoadCache().  If set, #ids and
+   * #records point into it, and the "owned" vectors are empty.
+   */
+  std::unique_ptr<FileMapping> mapping;
+
+  std::span<const FlarmId> ids;
+  std::span<const FlarmNetRecord> records;
+
+  /**
+   * Trigram index of the callsign, registration and pilot name of
+   * all records, built by BuildIndex() (on the first Search() call).
+   * The ids are indexes into #records.  It is cleared by each
+   * modification.
+   */
+  mutable NGramIndex index;
+  mutable bool index_valid = false;
 
 public:
+  using const_iterator = std::span<const FlarmNetRecord>::iterator;
+
+  FlarmNetDatabase() noexcept;
+  ~FlarmNetDatabase() noexcept;
+
+  FlarmNetDatabase(const FlarmNetDatabase &) = delete;
+  FlarmNetDatabase &operator=(const FlarmNetDatabase &) = delete;
+
   bool IsEmpty() const {
-    return map.empty();
+    return records.empty();
   }
 
-  void Clear() {
-    map.clear();
+  std::size_t size() const {
+    return records.size();
   }
 
+  void Clear() noexcept;
+
+  /**
+   * Add a record.  Records with a duplicate id are ignored.
+   */
   void Insert(const FlarmNetRecord &record);
 
+  /**
+   * Add a record without keeping the array sorted.  This is meant
+   * for bulk loading; lookups are not possible until Finish() has
+   * been called.
+   */
+  void Append(const FlarmNetRecord &record) noexcept;
+
+  /**
+   * Sort the records added with Append() and drop duplicate ids
+   * (keeping the first one).
+   */
+  void Finish() noexcept;
+
+  /**
+   * Build the name search index now instead of on the first
+   * Search() call.
+   */
+  void BuildIndex() const noexcept;
+
+  /**
+   * Write all records to a cache file which can be loaded with
+   * LoadCache().
+   *
+   * Throws on error.
+   */
+  void SaveCache(BufferedOutputStream &os) const;
+
+  /**
+   * Replace the contents of this object with a cache file written by
+   * SaveCache().  The records are not copied; the mapping is kept
+   * until the next modification.
+   *
+   * @param offset the position of the SaveCache() data within the
+   * mapping
+   * @return false if the file is malformed
+   */
+  bool LoadCache(std::unique_ptr<FileMapping> &&_mapping,
+                 std::size_t offset) noexcept;
+
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
    * @param id FLARM id
    * @return FLARMNetRecord object
    */
   [[gnu::pure]]
-  const FlarmNetRecord *FindRecordById(FlarmId id) const {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmNetRecord *FindRecordById(FlarmId id) const noexcept;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
@@ -74,11 +154,40 @@ public:
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                              unsigned size) const;
 
-  RecordMap::const_iterator begin() const {
-    return map.begin();
+  /**
+   * Find records whose callsign, registration or pilot name contains
+   * the query, tolerating the specified number of typing errors.
+   * Exact substring matches come first.  The first call builds the
+   * search index (see BuildIndex()), therefore this must not be
+   * called from two threads at a time.
+   *
+   * @return the number of records written to the array
+   */
+  unsigned Search(const TCHAR *query, unsigned max_errors,
+                  const FlarmNetRecord *array[], unsigned size) const;
+
+  const_iterator begin() const {
+    return records.begin();
+  }
+
+  const_iterator end() const {
+    return records.end();
+  }
+
+private:
+  /**
+   * Copy the mapped records to the "owned" vectors, to allow
+   * modifications.
+   */
+  void Detach() noexcept;
+
+  void UpdateSpans() noexcept {
+    ids = owned_ids;
+    records = owned_records;
   }
 
-  RecordMap::const_iterator end() const {
-    return map.end();
+  void ClearIndex() noexcept {
+    index.Clear();
+    index_valid = false;
   }
 };
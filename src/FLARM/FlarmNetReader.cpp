@@ -134,11 +134,12 @@ FlarmNetReader::LoadFile(NLineReader &reader, FlarmNetDatabase &database)
   while ((line = reader.ReadLine()) != NULL) {
     FlarmNetRecord record;
     if (LoadRecord(record, line)) {
-      database.Insert(record);
+      database.Append(record);
       itemCount++;
     }
   }
 
+  database.Finish();
   return itemCount;
 }
 
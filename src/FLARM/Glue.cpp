@@ -30,15 +30,49 @@ Copyright_License {
 #include "MergeThread.hpp"
 #include "LocalPath.hpp"
 #include "io/DataFile.hpp"
+#include "io/FileCache.hpp"
 #include "io/LineReader.hpp"
 #include "io/FileOutputStream.hxx"
 #include "io/BufferedOutputStream.hxx"
+#include "system/FileMapping.hpp"
 #include "Profile/FlarmProfile.hpp"
 #include "Profile/Current.hpp"
 #include "LogFile.hpp"
 #include "Profile/Profile.hpp"
 #include "Profile/ProfileKeys.hpp"
 
+static const TCHAR *const flarmnet_cache_name = _T("flarmnet");
+
+/**
+ * Maps the binary copy of the FLARMnet file from the cache, if it is
+ * up to date.
+ */
+static bool
+LoadFLARMnetCache(FlarmNetDatabase &db, Path path) noexcept
+{
+  if (file_cache == nullptr)
+    return false;
+
+  auto mapping = file_cache->Map(flarmnet_cache_name, path);
+  return mapping &&
+    db.LoadCache(std::move(mapping), FileCache::GetHeaderSize());
+}
+
+static void
+SaveFLARMnetCache(const FlarmNetDatabase &db, Path path) noexcept
+try {
+  if (file_cache == nullptr)
+    return;
+
+  auto os = file_cache->Save(flarmnet_cache_name, path);
+  BufferedOutputStream bos(*os);
+  db.SaveCache(bos);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save FLARMnet cache");
+}
+
 /**
  * Loads the FLARMnet file
  */
@@ -50,9 +84,16 @@ try {
     return;
   }
 
+  if (LoadFLARMnetCache(db, path)) {
+    LogFormat("%u FLARMnet ids loaded from cache", unsigned(db.size()));
+    return;
+  }
+
   unsigned num_records = FlarmNetReader::LoadFile(path, db);
-  if (num_records > 0)
+  if (num_records > 0) {
     LogFormat("%u FLARMnet ids found", num_records);
+    SaveFLARMnetCache(db, path);
+  }
 } catch (...) {
   LogError(std::current_exception());
 }
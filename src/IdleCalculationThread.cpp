@@ -0,0 +1,111 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IdleCalculationThread.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Hardware/CPU.hpp"
+#include "time/PeriodClock.hpp"
+#include "LogFile.hpp"
+
+using namespace std::chrono;
+
+/**
+ * If one run of the slow calculations takes longer than this, a
+ * debug message is logged.
+ */
+static constexpr auto TICK_BUDGET = milliseconds{300};
+
+IdleCalculationThread::IdleCalculationThread(GlideComputer &_glide_computer,
+                                             WorkerThread &_calculation_thread) noexcept
+  :WorkerThread("IdleCalcThread",
+#ifdef KOBO
+                milliseconds{900},
+#else
+                milliseconds{450},
+#endif
+                milliseconds{100}),
+   glide_computer(_glide_computer),
+   calculation_thread(_calculation_thread)
+{
+}
+
+void
+IdleCalculationThread::Submit(const MoreData &_basic,
+                              const DerivedInfo &_calculated,
+                              const ComputerSettings &_settings) noexcept
+{
+  {
+    const std::lock_guard lock{data_mutex};
+    input_basic = _basic;
+    input_calculated = _calculated;
+    input_settings = _settings;
+  }
+
+  Trigger();
+}
+
+bool
+IdleCalculationThread::CollectResults() noexcept
+{
+  const std::lock_guard lock{data_mutex};
+  if (!output_available)
+    return false;
+
+  glide_computer.ReadIdleResults(output);
+  output_available = false;
+  return true;
+}
+
+void
+IdleCalculationThread::Tick() noexcept
+{
+#ifdef HAVE_CPU_FREQUENCY
+  const ScopeLockCPU cpu;
+#endif
+
+  {
+    const std::lock_guard lock{data_mutex};
+    basic = input_basic;
+    calculated = input_calculated;
+    settings = input_settings;
+  }
+
+  PeriodClock clock;
+  clock.Update();
+
+  glide_computer.ProcessIdle(basic, calculated, settings);
+
+  const auto elapsed = clock.Elapsed();
+  if (elapsed > TICK_BUDGET)
+    LogDebug("IdleCalculationThread: %u ms over budget",
+             (unsigned)duration_cast<milliseconds>(elapsed - TICK_BUDGET).count());
+
+  {
+    const std::lock_guard lock{data_mutex};
+    GlideComputer::CopyIdleResults(output, calculated);
+    output_available = true;
+  }
+
+  /* let the CalculationThread publish the new results */
+  calculation_thread.Trigger();
+}
@@ -0,0 +1,102 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "thread/WorkerThread.hpp"
+#include "thread/Mutex.hxx"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "Computer/Settings.hpp"
+
+class GlideComputer;
+
+/**
+ * This thread runs the slow calculations of the #GlideComputer
+ * (route, reach, contest, airspace warnings, logging), so they do
+ * not delay the fast calculations in the #CalculationThread.
+ *
+ * The #CalculationThread submits a snapshot of the #GlideComputer's
+ * blackboard with Submit(), and merges the results back with
+ * CollectResults().
+ */
+class IdleCalculationThread final : public WorkerThread {
+  GlideComputer &glide_computer;
+
+  /**
+   * This thread is triggered after new results have been published.
+   */
+  WorkerThread &calculation_thread;
+
+  /**
+   * This mutex protects #input_basic, #input_calculated,
+   * #input_settings, #output and the flags.
+   */
+  Mutex data_mutex;
+
+  MoreData input_basic;
+  DerivedInfo input_calculated;
+  ComputerSettings input_settings;
+
+  DerivedInfo output;
+
+  bool output_available = false;
+
+  /**
+   * The working copy used by Tick().  Only accessed by this thread.
+   */
+  MoreData basic;
+  DerivedInfo calculated;
+  ComputerSettings settings;
+
+public:
+  IdleCalculationThread(GlideComputer &_glide_computer,
+                        WorkerThread &_calculation_thread) noexcept;
+
+  /**
+   * Throws on error.
+   */
+  void Start(bool suspended=false) {
+    WorkerThread::Start(suspended);
+    SetLowPriority();
+  }
+
+  /**
+   * Submit a new snapshot and wake up the thread.  If the thread is
+   * still busy with the previous one, the new snapshot replaces any
+   * other pending snapshot.
+   */
+  void Submit(const MoreData &basic, const DerivedInfo &calculated,
+              const ComputerSettings &settings) noexcept;
+
+  /**
+   * Copy the latest results (if any) to the #GlideComputer's
+   * blackboard.  Must be called by the #CalculationThread.
+   *
+   * @return true if new results were available
+   */
+  bool CollectResults() noexcept;
+
+protected:
+  void Tick() noexcept override;
+};
@@ -34,8 +34,8 @@ Copyright_License {
 #include "Renderer/FlightListRenderer.hpp"
 #include "Renderer/TextRenderer.hpp"
 #include "FlightInfo.hpp"
-#include "Logger/FlightParser.hpp"
-#include "io/FileLineReader.hpp"
+#include "Logger/FlightIndex.hpp"
+#include "system/Path.hpp"
 #include "io/UniqueFileDescriptor.hxx"
 #include "Resources.hpp"
 #include "Model.hpp"
@@ -153,13 +153,16 @@ DrawUserText(Canvas &canvas, PixelRect &rc) noexcept
 static void
 DrawFlights(Canvas &canvas, const PixelRect &rc)
 try {
-  FileLineReaderA file(Path("/mnt/onboard/XCSoarData/flights.log"));
+  /* the index (maintained by XCSoar's FlightLogger) avoids parsing
+     the whole log book; this program runs just before the power is
+     cut, so it doesn't write anything */
+  const auto index =
+    ReadFlightIndex(Path("/mnt/onboard/XCSoarData/flights.log"),
+                    Path("/mnt/onboard/XCSoarData/cache/flights.idx"));
 
   FlightListRenderer renderer(normal_font, bold_font);
 
-  FlightParser parser(file);
-  FlightInfo flight;
-  while (parser.Read(flight))
+  for (const auto &flight : index.GetFlights())
     renderer.AddFlight(flight);
 
   renderer.Draw(canvas, rc);
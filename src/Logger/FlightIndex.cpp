@@ -0,0 +1,219 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FlightIndex.hpp"
+#include "FlightParser.hpp"
+#include "io/LineReader.hpp"
+#include "io/FileReader.hxx"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "LogFile.hpp"
+
+#include <memory>
+#include <type_traits>
+
+#include <string.h>
+
+static_assert(std::is_trivially_copyable_v<FlightInfo>);
+
+static constexpr uint32_t FLIGHT_INDEX_MAGIC = 0x464c4958; // "FLIX"
+static constexpr uint32_t FLIGHT_INDEX_VERSION = 1;
+
+namespace {
+
+/**
+ * An #NLineReader implementation which splits a buffer into lines
+ * in-place.  Tell() returns the buffer offset after the most
+ * recently returned line.
+ */
+class BufferLineReader final : public NLineReader {
+  char *const begin, *const end;
+  char *position;
+
+public:
+  BufferLineReader(char *_begin, std::size_t size) noexcept
+    :begin(_begin), end(_begin + size), position(_begin) {}
+
+  char *ReadLine() override {
+    if (position == end)
+      return nullptr;
+
+    char *line = position;
+    char *newline = (char *)memchr(line, '\n', end - line);
+    if (newline == nullptr)
+      /* an incomplete line (the writer may not be finished yet);
+         leave it for the next Update() */
+      return nullptr;
+
+    position = newline + 1;
+
+    if (newline > line && newline[-1] == '\r')
+      --newline;
+    *newline = '\0';
+    return line;
+  }
+
+  long GetSize() const override {
+    return end - begin;
+  }
+
+  long Tell() const override {
+    return position - begin;
+  }
+};
+
+} // anonymous namespace
+
+void
+FlightIndex::Load(Path path) noexcept
+try {
+  Clear();
+
+  FileReader file(path);
+  BufferedReader r(file);
+
+  uint32_t magic, version, n;
+  r.ReadFullT(magic);
+  r.ReadFullT(version);
+  if (magic != FLIGHT_INDEX_MAGIC || version != FLIGHT_INDEX_VERSION)
+    return;
+
+  uint64_t _offset;
+  r.ReadFullT(_offset);
+  r.ReadFullT(n);
+
+  std::vector<FlightInfo> _flights(n);
+  r.ReadFull(std::as_writable_bytes(std::span{_flights}));
+
+  flights = std::move(_flights);
+  n_complete = flights.size();
+  offset = _offset;
+} catch (...) {
+  Clear();
+}
+
+void
+FlightIndex::Save(Path path) const
+{
+  Directory::Create(path.GetParent());
+
+  FileOutputStream file(path);
+  BufferedOutputStream os(file);
+
+  os.WriteT(FLIGHT_INDEX_MAGIC);
+  os.WriteT(FLIGHT_INDEX_VERSION);
+  os.WriteT(offset);
+  os.WriteT(uint32_t(n_complete));
+  os.Write(flights.data(), n_complete * sizeof(flights.front()));
+
+  os.Flush();
+
+  /* make sure the new index is on disk before it replaces the old
+     one; the device may be switched off shortly after a landing */
+  file.Sync();
+  file.Commit();
+}
+
+bool
+FlightIndex::Update(Path log_path)
+{
+  FileReader file(log_path);
+
+  const uint64_t size = file.GetSize();
+  const uint64_t old_offset = offset;
+  bool modified = false;
+
+  if (size < offset) {
+    /* the file was truncated or replaced: start over */
+    Clear();
+    modified = true;
+  }
+
+  if (size == offset)
+    return modified;
+
+  /* drop the flights which may be continued by new lines */
+  flights.resize(n_complete);
+
+  const std::size_t tail_size = size - offset;
+  const auto tail = std::make_unique<char[]>(tail_size);
+
+  file.Seek(offset);
+  for (std::size_t fill = 0; fill < tail_size;) {
+    const std::size_t nbytes = file.Read(tail.get() + fill,
+                                         tail_size - fill);
+    if (nbytes == 0)
+      break;
+
+    fill += nbytes;
+  }
+
+  BufferLineReader reader(tail.get(), tail_size);
+  FlightParser parser(reader);
+
+  const uint64_t tail_offset = offset;
+
+  FlightInfo flight;
+  while (parser.Read(flight)) {
+    flights.push_back(flight);
+
+    if (flight.end_time.IsPlausible()) {
+      /* a landing was the last line consumed by the parser (it
+         does not read ahead in this case), so everything up to
+         here is final */
+      n_complete = flights.size();
+      offset = tail_offset + reader.Tell();
+    }
+  }
+
+  return modified || offset != old_offset;
+}
+
+FlightIndex
+LoadFlightIndex(Path log_path, Path index_path)
+{
+  FlightIndex index;
+  index.Load(index_path);
+
+  if (index.Update(log_path)) {
+    try {
+      index.Save(index_path);
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to save flight index");
+    }
+  }
+
+  return index;
+}
+
+FlightIndex
+ReadFlightIndex(Path log_path, Path index_path)
+{
+  FlightIndex index;
+  index.Load(index_path);
+  index.Update(log_path);
+  return index;
+}
@@ -0,0 +1,111 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "FlightInfo.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Path;
+
+/**
+ * A persistent copy of the flights parsed from the file generated by
+ * #FlightLogger.  Since that file only grows, Update() parses just
+ * the lines which were appended since the last call, instead of
+ * reading the whole log book again.
+ */
+class FlightIndex {
+  /**
+   * All flights in chronological order.  The first #n_complete
+   * ones are final; the others may still be modified by lines which
+   * will be appended later (e.g. a landing after a start).
+   */
+  std::vector<FlightInfo> flights;
+
+  std::size_t n_complete = 0;
+
+  /**
+   * The number of bytes of the log file which were parsed into the
+   * first #n_complete flights.
+   */
+  uint64_t offset = 0;
+
+public:
+  const std::vector<FlightInfo> &GetFlights() const noexcept {
+    return flights;
+  }
+
+  void Clear() noexcept {
+    flights.clear();
+    n_complete = 0;
+    offset = 0;
+  }
+
+  /**
+   * Load the index from a file written by Save().  On error (e.g. a
+   * missing file or an unsupported format), the index is cleared.
+   */
+  void Load(Path path) noexcept;
+
+  /**
+   * Write the final flights to a file, creating its directory if
+   * necessary.  The data is flushed to disk before the file replaces
+   * the old one.
+   *
+   * Throws on error.
+   */
+  void Save(Path path) const;
+
+  /**
+   * Parse the lines which were appended to the log file since the
+   * last call.  If the file has become shorter, it is parsed from
+   * the beginning.
+   *
+   * Throws on error.
+   *
+   * @return true if final flights were added (i.e. the index should
+   * be saved)
+   */
+  bool Update(Path log_path);
+};
+
+/**
+ * Load the index, update it from the log file and save it again.
+ * This is called by the writer of the log file.
+ *
+ * Throws on error (but errors while loading or saving the index are
+ * ignored).
+ */
+FlightIndex
+LoadFlightIndex(Path log_path, Path index_path);
+
+/**
+ * Load the index and parse the lines not covered by it, without
+ * writing anything.  This is meant for readers of the log file.
+ *
+ * Throws on error (but errors while loading the index are ignored).
+ */
+FlightIndex
+ReadFlightIndex(Path log_path, Path index_path);
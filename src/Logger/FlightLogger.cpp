@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "FlightLogger.hpp"
+#include "FlightIndex.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "io/FileOutputStream.hxx"
@@ -58,6 +59,17 @@ try {
   LogError(std::current_exception());
 }
 
+void
+FlightLogger::UpdateIndex() noexcept
+try {
+  if (index_path == nullptr)
+    return;
+
+  LoadFlightIndex(path, index_path);
+} catch (...) {
+  LogError(std::current_exception(), "Failed to update flight index");
+}
+
 void
 FlightLogger::TickInternal(const MoreData &basic,
                            const DerivedInfo &calculated)
@@ -87,6 +99,7 @@ FlightLogger::TickInternal(const MoreData &basic,
       seen_flying = false;
 
       LogEvent(landing_time, "landing");
+      UpdateIndex();
 
       landing_time.Clear();
     }
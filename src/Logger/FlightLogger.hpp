@@ -44,6 +44,12 @@ struct DerivedInfo;
 class FlightLogger {
   AllocatedPath path;
 
+  /**
+   * The #FlightIndex file which is updated after each landing; may
+   * be nullptr.
+   */
+  AllocatedPath index_path = nullptr;
+
   TimeStamp last_time;
   bool seen_on_ground, seen_flying;
 
@@ -67,6 +73,14 @@ public:
     path = _path;
   }
 
+  /**
+   * Keep a #FlightIndex of the log file up to date in the given
+   * file.  Call this before Tick().
+   */
+  void SetIndexPath(Path _index_path) {
+    index_path = _index_path;
+  }
+
   void Reset();
 
   /**
@@ -77,5 +91,11 @@ public:
 private:
   void LogEvent(const BrokenDateTime &date_time, const char *type);
 
+  /**
+   * Add the flights which were completed since the last call to the
+   * index file.
+   */
+  void UpdateIndex() noexcept;
+
   void TickInternal(const MoreData &basic, const DerivedInfo &calculated);
 };
@@ -169,24 +169,31 @@ GRecord::AppendGRecordToFile(Path path)
   file.Commit();
 }
 
+/**
+ * Append the payload of a "G" line to the digest read from a file.
+ */
+static void
+AppendGRecordLine(const char *line, char *output, size_t &digest_length,
+                  size_t max_length)
+{
+  for (const char *p = line + 1; *p != '\0'; ++p) {
+    output[digest_length++] = *p;
+    if (digest_length >= max_length)
+      throw std::runtime_error("G record too large");
+  }
+}
+
 void
 GRecord::ReadGRecordFromFile(Path path,
                              char *output, size_t max_length)
 {
   FileLineReaderA reader(path);
 
-  unsigned int digest_length = 0;
+  size_t digest_length = 0;
   char *data;
-  while ((data = reader.ReadLine()) != nullptr) {
-    if (data[0] != 'G')
-      continue;
-
-    for (const char *p = data + 1; *p != '\0'; ++p) {
-      output[digest_length++] = *p;
-      if (digest_length >= max_length)
-        throw std::runtime_error("G record too large");
-    }
-  }
+  while ((data = reader.ReadLine()) != nullptr)
+    if (data[0] == 'G')
+      AppendGRecordLine(data, output, digest_length, max_length);
 
   output[digest_length] = '\0';
 }
@@ -194,13 +201,23 @@ GRecord::ReadGRecordFromFile(Path path,
 void
 GRecord::VerifyGRecordInFile(Path path)
 {
-  // assumes FileName member is set
-  // Load File into Buffer (assume name is already set)
-  LoadFileToBuffer(path);
+  /* read the file only once: hash all other records while
+     collecting the existing digest "old" from the G records */
+  FileLineReaderA reader(path);
 
-  // load Existing Digest "old"
   char old_g_record[DIGEST_LENGTH + 1];
-  ReadGRecordFromFile(path, old_g_record, ARRAY_SIZE(old_g_record));
+  size_t digest_length = 0;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    if (line[0] == 'G')
+      AppendGRecordLine(line, old_g_record, digest_length,
+                        ARRAY_SIZE(old_g_record));
+    else
+      AppendRecordToBuffer(line);
+  }
+
+  old_g_record[digest_length] = '\0';
 
   // recalculate digest from buffer
   FinalizeBuffer();
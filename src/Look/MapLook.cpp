@@ -98,3 +98,20 @@ MapLook::Initialise(const MapSettings &settings,
 
   overlay.Initialise(font, bold_font);
 }
+
+void
+MapLook::PrefetchIcons() const noexcept
+{
+  for (const MaskedIcon *icon : {
+      &waiting_for_fix_icon, &no_gps_icon,
+      &cruise_mode_icon, &climb_mode_icon, &final_glide_mode_icon,
+      &overlay.map_scale_left_icon, &overlay.map_scale_right_icon,
+      &waypoint.small_icon, &waypoint.turn_point_icon,
+      &waypoint.task_turn_point_icon,
+      &waypoint.airport_reachable_icon, &waypoint.airport_unreachable_icon,
+      &waypoint.airport_marginal_icon,
+      &waypoint.field_reachable_icon, &waypoint.field_unreachable_icon,
+      &waypoint.field_marginal_icon,
+    })
+    icon->Prefetch();
+}
@@ -95,4 +95,10 @@ struct MapLook {
 
   void Initialise(const MapSettings &settings,
                   const Font &font, const Font &bold_font);
+
+  /**
+   * Decode the icons which the first map frame is likely to need in
+   * the background (see MaskedIcon::Prefetch()).
+   */
+  void PrefetchIcons() const noexcept;
 };
@@ -103,9 +103,14 @@ MapItemListBuilder::AddSelfIfNear(const GeoPoint &self, Angle bearing)
 void
 MapItemListBuilder::AddWaypoints(const Waypoints &waypoints)
 {
-  waypoints.VisitWithinRange(location, range, [&list=list](const auto &w){
-    if (!list.full())
-      list.append(new WaypointMapItem(w));
+  /* nearest first, so the list contains the closest waypoints if it
+     overflows */
+  waypoints.VisitNearest(location, range, nullptr, [&list=list](const auto &w){
+    if (list.full())
+      return false;
+
+    list.append(new WaypointMapItem(w));
+    return true;
   });
 }
 
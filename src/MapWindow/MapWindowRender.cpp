@@ -182,9 +182,6 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
 {
   const NMEAInfo &basic = Basic();
 
-  // reset label over-write preventer
-  label_block.reset();
-
   render_projection = visible_projection;
 
   if (!render_projection.IsValid()) {
@@ -192,6 +189,9 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
     return;
   }
 
+  // reset label over-write preventer
+  label_block.reset(render_projection.GetScale());
+
   // Calculate screen position of the aircraft
   PixelPoint aircraft_pos{0,0};
   if (basic.location_available)
@@ -203,7 +203,7 @@ TargetMapWindow::OnPaintBuffer(Canvas &canvas) noexcept
   const auto aircraft_pos = projection.GeoToScreen(Basic().location);
 
   // reset label over-write preventer
-  label_block.reset();
+  label_block.reset(projection.GetScale());
 
   // Render terrain, groundline and topography
   RenderTerrain(canvas);
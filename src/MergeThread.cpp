@@ -74,6 +74,7 @@ MergeThread::Tick() noexcept
 #ifdef HAVE_PCM_PLAYER
   bool vario_available;
   double vario;
+  int vario_source;
 #endif
 
   {
@@ -99,6 +100,7 @@ MergeThread::Tick() noexcept
 #ifdef HAVE_PCM_PLAYER
     vario_available = basic.brutto_vario_available;
     vario = vario_available ? basic.brutto_vario : 0;
+    vario_source = device_blackboard.GetVarioSource();
 #endif
 
     /* update last_any in every iteration */
@@ -113,7 +115,7 @@ MergeThread::Tick() noexcept
 
 #ifdef HAVE_PCM_PLAYER
   if (vario_available)
-    AudioVarioGlue::SetValue(vario);
+    AudioVarioGlue::SetValue(vario, vario_source);
   else
     AudioVarioGlue::NoValue();
 #endif
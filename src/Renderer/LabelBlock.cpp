@@ -23,41 +23,91 @@ Copyright_License {
 
 #include "LabelBlock.hpp"
 
-inline bool
-LabelBlock::Bucket::Check(const PixelRect rc) const noexcept
+#include <algorithm>
+#include <cmath>
+
+/**
+ * If the scale changes by more than this factor between two frames,
+ * the previous placement is discarded.
+ */
+static constexpr double MAX_COHERENT_SCALE_CHANGE = 1.1;
+
+/**
+ * Invoke the function for the hash bucket of each cell touched by
+ * the rectangle.
+ */
+template<typename F>
+static inline bool
+ForEachCell(const PixelRect rc, unsigned shift, F &&f) noexcept
 {
-  for (auto i = blocks.begin(), end = blocks.end(); i != end; ++i)
-    if (i->OverlapsWith(rc))
-      return false;
+  const int left = rc.left >> shift, right = rc.right >> shift;
+  const int top = rc.top >> shift, bottom = rc.bottom >> shift;
+
+  for (int y = top; y <= bottom; ++y)
+    for (int x = left; x <= right; ++x)
+      if (!f(x, y))
+        return false;
 
   return true;
 }
 
+inline bool
+LabelBlock::Overlaps(const PixelRect rc) const noexcept
+{
+  return !ForEachCell(rc, CELL_SHIFT, [this, rc](int x, int y){
+    for (const unsigned i : buckets[Hash(x, y)])
+      if (rects[i].OverlapsWith(rc))
+        return false;
+    return true;
+  });
+}
+
+inline void
+LabelBlock::Add(const PixelRect rc) noexcept
+{
+  const unsigned index = rects.size();
+  rects.push_back(rc);
+
+  ForEachCell(rc, CELL_SHIFT, [this, index](int x, int y){
+    auto &bucket = buckets[Hash(x, y)];
+    /* two cells of this rectangle may share a bucket */
+    if (bucket.empty() || bucket.back() != index)
+      bucket.push_back(index);
+    return true;
+  });
+}
+
 void
-LabelBlock::reset() noexcept
+LabelBlock::reset(double new_scale) noexcept
 {
+  rects.clear();
   for (auto &i : buckets)
-    i.Clear();
+    i.clear();
+
+  if (new_scale > 0 && scale > 0 &&
+      std::max(new_scale, scale) <=
+      std::min(new_scale, scale) * MAX_COHERENT_SCALE_CHANGE) {
+    previous.swap(current);
+    std::sort(previous.begin(), previous.end());
+  } else
+    previous.clear();
+
+  current.clear();
+  scale = new_scale;
 }
 
 bool
 LabelBlock::check(const PixelRect rc) noexcept
 {
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
-
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
-
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
-
-  if (top < bottom && !buckets[top].Check(rc))
+  if (Overlaps(rc))
     return false;
 
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
-
+  Add(rc);
   return true;
 }
+
+bool
+LabelBlock::WasPlaced(uint32_t id) const noexcept
+{
+  return std::binary_search(previous.begin(), previous.end(), id);
+}
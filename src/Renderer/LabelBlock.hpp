@@ -24,43 +24,101 @@ Copyright_License {
 #pragma once
 
 #include "ui/dim/Rect.hpp"
-#include "util/StaticArray.hxx"
+
+#include <array>
+#include <cstdint>
+#include <vector>
 
 /**
  * Simple code to prevent text writing over map city names.
+ *
+ * All accepted rectangles are stored in a spatial hash of square
+ * cells, so a hit test only looks at the labels near the new one,
+ * and there is no upper limit for the number of labels.
+ *
+ * In addition, this class remembers which labels (identified by an
+ * arbitrary caller-defined id) were placed in the previous frame.
+ * Renderers may prefer those to avoid labels flickering while the
+ * map moves.
  */
 class LabelBlock {
-  static constexpr unsigned SCREEN_HEIGHT = 4096;
-  static constexpr unsigned BUCKET_SIZE = 64;
-  static constexpr unsigned BUCKET_SHIFT = 7;
-  static constexpr unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static constexpr unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
+  static constexpr unsigned CELL_SHIFT = 6;
+  static constexpr unsigned BUCKET_COUNT = 256;
 
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * All rectangles accepted since the last reset().
    */
-  class Bucket {
-    typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
-    BlockArray blocks;
+  std::vector<PixelRect> rects;
 
-  public:
-    void Clear() noexcept {
-      blocks.clear();
-    }
+  /**
+   * Each bucket contains the indices of all #rects touching one of
+   * the cells hashed to it.  The vectors are cleared in reset(),
+   * but they keep their capacity for the next frame.
+   */
+  std::array<std::vector<unsigned>, BUCKET_COUNT> buckets;
 
-    [[gnu::pure]]
-    bool Check(const PixelRect rc) const noexcept;
+  /**
+   * Sorted ids of labels placed in the previous frame.
+   */
+  std::vector<uint32_t> previous;
 
-    void Add(const PixelRect rc) noexcept {
-      if (!blocks.full())
-        blocks.append(rc);
-    }
-  };
+  /**
+   * Ids of labels placed in the current frame (unsorted).
+   */
+  std::vector<uint32_t> current;
 
-  Bucket buckets[BUCKET_COUNT];
+  /**
+   * The map scale [px/m] of the current frame; 0 if unknown.
+   */
+  double scale = 0;
+
+  static constexpr unsigned Hash(int x, int y) noexcept {
+    return (unsigned(x) * 73856093u ^ unsigned(y) * 19349663u)
+      % BUCKET_COUNT;
+  }
+
+  [[gnu::pure]]
+  bool Overlaps(const PixelRect rc) const noexcept;
+
+  void Add(const PixelRect rc) noexcept;
 
 public:
+  /**
+   * Attempt to reserve the given rectangle.
+   *
+   * @return true if the rectangle was free (it is now occupied),
+   * false if it overlaps with a label placed earlier in this frame
+   */
   bool check(const PixelRect rc) noexcept;
-  void reset() noexcept;
+
+  /**
+   * Start a new frame, and forget the previous placement.
+   */
+  void reset() noexcept {
+    reset(0);
+  }
+
+  /**
+   * Start a new frame.  The placement of the previous frame is
+   * kept only if the map scale has changed just a little; after
+   * zooming, the old placement has no value.
+   *
+   * @param new_scale the map scale [px/m] of the new frame; 0
+   * disables temporal coherence
+   */
+  void reset(double new_scale) noexcept;
+
+  /**
+   * Remember that the label with the given id has been placed in
+   * this frame.
+   */
+  void Remember(uint32_t id) noexcept {
+    current.push_back(id);
+  }
+
+  /**
+   * Was the label with the given id placed in the previous frame?
+   */
+  [[gnu::pure]]
+  bool WasPlaced(uint32_t id) const noexcept;
 };
@@ -22,51 +22,35 @@ Copyright_License {
 */
 
 #include "WaypointLabelList.hpp"
+#include "LabelBlock.hpp"
 #include "util/StringUtil.hpp"
 #include "util/Macros.hpp"
 
 #include <algorithm>
 
-[[gnu::pure]]
-static bool
-MapWaypointLabelListCompare(const WaypointLabelList::Label &e1,
-                            const WaypointLabelList::Label &e2) noexcept
-{
-  if (e1.inTask && !e2.inTask)
-    return true;
-
-  if (!e1.inTask && e2.inTask)
-    return false;
-
-  if (e1.isAirport && !e2.isAirport)
-    return true;
-
-  if (!e1.isAirport && e2.isAirport)
-    return false;
-
-  if (e1.isLandable && !e2.isLandable)
-    return true;
+/**
+ * The bit in Label::priority which is set by Sort() for labels placed
+ * in the previous frame.  It ranks below the class bits and above the
+ * arrival altitude.
+ */
+static constexpr uint64_t PLACED_BIT = uint64_t(1) << 32;
 
-  if (!e1.isLandable && e2.isLandable)
-    return false;
-
-  if (e1.isWatchedWaypoint && !e2.isWatchedWaypoint)
-    return true;
-
-  if (!e1.isWatchedWaypoint && e2.isWatchedWaypoint)
-    return false;
-
-  if (e1.AltArivalAGL > e2.AltArivalAGL)
-    return true;
+static constexpr uint64_t
+MakePriority(bool inTask, bool isAirport, bool isLandable,
+             bool isWatchedWaypoint, int AltArivalAGL) noexcept
+{
+  const unsigned cls = (inTask << 3) | (isAirport << 2) |
+    (isLandable << 1) | isWatchedWaypoint;
 
-  if (e1.AltArivalAGL < e2.AltArivalAGL)
-    return false;
+  /* map the signed altitude to an unsigned value with the same
+     order */
+  const uint32_t altitude = uint32_t(AltArivalAGL) ^ 0x80000000u;
 
-  return false;
+  return (uint64_t(cls) << 33) | altitude;
 }
 
 void
-WaypointLabelList::Add(const TCHAR *Name, PixelPoint p,
+WaypointLabelList::Add(uint32_t id, const TCHAR *Name, PixelPoint p,
                        TextInBoxMode Mode, bool bold,
                        int AltArivalAGL, bool inTask,
                        bool isLandable, bool isAirport,
@@ -81,6 +65,9 @@ WaypointLabelList::Add(const TCHAR *Name, PixelPoint p,
   auto &l = labels.append();
 
   CopyString(l.Name, ARRAY_SIZE(l.Name), Name);
+  l.id = id;
+  l.priority = MakePriority(inTask, isAirport, isLandable,
+                            isWatchedWaypoint, AltArivalAGL);
   l.Pos = p;
   l.Mode = Mode;
   l.AltArivalAGL = AltArivalAGL;
@@ -92,8 +79,17 @@ WaypointLabelList::Add(const TCHAR *Name, PixelPoint p,
 }
 
 void
-WaypointLabelList::Sort() noexcept
+WaypointLabelList::Sort(const LabelBlock &label_block) noexcept
 {
+  for (auto &l : labels) {
+    if (label_block.WasPlaced(l.id))
+      l.priority |= PLACED_BIT;
+    else
+      l.priority &= ~PLACED_BIT;
+  }
+
   std::sort(labels.begin(), labels.end(),
-            MapWaypointLabelListCompare);
+            [](const Label &a, const Label &b){
+              return a.priority > b.priority;
+            });
 }
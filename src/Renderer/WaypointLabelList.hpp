@@ -30,14 +30,31 @@ Copyright_License {
 #include "util/StaticArray.hxx"
 #include "Sizes.h" /* for NAME_SIZE */
 
+#include <cstdint>
 #include <tchar.h>
 
+class LabelBlock;
+
 class WaypointLabelList : private NonCopyable {
   static constexpr int WPCIRCLESIZE = 2;
 
 public:
   struct Label{
     TCHAR Name[NAME_SIZE+1];
+
+    /**
+     * An id which identifies this label across frames (the
+     * waypoint id).
+     */
+    uint32_t id;
+
+    /**
+     * The sort key; labels with a higher value are placed first.
+     * It is calculated once by Add(), so Sort() only needs to
+     * compare integers.
+     */
+    uint64_t priority;
+
     PixelPoint Pos;
     TextInBoxMode Mode;
     int AltArivalAGL;
@@ -61,12 +78,18 @@ public:
     clip_rect.right += WPCIRCLESIZE * 2;
   }
 
-  void Add(const TCHAR *name, PixelPoint p,
+  void Add(uint32_t id, const TCHAR *name, PixelPoint p,
            TextInBoxMode Mode, bool bold,
            int AltArivalAGL,
            bool inTask, bool isLandable, bool isAirport,
            bool isWatchedWaypoint) noexcept;
-  void Sort() noexcept;
+  /**
+   * Sort the labels by descending priority.  Within each class
+   * (task, airport, landable, watched), labels which were placed in
+   * the previous frame come first, so the set of visible labels
+   * stays stable while the map moves.
+   */
+  void Sort(const LabelBlock &label_block) noexcept;
 
   auto begin() const noexcept {
     return labels.begin();
@@ -25,6 +25,7 @@ Copyright_License {
 #include "WaypointRendererSettings.hpp"
 #include "WaypointIconRenderer.hpp"
 #include "WaypointLabelList.hpp"
+#include "LabelBlock.hpp"
 #include "Projection/MapWindowProjection.hpp"
 #include "Computer/Settings.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
@@ -367,7 +368,7 @@ protected:
       // make space for the green circle
       sc.x += 5;
 
-    labels.Add(buffer, sc, text_mode, bold,
+    labels.Add(way_point.id, buffer, sc, text_mode, bold,
                vwp.reachable != WaypointReachability::INVALID ? vwp.reach.direct : INT_MIN,
                vwp.in_task, way_point.IsLandable(), way_point.IsAirport(),
                watchedWaypoint);
@@ -465,12 +466,13 @@ MapWaypointLabelRender(Canvas &canvas, PixelSize clip_size,
                        WaypointLabelList &labels,
                        const WaypointLook &look) noexcept
 {
-  labels.Sort();
+  labels.Sort(label_block);
 
   for (const auto &l : labels) {
     canvas.Select(l.bold ? *look.bold_font : *look.font);
 
-    TextInBox(canvas, l.Name, l.Pos, l.Mode, clip_size, &label_block);
+    if (TextInBox(canvas, l.Name, l.Pos, l.Mode, clip_size, &label_block))
+      label_block.Remember(l.id);
   }
 }
 
@@ -61,6 +61,7 @@ Copyright_License {
 #include "Audio/VolumeController.hpp"
 #include "CommandLine.hpp"
 #include "MainWindow.hpp"
+#include "Look/Look.hpp"
 #include "Computer/GlideComputer.hpp"
 #include "Computer/GlideComputerInterface.hpp"
 #include "Computer/Events.hpp"
@@ -105,6 +106,7 @@ Copyright_License {
 #include "Units/Units.hpp"
 #include "Formatter/UserGeoPointFormatter.hpp"
 #include "thread/Debug.hpp"
+#include "thread/TaskScheduler.hpp"
 
 #include "lua/StartFile.hpp"
 #include "lua/Background.hpp"
@@ -118,6 +120,10 @@ Copyright_License {
 #include "DrawThread.hpp"
 #endif
 
+#if !defined(USE_GDI) && !defined(ANDROID)
+#include "ui/canvas/custom/ResourceImageCache.hpp"
+#endif
+
 #ifdef ANDROID
 #include "Android/Main.hpp"
 #include "Android/NativeView.hpp"
@@ -335,6 +341,19 @@ Startup(UI::Display &display)
 
   file_cache = new FileCache(GetCachePath());
 
+#if !defined(USE_GDI) && !defined(ANDROID)
+  /* icons are decoded lazily, i.e. after this point; keep the decoded
+     pixels for the next start */
+  ResourceImageCache::SetDirectory(GetCachePath());
+#endif
+
+  /* while the data files are being loaded, decode the icons of the
+     first map frame in the background */
+  main_window->GetLook().map.PrefetchIcons();
+
+  task_scheduler = new TaskScheduler(TaskScheduler::GetDefaultThreadCount());
+  task_scheduler->Start();
+
   ReadLanguageFile();
 
   InputEvents::readFile();
@@ -394,7 +413,7 @@ Startup(UI::Display &display)
   topography = new TopographyStore();
   {
     SubOperationEnvironment sub_env(operation, 0, 256);
-    LoadConfiguredTopography(*topography, sub_env);
+    LoadConfiguredTopography(*topography, sub_env, file_cache);
   }
 
   // Read the waypoint files
@@ -428,7 +447,7 @@ Startup(UI::Display &display)
   {
     SubOperationEnvironment sub_env(operation, 768, 1024);
     ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-                 sub_env);
+                 sub_env, task_scheduler);
   }
 
   {
@@ -508,6 +527,8 @@ Startup(UI::Display &display)
   if (!is_simulator() && computer_settings.logger.enable_flight_logger) {
     flight_logger = new GlueFlightLogger(live_blackboard);
     flight_logger->SetPath(LocalPath(_T("flights.log")));
+    flight_logger->SetIndexPath(AllocatedPath::Build(GetCachePath(),
+                                                     _T("flights.idx")));
   }
 
   if (computer_settings.logger.enable_nmea_logger)
@@ -643,6 +664,12 @@ Shutdown()
   }
 #endif
 
+  if (task_scheduler != nullptr) {
+    task_scheduler->Stop();
+    delete task_scheduler;
+    task_scheduler = nullptr;
+  }
+
   LogFormat("delete MapWindow");
   main_window->Deinitialise();
 
@@ -731,6 +758,10 @@ Shutdown()
   // Destroy FlarmNet records
   DeinitTrafficGlobals();
 
+#if !defined(USE_GDI) && !defined(ANDROID)
+  ResourceImageCache::SetDirectory(nullptr);
+#endif
+
   delete file_cache;
   file_cache = nullptr;
 
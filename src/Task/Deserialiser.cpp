@@ -32,6 +32,9 @@
 #include "Task/ObservationZones/AnnularSectorZone.hpp"
 #include "Task/Factory/AbstractTaskFactory.hpp"
 #include "XML/DataNode.hpp"
+#include "XML/DataNodeXML.hpp"
+#include "XML/Node.hpp"
+#include "XML/PullParser.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 
 #include <memory>
@@ -313,9 +316,8 @@ GetTaskFactoryType(const ConstDataNode &node)
   return TaskFactoryType::FAI_GENERAL;
 }
 
-void
-LoadTask(OrderedTask &task, const ConstDataNode &node,
-         const Waypoints *waypoints)
+static void
+LoadTaskSettings(OrderedTask &task, const ConstDataNode &node)
 {
   task.Clear();
   task.SetFactory(GetTaskFactoryType(node));
@@ -324,6 +326,13 @@ LoadTask(OrderedTask &task, const ConstDataNode &node,
   OrderedTaskSettings beh = task.GetOrderedTaskSettings();
   Deserialise(beh, node);
   task.SetOrderedTaskSettings(beh);
+}
+
+void
+LoadTask(OrderedTask &task, const ConstDataNode &node,
+         const Waypoints *waypoints)
+{
+  LoadTaskSettings(task, node);
 
   auto &fact = task.GetFactory();
 
@@ -332,3 +341,44 @@ LoadTask(OrderedTask &task, const ConstDataNode &node,
     DeserialiseTaskpoint(fact, *i, waypoints);
   }
 }
+
+void
+LoadTask(OrderedTask &task, XML::PullParser &parser,
+         const Waypoints *waypoints)
+{
+  const unsigned depth = parser.GetDepth();
+
+  {
+    /* the "Task" element without its children */
+    XMLNode task_node = XMLNode::CreateRoot(parser.GetName());
+    for (const auto &[name, value] : parser.GetAttributes())
+      task_node.AddAttribute(name, value);
+
+    LoadTaskSettings(task, ConstDataNodeXML{task_node});
+  }
+
+  auto &fact = task.GetFactory();
+
+  while (true) {
+    switch (parser.Next()) {
+    case XML::PullParser::Event::START_ELEMENT:
+      if (StringIsEqual(parser.GetName(), _T("Point"))) {
+        const XMLNode point = parser.ReadElement();
+        DeserialiseTaskpoint(fact, ConstDataNodeXML{point}, waypoints);
+      } else
+        parser.SkipElement();
+      break;
+
+    case XML::PullParser::Event::TEXT:
+      break;
+
+    case XML::PullParser::Event::END_ELEMENT:
+      if (parser.GetDepth() < depth)
+        return;
+      break;
+
+    case XML::PullParser::Event::END_DOCUMENT:
+      return;
+    }
+  }
+}
@@ -24,7 +24,21 @@
 class ConstDataNode;
 class Waypoints;
 class OrderedTask;
+namespace XML { class PullParser; }
 
 void
 LoadTask(OrderedTask &task, const ConstDataNode &node,
          const Waypoints *waypoints=nullptr);
+
+/**
+ * Load a task from a #XML::PullParser which has just reported the
+ * START_ELEMENT event of the "Task" element.  Unlike the
+ * #ConstDataNode overload, this does not need a tree of the whole
+ * document; only one "Point" element is kept in memory at a time.
+ * Returns after the END_ELEMENT event of the "Task" element.
+ *
+ * Throws on XML syntax error.
+ */
+void
+LoadTask(OrderedTask &task, XML::PullParser &parser,
+         const Waypoints *waypoints=nullptr);
@@ -22,9 +22,8 @@
 
 #include "LoadFile.hpp"
 #include "Deserialiser.hpp"
-#include "XML/Node.hpp"
-#include "XML/DataNodeXML.hpp"
 #include "XML/Parser.hpp"
+#include "XML/PullParser.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
 #include "system/Path.hpp"
 #include "util/StringUtil.hpp"
@@ -38,19 +37,20 @@ std::unique_ptr<OrderedTask>
 LoadTask(Path path, const TaskBehaviour &task_behaviour,
          const Waypoints *waypoints)
 {
-  // Load root node
-  const auto xml_root = XML::ParseFile(path);
-  const ConstDataNodeXML root(xml_root);
+  // Load the file, but parse it without building a tree
+  const auto xml = XML::LoadFile(path);
+  XML::PullParser parser(xml.c_str());
 
   // Check if root node is a <Task> node
-  if (!StringIsEqual(root.GetName(), _T("Task")))
+  if (parser.Next() != XML::PullParser::Event::START_ELEMENT ||
+      !StringIsEqual(parser.GetName(), _T("Task")))
     throw std::runtime_error("Invalid task file");
 
   // Create a blank task
   auto task = std::make_unique<OrderedTask>(task_behaviour);
 
   // Read the task from the XML file
-  LoadTask(*task, root, waypoints);
+  LoadTask(*task, parser, waypoints);
 
   // Return the parsed task
   return task;
@@ -22,7 +22,7 @@ Copyright_License {
 */
 
 #include "ProtectedTaskManager.hpp"
-#include "Task/RoutePlannerGlue.hpp"
+#include "Task/ProtectedRoutePlanner.hpp"
 #include "Engine/Task/TaskManager.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
 #include "Engine/Task/Ordered/Points/OrderedTaskPoint.hpp"
@@ -155,7 +155,7 @@ ProtectedTaskManager::Reset()
 }
 
 void
-ProtectedTaskManager::SetRoutePlanner(const RoutePlannerGlue *_route) {
+ProtectedTaskManager::SetRoutePlanner(const ProtectedRoutePlanner *_route) {
   intersection_test.SetRoute(_route);
 
   ExclusiveLease lease(*this);
@@ -168,7 +168,10 @@ ReachIntersectionTest::Intersects(const AGeoPoint& destination)
   if (!route)
     return false;
 
-  const auto result = route->FindPositiveArrival(destination);
+  /* the reach is calculated by the IdleCalculationThread, so lock
+     the route planner */
+  const ProtectedRoutePlanner::Lease lease(*route);
+  const auto result = lease->FindPositiveArrival(destination);
   if (!result)
     return false;
 
@@ -58,3 +58,26 @@ TaskFile::GetTask(Path path, const TaskBehaviour &task_behaviour,
 
   return file->GetTask(task_behaviour, waypoints, index);
 }
+
+TaskFile::NamedTask::NamedTask(tstring &&_name,
+                               std::unique_ptr<OrderedTask> &&_task) noexcept
+  :name(std::move(_name)), task(std::move(_task)) {}
+
+TaskFile::NamedTask::NamedTask(NamedTask &&) noexcept = default;
+TaskFile::NamedTask::~NamedTask() noexcept = default;
+
+std::vector<TaskFile::NamedTask>
+TaskFile::GetTasks(const TaskBehaviour &task_behaviour,
+                   const Waypoints *waypoints) const
+{
+  auto list = GetList();
+
+  std::vector<NamedTask> result;
+  result.reserve(list.size());
+
+  for (unsigned i = 0; i < list.size(); ++i)
+    result.emplace_back(std::move(list[i]),
+                        GetTask(task_behaviour, waypoints, i));
+
+  return result;
+}
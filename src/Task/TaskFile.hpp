@@ -65,4 +65,27 @@ public:
   virtual std::unique_ptr<OrderedTask> GetTask(const TaskBehaviour &task_behaviour,
                                                const Waypoints *waypoints,
                                                unsigned index) const = 0;
+
+  struct NamedTask {
+    tstring name;
+
+    /**
+     * nullptr if the task could not be loaded
+     */
+    std::unique_ptr<OrderedTask> task;
+
+    NamedTask(tstring &&_name, std::unique_ptr<OrderedTask> &&_task) noexcept;
+    NamedTask(NamedTask &&) noexcept;
+    ~NamedTask() noexcept;
+  };
+
+  /**
+   * Load all tasks of this file, in the order of GetList().  The
+   * default implementation calls GetTask() for each one; formats
+   * which hold many tasks override it to parse the file only once.
+   *
+   * Throws on error.
+   */
+  virtual std::vector<NamedTask> GetTasks(const TaskBehaviour &task_behaviour,
+                                          const Waypoints *waypoints) const;
 };
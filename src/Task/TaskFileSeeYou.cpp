@@ -211,8 +211,10 @@ ParseOZs(SeeYouTurnpointInformation &tp_info, const TCHAR *params[],
  * @param reader.  Points to first line of task after task "Waypoint list" line
  * @param task_info Loads this with CU task options info
  * @param turnpoint_infos Loads this with CU task tp info
+ * @return the line following the details (i.e. the next task line),
+ * or nullptr at the end of the file
  */
-static void
+static TCHAR *
 ParseCUTaskDetails(TLineReader &reader, SeeYouTaskInformation *task_info,
                    SeeYouTurnpointInformation turnpoint_infos[])
 {
@@ -245,6 +247,8 @@ ParseCUTaskDetails(TLineReader &reader, SeeYouTaskInformation *task_info,
         task_info->max_start_altitude = turnpoint_infos[TPIndex].max_altitude;
     }
   } // end while
+
+  return line;
 }
 
 static bool isKeyhole(const SeeYouTurnpointInformation &turnpoint_infos)
@@ -455,29 +459,54 @@ AdvanceReaderToTask(TLineReader &reader, const unsigned index)
   return line;
 }
 
-std::unique_ptr<OrderedTask>
-TaskFileSeeYou::GetTask(const TaskBehaviour &task_behaviour,
-                        const Waypoints *waypoints, unsigned index) const
-try {
-  // Create FileReader for reading the task
-  FileLineReader reader(path, Charset::AUTO);
+/**
+ * Look up a waypoint from the task file in the waypoint database;
+ * fall back to the task file's waypoint if it is not there.
+ *
+ * @param waypoints the waypoint database; may be nullptr
+ */
+static WaypointPtr
+ResolveWaypoint(const Waypoints *waypoints, WaypointPtr &&file_wp)
+{
+  if (waypoints == nullptr)
+    return std::move(file_wp);
 
-  // Read waypoints from the CUP file
-  Waypoints file_waypoints;
-  {
-    const WaypointFactory factory(WaypointOrigin::NONE);
-    WaypointReaderSeeYou waypoint_file(factory);
-    NullOperationEnvironment operation;
-    waypoint_file.Parse(file_waypoints, reader, operation);
-  }
-  file_waypoints.Optimise();
+  // Try to find waypoint by name
+  auto wp = waypoints->LookupName(file_wp->name);
 
-  reader.Rewind();
+  // If waypoint by name found and closer than 10m to the original
+  if (wp != nullptr &&
+      wp->location.DistanceS(file_wp->location) <= 10)
+    // Use this waypoint for the task
+    return wp;
 
-  TCHAR *line = AdvanceReaderToTask(reader, index);
-  if (line == nullptr)
-    return nullptr;
+  // Try finding the closest waypoint to the original one
+  wp = waypoints->GetNearest(file_wp->location, 10);
+
+  // If closest waypoint found and closer than 10m to the original
+  if (wp != nullptr &&
+      wp->location.DistanceS(file_wp->location) <= 10)
+    // Use this waypoint for the task
+    return wp;
+
+  // Use the original waypoint
+  return std::move(file_wp);
+}
 
+/**
+ * Parse one task: its waypoint list line and the following detail
+ * lines.
+ *
+ * @param line the waypoint list line
+ * @param next_line receives the line following the task (see
+ * ParseCUTaskDetails())
+ * @return the task or nullptr if it is malformed
+ */
+static std::unique_ptr<OrderedTask>
+ParseTask(TLineReader &reader, const TCHAR *line,
+          const Waypoints &file_waypoints, const Waypoints *waypoints,
+          const TaskBehaviour &task_behaviour, TCHAR *&next_line)
+{
   // Read waypoint list
   // e.g. "Club day 4 Racing task","085PRI","083BOJ","170D_K","065SKY","0844YY", "0844YY"
   //       TASK NAME              , TAKEOFF, START  , TP1    , TP2    , FINISH ,  LANDING
@@ -486,6 +515,12 @@ try {
   size_t n_waypoints = ExtractParameters(line, waypoints_buffer, wps, CUP_MAX_TPS,
                                          true, _T('"'));
 
+  SeeYouTaskInformation task_info;
+  SeeYouTurnpointInformation turnpoint_infos[CUP_MAX_TPS];
+  WaypointPtr waypoints_in_task[CUP_MAX_TPS];
+
+  next_line = ParseCUTaskDetails(reader, &task_info, turnpoint_infos);
+
   // Some versions of StrePla append a trailing ',' without a following
   // WP name resulting an empty last entry. Remove it from the results
   if (n_waypoints > 0 && wps[n_waypoints - 1][0] == _T('\0'))
@@ -498,12 +533,6 @@ try {
   // Remove taskname, start point and landing point from count
   n_waypoints -= 3;
 
-  SeeYouTaskInformation task_info;
-  SeeYouTurnpointInformation turnpoint_infos[CUP_MAX_TPS];
-  WaypointPtr waypoints_in_task[CUP_MAX_TPS];
-
-  ParseCUTaskDetails(reader, &task_info, turnpoint_infos);
-
   auto task = std::make_unique<OrderedTask>(task_behaviour);
   task->SetFactory(task_info.wp_dis ?
                     TaskFactoryType::RACING : TaskFactoryType::AAT);
@@ -527,30 +556,7 @@ try {
     if (file_wp == nullptr)
       return nullptr;
 
-    // Try to find waypoint by name
-    auto wp = waypoints->LookupName(file_wp->name);
-
-    // If waypoint by name found and closer than 10m to the original
-    if (wp != nullptr &&
-        wp->location.DistanceS(file_wp->location) <= 10) {
-      // Use this waypoint for the task
-      waypoints_in_task[i] = wp;
-      continue;
-    }
-
-    // Try finding the closest waypoint to the original one
-    wp = waypoints->GetNearest(file_wp->location, 10);
-
-    // If closest waypoint found and closer than 10m to the original
-    if (wp != nullptr &&
-        wp->location.DistanceS(file_wp->location) <= 10) {
-      // Use this waypoint for the task
-      waypoints_in_task[i] = wp;
-      continue;
-    }
-
-    // Use the original waypoint
-    waypoints_in_task[i] = file_wp;
+    waypoints_in_task[i] = ResolveWaypoint(waypoints, std::move(file_wp));
   }
 
   //now create TPs and OZs
@@ -567,10 +573,108 @@ try {
       fact.Append(*pt, false);
   }
   return task;
+}
+
+/**
+ * Read the waypoints from the CUP file.
+ */
+static void
+ReadFileWaypoints(FileLineReader &reader, Waypoints &file_waypoints)
+{
+  {
+    const WaypointFactory factory(WaypointOrigin::NONE);
+    WaypointReaderSeeYou waypoint_file(factory);
+    NullOperationEnvironment operation;
+    waypoint_file.Parse(file_waypoints, reader, operation);
+  }
+  file_waypoints.Optimise();
+
+  reader.Rewind();
+}
+
+static bool
+IsTaskLine(const TCHAR *line) noexcept
+{
+  // If the line starts with a string or "nothing" followed
+  // by a comma it is a new task definition line
+  return line[0] == _T('\"') || line[0] == _T(',');
+}
+
+static tstring
+ParseTaskName(const TCHAR *line)
+{
+  // If the task doesn't have a name inside the file
+  if (line[0] == _T(','))
+    return {};
+
+  // Ignore starting quote (")
+  ++line;
+
+  // Take characters until next quote (") or end of string
+  const TCHAR *end = line;
+  while (end[0] != _T('\"') && end[0] != _T('\0'))
+    ++end;
+
+  return tstring(line, end);
+}
+
+std::unique_ptr<OrderedTask>
+TaskFileSeeYou::GetTask(const TaskBehaviour &task_behaviour,
+                        const Waypoints *waypoints, unsigned index) const
+try {
+  // Create FileReader for reading the task
+  FileLineReader reader(path, Charset::AUTO);
+
+  Waypoints file_waypoints;
+  ReadFileWaypoints(reader, file_waypoints);
+
+  TCHAR *line = AdvanceReaderToTask(reader, index);
+  if (line == nullptr)
+    return nullptr;
+
+  TCHAR *next_line;
+  return ParseTask(reader, line, file_waypoints, waypoints,
+                   task_behaviour, next_line);
 } catch (...) {
   return nullptr;
 }
 
+std::vector<TaskFile::NamedTask>
+TaskFileSeeYou::GetTasks(const TaskBehaviour &task_behaviour,
+                         const Waypoints *waypoints) const
+{
+  std::vector<NamedTask> result;
+
+  FileLineReader reader(path, Charset::AUTO);
+
+  Waypoints file_waypoints;
+  ReadFileWaypoints(reader, file_waypoints);
+
+  // Skip to the task section
+  TCHAR *line;
+  while ((line = reader.ReadLine()) != nullptr &&
+         !StringIsEqualIgnoreCase(line, _T("-----Related Tasks-----"))) {}
+
+  if (line != nullptr)
+    line = reader.ReadLine();
+
+  while (line != nullptr) {
+    if (!IsTaskLine(line)) {
+      line = reader.ReadLine();
+      continue;
+    }
+
+    auto name = ParseTaskName(line);
+    TCHAR *next_line;
+    auto task = ParseTask(reader, line, file_waypoints, waypoints,
+                          task_behaviour, next_line);
+    result.emplace_back(std::move(name), std::move(task));
+    line = next_line;
+  }
+
+  return result;
+}
+
 std::vector<tstring>
 TaskFileSeeYou::GetList() const
 {
@@ -583,29 +687,8 @@ TaskFileSeeYou::GetList() const
   TCHAR *line;
   while ((line = reader.ReadLine()) != nullptr) {
     if (in_task_section) {
-      // If the line starts with a string or "nothing" followed
-      // by a comma it is a new task definition line
-      if (line[0] == _T('\"') || line[0] == _T(',')) {
-        // If the task doesn't have a name inside the file
-        if (line[0] == _T(','))
-          result.emplace_back();
-        else {
-          // Ignore starting quote (")
-          line++;
-
-          // Save pointer to first character
-          TCHAR *name = line;
-          // Skip characters until next quote (") or end of string
-          while (line[0] != _T('\"') && line[0] != _T('\0'))
-            line++;
-
-          // Replace quote (") by end of string (null)
-          line[0] = _T('\0');
-
-          // Append task name to the list
-          result.emplace_back(name);
-        }
-      }
+      if (IsTaskLine(line))
+        result.emplace_back(ParseTaskName(line));
     } else if (StringIsEqualIgnoreCase(line, _T("-----Related Tasks-----"))) {
       // Found the marker -> all following lines are task lines
       in_task_section = true;
@@ -38,4 +38,6 @@ public:
   std::unique_ptr<OrderedTask> GetTask(const TaskBehaviour &task_behaviour,
                                        const Waypoints *waypoints,
                                        unsigned index) const override;
+  std::vector<NamedTask> GetTasks(const TaskBehaviour &task_behaviour,
+                                  const Waypoints *waypoints) const override;
 };
@@ -0,0 +1,270 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TaskIndex.hpp"
+#include "TaskFile.hpp"
+#include "Serialiser.hpp"
+#include "Deserialiser.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Task/Ordered/Points/OrderedTaskPoint.hpp"
+#include "XML/Node.hpp"
+#include "XML/DataNodeXML.hpp"
+#include "XML/PullParser.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/Reader.hxx"
+#include "io/StringOutputStream.hxx"
+#include "system/Path.hpp"
+#include "util/ConvertString.hpp"
+#include "util/StaticString.hxx"
+#include "util/StringAPI.hxx"
+#include "util/tstring_view.hxx"
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+/**
+ * Increment this when the file format changes.
+ */
+static constexpr uint32_t TASK_INDEX_VERSION = 2;
+
+/**
+ * Each task file gets its own cache file; its name is derived from
+ * a hash of the task file's path.
+ */
+static StaticString<32>
+MakeCacheName(Path path) noexcept
+{
+  const std::size_t hash = std::hash<tstring_view>{}(path.c_str());
+
+  StaticString<32> name;
+  name.Format(_T("task-%016llx"), (unsigned long long)hash);
+  return name;
+}
+
+static std::string
+SerialiseTask(const OrderedTask &task) noexcept
+{
+  XMLNode root_node = XMLNode::CreateRoot(_T("Task"));
+
+  {
+    WritableDataNodeXML root(root_node);
+    SaveTask(root, task);
+  }
+
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  root_node.Serialise(bos, false);
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+static TaskIndexEntry
+MakeEntry(tstring &&name, const OrderedTask *task) noexcept
+{
+  TaskIndexEntry entry;
+  entry.name = std::move(name);
+
+  if (task == nullptr || task->TaskSize() == 0)
+    return entry;
+
+  entry.n_points = task->TaskSize();
+  entry.type = task->GetFactoryType();
+  entry.distance_nominal = task->GetStats().distance_nominal;
+
+  entry.bounds = GeoBounds(task->GetPoint(0).GetLocation());
+  for (unsigned i = 1; i < entry.n_points; ++i)
+    entry.bounds.Extend(task->GetPoint(i).GetLocation());
+
+  entry.xml = SerialiseTask(*task);
+  return entry;
+}
+
+TaskIndex
+BuildTaskIndex(Path path, const TaskBehaviour &task_behaviour)
+{
+  const auto file = TaskFile::Create(path);
+  if (!file)
+    throw std::runtime_error("Unsupported task file");
+
+  auto tasks = file->GetTasks(task_behaviour, nullptr);
+
+  TaskIndex index;
+  index.reserve(tasks.size());
+
+  for (auto &i : tasks) {
+    if (i.task != nullptr)
+      i.task->UpdateGeometry();
+
+    index.emplace_back(MakeEntry(std::move(i.name), i.task.get()));
+  }
+
+  return index;
+}
+
+template<typename T>
+static void
+ReadValue(BufferedReader &r, T &value)
+{
+  r.ReadFullT(value);
+}
+
+static TaskIndex
+ReadTaskIndex(Reader &reader)
+{
+  BufferedReader r(reader);
+
+  uint32_t version, n;
+  ReadValue(r, version);
+  if (version != TASK_INDEX_VERSION)
+    throw std::runtime_error("Wrong task index version");
+
+  ReadValue(r, n);
+
+  TaskIndex index(n);
+  for (auto &i : index) {
+    uint32_t name_length;
+    ReadValue(r, name_length);
+    i.name.resize(name_length);
+    r.ReadFull(std::as_writable_bytes(std::span{i.name}));
+
+    ReadValue(r, i.n_points);
+    ReadValue(r, i.type);
+    ReadValue(r, i.distance_nominal);
+    ReadValue(r, i.bounds);
+
+    uint32_t xml_length;
+    ReadValue(r, xml_length);
+    i.xml.resize(xml_length);
+    r.ReadFull(std::as_writable_bytes(std::span{i.xml}));
+  }
+
+  return index;
+}
+
+static void
+WriteTaskIndex(BufferedOutputStream &os, const TaskIndex &index)
+{
+  os.WriteT(TASK_INDEX_VERSION);
+  os.WriteT(uint32_t(index.size()));
+
+  for (const auto &i : index) {
+    os.WriteT(uint32_t(i.name.size()));
+    os.Write(i.name.data(), i.name.size() * sizeof(i.name.front()));
+
+    os.WriteT(i.n_points);
+    os.WriteT(i.type);
+    os.WriteT(i.distance_nominal);
+    os.WriteT(i.bounds);
+
+    os.WriteT(uint32_t(i.xml.size()));
+    os.Write(i.xml.data(), i.xml.size());
+  }
+}
+
+static void
+SaveTaskIndex(FileCache &cache, const TCHAR *name, Path path,
+              const TaskIndex &index) noexcept
+try {
+  auto os = cache.Save(name, path);
+  BufferedOutputStream bos(*os);
+  WriteTaskIndex(bos, index);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save task index");
+}
+
+/**
+ * Like BuildTaskIndex(), but return one invalid entry instead of
+ * throwing.
+ */
+static TaskIndex
+TryBuildTaskIndex(Path path, const TaskBehaviour &task_behaviour) noexcept
+try {
+  return BuildTaskIndex(path, task_behaviour);
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load task file");
+  return TaskIndex(1);
+}
+
+TaskIndex
+LoadTaskIndex(FileCache *cache, Path path,
+              const TaskBehaviour &task_behaviour) noexcept
+{
+  if (cache == nullptr)
+    return TryBuildTaskIndex(path, task_behaviour);
+
+  const auto name = MakeCacheName(path);
+
+  if (auto reader = cache->Load(name, path)) {
+    try {
+      return ReadTaskIndex(*reader);
+    } catch (...) {
+      /* corrupt cache file: build a new one */
+    }
+  }
+
+  auto index = TryBuildTaskIndex(path, task_behaviour);
+  SaveTaskIndex(*cache, name, path, index);
+  return index;
+}
+
+std::unique_ptr<OrderedTask>
+LoadIndexedTask(const TaskIndexEntry &entry,
+                const TaskBehaviour &task_behaviour,
+                const Waypoints *waypoints)
+{
+  if (entry.xml.empty())
+    throw std::runtime_error("Task could not be loaded");
+
+  const UTF8ToWideConverter xml(entry.xml.c_str());
+  if (!xml.IsValid())
+    throw std::runtime_error("Invalid task index");
+
+  XML::PullParser parser(xml.c_str());
+  if (parser.Next() != XML::PullParser::Event::START_ELEMENT ||
+      !StringIsEqual(parser.GetName(), _T("Task")))
+    throw std::runtime_error("Invalid task index");
+
+  auto task = std::make_unique<OrderedTask>(task_behaviour);
+  LoadTask(*task, parser, waypoints);
+  return task;
+}
+
+void
+PruneTaskIndexes(FileCache &cache, std::span<const Path> paths)
+{
+  std::vector<tstring> keep;
+  keep.reserve(paths.size());
+  for (const auto path : paths)
+    keep.emplace_back(MakeCacheName(path).c_str());
+
+  std::sort(keep.begin(), keep.end());
+
+  cache.Prune(_T("task-*"), keep);
+}
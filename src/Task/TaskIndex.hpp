@@ -0,0 +1,123 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "Geo/GeoBounds.hpp"
+#include "system/Path.hpp"
+#include "util/tstring.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class TaskFactoryType : uint8_t;
+struct TaskBehaviour;
+class FileCache;
+class OrderedTask;
+class Waypoints;
+
+/**
+ * A compact description of one task inside a task file, which allows
+ * listing tasks without parsing their files again.
+ */
+struct TaskIndexEntry {
+  /**
+   * The name of the task inside the file; may be empty.
+   */
+  tstring name;
+
+  /**
+   * The number of task points, or 0 if the task could not be loaded.
+   */
+  unsigned n_points = 0;
+
+  TaskFactoryType type{};
+
+  /**
+   * The nominal task distance [m].
+   */
+  double distance_nominal = 0;
+
+  GeoBounds bounds = GeoBounds::Invalid();
+
+  /**
+   * The whole task in the XCSoar task file format (UTF-8), for
+   * LoadIndexedTask().  Empty if the task could not be loaded.
+   */
+  std::string xml;
+
+  bool IsValid() const noexcept {
+    return n_points > 0;
+  }
+};
+
+using TaskIndex = std::vector<TaskIndexEntry>;
+
+/**
+ * Parse all tasks of the specified task file.  Waypoints are not
+ * looked up in the waypoint database, because this may run in a
+ * worker thread.
+ *
+ * Throws on error.
+ */
+TaskIndex
+BuildTaskIndex(Path path, const TaskBehaviour &task_behaviour);
+
+/**
+ * Like BuildTaskIndex(), but use the copy in the #FileCache if the
+ * task file has not been modified since, and update the cache
+ * otherwise.
+ *
+ * A file which cannot be parsed gets an index with one invalid
+ * entry, which is cached as well, so the file is not parsed again
+ * until it gets modified.
+ *
+ * @param cache the cache; may be nullptr
+ */
+TaskIndex
+LoadTaskIndex(FileCache *cache, Path path,
+              const TaskBehaviour &task_behaviour) noexcept;
+
+/**
+ * Create the task described by the #TaskIndexEntry, without parsing
+ * its task file.
+ *
+ * Throws on error.
+ *
+ * @param waypoints the waypoint database for looking up the task
+ * points; may be nullptr
+ */
+std::unique_ptr<OrderedTask>
+LoadIndexedTask(const TaskIndexEntry &entry,
+                const TaskBehaviour &task_behaviour,
+                const Waypoints *waypoints);
+
+/**
+ * Delete the cached indexes of all task files except the specified
+ * ones, i.e. of files which have been deleted or renamed.
+ */
+void
+PruneTaskIndexes(FileCache &cache, std::span<const Path> paths);
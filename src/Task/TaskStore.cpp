@@ -34,72 +34,196 @@ Copyright_License {
 #include <algorithm>
 #include <memory>
 
+/**
+ * A task file found by TaskFileVisitor.
+ */
+struct TaskFileName {
+  AllocatedPath path;
+  tstring base_name;
+
+  /**
+   * Is this an "extra" (non-XCSoar) task file?
+   */
+  bool extra;
+};
+
 class TaskFileVisitor: public File::Visitor
 {
 private:
-  TaskStore::ItemVector &store;
+  std::vector<TaskFileName> &files;
+  bool extra = false;
 
 public:
-  TaskFileVisitor(TaskStore::ItemVector &_store):
-    store(_store) {}
-
-  void Visit(Path path, Path base_name) override
-  try {
-    // Create a TaskFile instance to determine how many
-    // tasks are inside of this task file
-    const auto task_file = TaskFile::Create(path);
-    if (!task_file)
-      return;
-
-    const auto list = task_file->GetList();
-
-    // Count the tasks in the task file
-    unsigned count = list.size();
-    // For each task in the task file
-    for (unsigned i = 0; i < count; i++) {
-      // Copy base name of the file into task name
-      StaticString<256> name(base_name.c_str());
-
-      // If the task file holds more than one task
-      const auto &saved_name = list[i];
-      if (!saved_name.empty()) {
-        name += _T(": ");
-        name += saved_name.c_str();
-      } else if (count > 1) {
-        // .. append " - Task #[n]" suffix to the task name
-        name.AppendFormat(_T(": %s #%d"), _("Task"), i + 1);
-      }
+  TaskFileVisitor(std::vector<TaskFileName> &_files):
+    files(_files) {}
 
-      // Add the task to the TaskStore
-      store.emplace_back(path, name.empty() ? path.c_str() : name, i);
-    }
-  } catch (...) {
-    LogError(std::current_exception());
+  void SetExtra(bool _extra) noexcept {
+    extra = _extra;
+  }
+
+  void Visit(Path path, Path base_name) override {
+    files.push_back({path, base_name.c_str(), extra});
   }
 };
 
+/**
+ * List all task files, including the "extra" ones.
+ */
+static std::vector<TaskFileName>
+ListTaskFiles() noexcept
+{
+  std::vector<TaskFileName> files;
+  TaskFileVisitor tfv(files);
+  VisitDataFiles(_T("*.tsk"), tfv);
+
+  tfv.SetExtra(true);
+  VisitDataFiles(_T("*.cup"), tfv);
+  VisitDataFiles(_T("*.igc"), tfv);
+  return files;
+}
+
+static void
+AddItems(TaskStore::ItemVector &store, const TaskFileName &file,
+         TaskIndex &&index) noexcept
+{
+  // Count the tasks in the task file
+  const unsigned count = index.size();
+  // For each task in the task file
+  for (unsigned i = 0; i < count; i++) {
+    // Copy base name of the file into task name
+    StaticString<256> name(file.base_name.c_str());
+
+    // If the task file holds more than one task
+    const auto &saved_name = index[i].name;
+    if (!saved_name.empty()) {
+      name += _T(": ");
+      name += saved_name.c_str();
+    } else if (count > 1) {
+      // .. append " - Task #[n]" suffix to the task name
+      name.AppendFormat(_T(": %s #%d"), _("Task"), i + 1);
+    }
+
+    // Add the task to the TaskStore
+    store.emplace_back(file.path,
+                       name.empty() ? file.path.c_str() : name.c_str(),
+                       i, std::move(index[i]));
+  }
+}
+
+TaskStore::TaskStore(std::function<void()> &&_callback) noexcept
+  :StandbyThread("TaskStore"),
+   callback(std::move(_callback)) {}
+
+TaskStore::~TaskStore() noexcept
+{
+  LockStop();
+}
+
 void
 TaskStore::Clear()
 {
+  {
+    const std::lock_guard lock{mutex};
+    rescan = false;
+    incoming.clear();
+  }
+
   // clear entries first
   store.erase(store.begin(), store.end());
 }
 
 void
-TaskStore::Scan(bool extra)
+TaskStore::Scan(const TaskBehaviour &_task_behaviour, bool _extra)
 {
   Clear();
 
-  // scan files
-  TaskFileVisitor tfv(store);
-  VisitDataFiles(_T("*.tsk"), tfv);
+  const std::lock_guard lock{mutex};
+  task_behaviour = _task_behaviour;
+  extra = _extra;
+  rescan = true;
+  Trigger();
+}
+
+bool
+TaskStore::Update() noexcept
+{
+  ItemVector items;
 
-  if (extra) {
-    VisitDataFiles(_T("*.cup"), tfv);
-    VisitDataFiles(_T("*.igc"), tfv);
+  {
+    const std::lock_guard lock{mutex};
+    items.swap(incoming);
   }
 
+  if (items.empty())
+    return false;
+
+  store.insert(store.end(),
+               std::make_move_iterator(items.begin()),
+               std::make_move_iterator(items.end()));
   std::sort(store.begin(), store.end());
+  return true;
+}
+
+void
+TaskStore::Tick() noexcept
+{
+  while (rescan && !IsStopped()) {
+    rescan = false;
+
+    const TaskBehaviour _task_behaviour = task_behaviour;
+    const bool _extra = extra;
+
+    std::vector<TaskFileName> files;
+
+    {
+      const ScopeUnlock unlock(mutex);
+      files = ListTaskFiles();
+    }
+
+    bool complete = true;
+
+    for (const auto &file : files) {
+      if (rescan || IsStopped()) {
+        complete = false;
+        break;
+      }
+
+      if (file.extra && !_extra)
+        continue;
+
+      ItemVector items;
+
+      {
+        const ScopeUnlock unlock(mutex);
+        AddItems(items, file,
+                 LoadTaskIndex(file_cache, file.path, _task_behaviour));
+      }
+
+      if (items.empty() || rescan)
+        continue;
+
+      incoming.insert(incoming.end(),
+                      std::make_move_iterator(items.begin()),
+                      std::make_move_iterator(items.end()));
+
+      if (callback) {
+        const ScopeUnlock unlock(mutex);
+        callback();
+      }
+    }
+
+    if (complete && file_cache != nullptr) {
+      /* all task files are known now; delete the cached indexes of
+         the others */
+      std::vector<Path> paths;
+      paths.reserve(files.size());
+      for (const auto &i : files)
+        paths.emplace_back(i.path);
+
+      const ScopeUnlock unlock(mutex);
+      PruneTaskIndexes(*file_cache, paths);
+    }
+  }
 }
 
 TaskStore::Item::~Item() noexcept = default;
@@ -110,9 +234,13 @@ TaskStore::Item::GetTask(const TaskBehaviour &task_behaviour) noexcept
   if (task != nullptr)
     return task.get();
 
-  if (valid)
-    task = TaskFile::GetTask(filename, task_behaviour,
-                             &way_points, task_index);
+  if (valid && summary.IsValid()) {
+    try {
+      task = LoadIndexedTask(summary, task_behaviour, &way_points);
+    } catch (...) {
+      LogError(std::current_exception());
+    }
+  }
 
   if (task == nullptr)
     valid = false;
@@ -139,3 +267,26 @@ TaskStore::GetTask(unsigned index, const TaskBehaviour &task_behaviour)
 {
   return store[index].GetTask(task_behaviour);
 }
+
+std::unique_ptr<OrderedTask>
+TaskStore::LoadTask(unsigned index,
+                    const TaskBehaviour &task_behaviour) const
+{
+  const auto &item = store[index];
+  auto task = TaskFile::GetTask(item.filename, task_behaviour,
+                                &way_points, item.task_index);
+  if (task != nullptr)
+    task->UpdateGeometry();
+
+  return task;
+}
+
+int
+TaskStore::Find(tstring::const_pointer name) const noexcept
+{
+  for (unsigned i = 0; i < store.size(); ++i)
+    if (store[i].task_name == name)
+      return i;
+
+  return -1;
+}
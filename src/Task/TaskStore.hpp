@@ -23,19 +23,24 @@ Copyright_License {
 
 #pragma once
 
+#include "TaskIndex.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "thread/StandbyThread.hpp"
 #include "system/Path.hpp"
 #include "util/tstring.hpp"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
-struct TaskBehaviour;
 class OrderedTask;
 
 /**
- * Class to load multiple tasks on demand, e.g. for browsing
+ * Class to load multiple tasks on demand, e.g. for browsing.  The
+ * task files are indexed by a thread in the background; the list
+ * fills up as Update() gets called.
  */
-class TaskStore 
+class TaskStore final : StandbyThread
 {
 public:
   struct Item
@@ -44,14 +49,23 @@ public:
     AllocatedPath filename;
     unsigned task_index;
     std::unique_ptr<OrderedTask> task;
+
+    /**
+     * A summary of the task from the #TaskIndex, available without
+     * loading the task.
+     */
+    TaskIndexEntry summary;
+
     bool valid;
 
     Item(Path the_filename,
          tstring::const_pointer _task_name,
-         unsigned _task_index = 0)
+         unsigned _task_index,
+         TaskIndexEntry &&_summary)
       :task_name(_task_name),
        filename(the_filename),
        task_index(_task_index),
+       summary(std::move(_summary)),
        valid(true) {}
 
     ~Item() noexcept;
@@ -69,6 +83,14 @@ public:
       return filename;
     }
 
+    const TaskIndexEntry &GetSummary() const noexcept {
+      return summary;
+    }
+
+    /**
+     * Load the task from the #TaskIndexEntry (without parsing the
+     * task file again).
+     */
     const OrderedTask *GetTask(const TaskBehaviour &task_behaviour) noexcept;
 
     [[gnu::pure]]
@@ -85,17 +107,61 @@ private:
    */
   ItemVector store;
 
+  /**
+   * Called by the indexer thread after it has added items to
+   * #incoming.
+   */
+  const std::function<void()> callback;
+
+  /* the following attributes are protected by StandbyThread::mutex */
+
+  TaskBehaviour task_behaviour;
+
+  /**
+   * Index the "extra" task files?  See Scan().
+   */
+  bool extra;
+
+  /**
+   * Shall the indexer thread (re)start scanning the task files?
+   */
+  bool rescan = false;
+
+  /**
+   * Items which were indexed, but were not yet moved to #store by
+   * Update().
+   */
+  ItemVector incoming;
+
 public:
   /**
-   * Scan the XCSoarData folder for .tsk files and add them to the TaskStore
+   * @param _callback a function which gets called by the indexer
+   * thread when new items are available for Update()
+   */
+  explicit TaskStore(std::function<void()> &&_callback={}) noexcept;
+  ~TaskStore() noexcept;
+
+  /**
+   * Clear the TaskStore and start scanning the XCSoarData folder for
+   * task files in the background.  The files are summarised by the
+   * #TaskIndex, which is cached in the #FileCache until a file gets
+   * modified; the cached indexes of files which are gone get
+   * deleted.
    *
    * @param extra scan all "extra" (non-XCSoar) task files, e.g. *.cup
    * and task declarations from *.igc
    */
-  void Scan(bool extra=false);
+  void Scan(const TaskBehaviour &task_behaviour, bool extra=false);
+
+  /**
+   * Move the items indexed since the last call into the list.
+   *
+   * @return true if the list has been modified
+   */
+  bool Update() noexcept;
 
   /**
-   * Clear all the tasks from the TaskStore
+   * Clear all the tasks from the TaskStore, and cancel the scan.
    */
   void Clear();
 
@@ -126,6 +192,11 @@ public:
   [[gnu::pure]]
   Path GetPath(unsigned index) const;
 
+  [[gnu::pure]]
+  const TaskIndexEntry &GetSummary(unsigned index) const {
+    return store[index].GetSummary();
+  }
+
   /**
    * Return the task defined by the given index
    * @param index TaskStore index of the desired Task
@@ -133,4 +204,26 @@ public:
    */
   const OrderedTask *GetTask(unsigned index,
                              const TaskBehaviour &task_behaviour);
+
+  /**
+   * Load the task defined by the given index from its task file.
+   * Unlike GetTask(), which is meant for previewing, this does not
+   * use the #TaskIndex, whose coordinates have a limited precision.
+   *
+   * @return the new task or nullptr on error
+   */
+  std::unique_ptr<OrderedTask> LoadTask(unsigned index,
+                                        const TaskBehaviour &task_behaviour) const;
+
+  /**
+   * Find the index of the item with the specified task name.
+   *
+   * @return the index or -1 if there is no such item
+   */
+  [[gnu::pure]]
+  int Find(tstring::const_pointer name) const noexcept;
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override;
 };
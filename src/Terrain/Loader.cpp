@@ -250,7 +250,9 @@ LoadJPG2000(jas_stream_t *in, void *loader)
 inline void
 TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
 {
-  const auto in = OpenJasperZzipStream(dir, path);
+  /* the overview scan decodes the whole file sequentially; loading
+     tiles skips most of it */
+  const auto in = OpenJasperZzipStream(dir, path, scan_overview);
   AtScopeExit(in) { jas_stream_close(in); };
   env.SetProgressRange(jas_stream_length(in) / 65536);
   ::LoadJPG2000(in, this);
@@ -25,6 +25,7 @@ Copyright_License {
 #include "Loader.hpp"
 #include "Profile/Profile.hpp"
 #include "io/ZipArchive.hpp"
+#include "io/ZipIndex.hpp"
 #include "io/FileCache.hpp"
 #include "io/FileOutputStream.hxx"
 #include "io/BufferedOutputStream.hxx"
@@ -36,6 +37,7 @@ Copyright_License {
 #include "LogFile.hpp"
 
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_index_cache_name = _T("terrain-index");
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -69,6 +71,14 @@ inline void
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
+  try {
+    /* allow cheap seeking if the JPEG2000 file is deflated */
+    LoadZipIndex(archive, path, "terrain.jp2",
+                 cache, terrain_index_cache_name);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to index terrain");
+  }
+
   try {
     if (LoadCache(cache, path))
       return;
@@ -22,16 +22,43 @@ Copyright_License {
 */
 
 #include "ZzipStream.hpp"
-#include "util/RuntimeError.hxx"
+#include "io/ZipReader.hpp"
+#include "io/ReadAheadReader.hpp"
 
-#include <zzip/util.h>
+#include <memory>
+#include <stdexcept>
+
+#include <stdio.h>
+
+/**
+ * The #jas_stream_obj_t of a stream opened by OpenJasperZzipStream().
+ */
+struct JasperZzipFile {
+  ZipReader reader;
+  ReadAheadReader read_ahead;
+
+  /**
+   * The position of the consumer, which is behind the position of
+   * #reader while reading ahead.
+   */
+  long position = 0;
+
+  JasperZzipFile(struct zzip_dir *dir, const char *path, bool _read_ahead)
+    :reader(dir, path), read_ahead(reader, _read_ahead) {}
+};
 
 static int
 jas_zzip_read(jas_stream_obj_t *obj, char *buf, unsigned cnt)
 {
-  const auto f = (struct zzip_file *)obj;
-
-  return zzip_fread(buf, 1, cnt, f);
+  auto &f = *(JasperZzipFile *)obj;
+
+  try {
+    const std::size_t nbytes = f.read_ahead.Read(buf, cnt);
+    f.position += nbytes;
+    return nbytes;
+  } catch (...) {
+    return -1;
+  }
 }
 
 static int
@@ -43,17 +70,43 @@ jas_zzip_write([[maybe_unused]] jas_stream_obj_t *obj, [[maybe_unused]] const ch
 static long
 jas_zzip_seek(jas_stream_obj_t *obj, long offset, int origin)
 {
-  const auto f = (struct zzip_file *)obj;
+  auto &f = *(JasperZzipFile *)obj;
 
-  return zzip_seek(f, offset, origin);
+  switch (origin) {
+  case SEEK_CUR:
+    offset += f.position;
+    break;
+
+  case SEEK_END:
+    offset += f.reader.GetSize();
+    break;
+  }
+
+  if (offset < 0)
+    return -1;
+
+  /* jas_stream_tell() seeks by 0 bytes; don't discard the data which
+     has been read ahead */
+  if (offset == f.position)
+    return offset;
+
+  f.read_ahead.Reset();
+
+  try {
+    f.reader.Seek(offset);
+  } catch (...) {
+    return -1;
+  }
+
+  f.position = offset;
+  return offset;
 }
 
 static int
 jas_zzip_close(jas_stream_obj_t *obj)
 {
-  const auto f = (struct zzip_file *)obj;
-
-  return zzip_close(f);
+  delete (JasperZzipFile *)obj;
+  return 0;
 }
 
 static constexpr jas_stream_ops_t zzip_stream_ops = {
@@ -64,20 +117,16 @@ static constexpr jas_stream_ops_t zzip_stream_ops = {
 };
 
 jas_stream_t *
-OpenJasperZzipStream(struct zzip_dir *dir, const char *path)
+OpenJasperZzipStream(struct zzip_dir *dir, const char *path, bool read_ahead)
 {
-  const auto f = zzip_open_rb(dir, path);
-  if (f == nullptr)
-    throw FormatRuntimeError("Failed to open '%s' from map file", path);
+  auto f = std::make_unique<JasperZzipFile>(dir, path, read_ahead);
 
   jas_stream_t *stream = jas_stream_create();
-  if (stream == nullptr) {
-    zzip_close(f);
+  if (stream == nullptr)
     throw std::runtime_error("jas_stream_create() failed");
-  }
 
   stream->openmode_ = JAS_STREAM_READ|JAS_STREAM_BINARY;
-  stream->obj_ = f;
+  stream->obj_ = f.release();
   stream->ops_ = const_cast<jas_stream_ops_t *>(&zzip_stream_ops);
 
   /* By default, use full buffering for this type of stream. */
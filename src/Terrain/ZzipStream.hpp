@@ -29,6 +29,10 @@ struct zzip_dir;
 
 /**
  * Throws on error.
+ *
+ * @param read_ahead read the file in a separate thread while it is
+ * being decoded; this helps only if it is read sequentially
  */
 jas_stream_t *
-OpenJasperZzipStream(struct zzip_dir *dir, const char *path);
+OpenJasperZzipStream(struct zzip_dir *dir, const char *path,
+                     bool read_ahead=false);
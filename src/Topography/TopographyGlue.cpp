@@ -29,21 +29,35 @@ Copyright_License {
 #include "Operation/Operation.hpp"
 #include "io/MapFile.hpp"
 #include "io/ZipArchive.hpp"
+#include "io/ZipIndex.hpp"
 #include "io/ZipLineReader.hpp"
 #include "system/Path.hpp"
 
+static const TCHAR *const topography_index_cache_name =
+  _T("topography-index");
+
 /**
  * Load topography from the map file (ZIP), load the other files from
  * the same ZIP file.
  */
 static bool
 LoadConfiguredTopographyZip(TopographyStore &store,
-                            OperationEnvironment &operation)
+                            OperationEnvironment &operation,
+                            FileCache *cache)
 try {
   auto archive = OpenMapFile();
   if (!archive)
     return false;
 
+  try {
+    /* shapefiles are read at random offsets; this must be done
+       before TopographyStore::Load() opens them */
+    LoadZipIndex(*archive, Profile::GetPath(ProfileKeys::MapFile), nullptr,
+                 cache, topography_index_cache_name);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to index topography");
+  }
+
   ZipLineReaderA reader(archive->get(), "topology.tpl");
   store.Load(operation, reader, nullptr, archive->get());
   return true;
@@ -54,10 +68,11 @@ try {
 
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation)
+                         OperationEnvironment &operation,
+                         FileCache *cache)
 {
   LogFormat("Loading Topography File...");
   operation.SetText(_("Loading Topography File..."));
 
-  return LoadConfiguredTopographyZip(store, operation);
+  return LoadConfiguredTopographyZip(store, operation, cache);
 }
@@ -25,7 +25,12 @@ Copyright_License {
 
 class TopographyStore;
 class OperationEnvironment;
+class FileCache;
 
+/**
+ * @param cache an optional #FileCache for the map file's seek index
+ */
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation);
+                         OperationEnvironment &operation,
+                         FileCache *cache=nullptr);
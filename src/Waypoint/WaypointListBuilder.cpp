@@ -26,13 +26,29 @@ Copyright_License {
 #include "WaypointFilter.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 
+static constexpr unsigned MAX_FUZZY_RESULTS = 100;
+
 void
 WaypointListBuilder::Visit(const Waypoints &waypoints) noexcept
 {
   if (filter.distance > 0)
-    waypoints.VisitWithinRange(location, filter.distance, *this);
-  else
+    /* nearest first: the list arrives almost in the order the
+       dialog sorts it */
+    waypoints.VisitNearest(location, filter.distance, nullptr,
+                           [this](const WaypointPtr &waypoint){
+                             (*this)(waypoint);
+                             return true;
+                           });
+  else {
     waypoints.VisitNamePrefix(filter.name, *this);
+
+    /* no name starts with the filter string: fall back to a
+       substring search which tolerates one typing error */
+    if (list.empty() && !filter.name.empty())
+      for (const auto &waypoint : waypoints.SearchName(filter.name, 1,
+                                                       MAX_FUZZY_RESULTS))
+        (*this)(waypoint);
+  }
 }
 
 inline void
@@ -48,6 +48,12 @@ Copyright_License {
 #include "io/async/AsioThread.hpp"
 #include "util/PrintException.hxx"
 
+#ifdef USE_POLL_EVENT
+#include "ui/event/Globals.hpp"
+#include "ui/event/Queue.hpp"
+#include "event/Loop.hxx"
+#endif
+
 #ifdef ENABLE_SDL
 /* this is necessary on Mac OS X, to let libSDL bootstrap Quartz
    before entering our main() */
@@ -89,6 +95,22 @@ static const char *const Usage = "\n"
 #endif
   ;
 
+#ifdef USE_POLL_EVENT
+
+/**
+ * Log "idle" event handlers which block the UI event loop for longer
+ * than the idle budget.
+ */
+static void
+OnSlowIdleEvent(const char *name, Event::Duration duration) noexcept
+{
+  LogFormat("Slow idle event '%s': %u ms",
+            name != nullptr ? name : "unnamed",
+            (unsigned)std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+}
+
+#endif
+
 static int
 Main()
 {
@@ -107,6 +129,11 @@ Main()
   AllowLanguage();
   InitLanguage();
 
+#ifdef USE_POLL_EVENT
+  UI::event_queue->GetEventLoop()
+    .SetIdleReportCallback(BIND_FUNCTION(OnSlowIdleEvent));
+#endif
+
   ScopeGlobalAsioThread global_asio_thread;
   const Net::ScopeInit net_init(asio_thread->GetEventLoop());
 
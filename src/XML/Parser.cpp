@@ -27,6 +27,7 @@
  */
 
 #include "Parser.hpp"
+#include "PullParser.hpp"
 #include "Node.hpp"
 #include "util/CharUtil.hxx"
 #include "util/StringAPI.hxx"
@@ -758,8 +759,8 @@ ParseString(const TCHAR *xml_string)
   return xnode;
 }
 
-static tstring
-ReadTextFile(Path path)
+tstring
+LoadFile(Path path)
 {
   /* auto-detect the character encoding, to be able to parse XCSoar
      6.0 task files */
@@ -797,8 +798,295 @@ ReadTextFile(Path path)
 XMLNode
 ParseFile(Path filename)
 {
-  const auto buffer = ReadTextFile(filename);
+  const auto buffer = LoadFile(filename);
   return ParseString(buffer.c_str());
 }
 
+NextToken
+PullParser::ReadToken() noexcept
+{
+  Parser parser{xml};
+  parser.nIndex = position;
+  const auto token = GetNextToken(&parser);
+  position = parser.nIndex;
+  return token;
+}
+
+void
+PullParser::SetText(tstring_view src)
+{
+  src = {src.data(), StripRight(src.data(), src.size())};
+
+  TCHAR *decoded = FromXMLString(src);
+  if (decoded == nullptr)
+    throw std::runtime_error("Unexpected token found");
+
+  text = decoded;
+  free(decoded);
+}
+
+const TCHAR *
+PullParser::GetAttribute(const TCHAR *_name) const noexcept
+{
+  for (const auto &[key, value] : attributes)
+    if (StringIsEqual(key.c_str(), _name))
+      return value.c_str();
+
+  return nullptr;
+}
+
+bool
+PullParser::ParseStartTag(bool is_declaration)
+{
+  NextToken token = ReadToken();
+  if (token.type != TokenType::TEXT)
+    throw std::runtime_error("Missing start tag name");
+
+  if (is_declaration) {
+    /* skip everything up to the end of the declaration */
+    do {
+      token = ReadToken();
+    } while (token.type != TokenType::CLOSE_TAG &&
+             token.type != TokenType::ERROR);
+    return false;
+  }
+
+  name = token.text;
+  attributes.clear();
+
+  Attrib attrib = Attrib::NAME;
+  tstring attribute_name;
+
+  while (true) {
+    token = ReadToken();
+
+    switch (attrib) {
+    case Attrib::NAME:
+      switch (token.type) {
+      case TokenType::TEXT:
+        attribute_name = token.text;
+        attrib = Attrib::EQUALS;
+        break;
+
+      case TokenType::SHORT_HAND_CLOSE:
+        pending_empty_element = true;
+        [[fallthrough]];
+
+      case TokenType::CLOSE_TAG:
+      case TokenType::ERROR:
+        stack.push_back(name);
+        return true;
+
+      default:
+        throw std::runtime_error("Unexpected token found");
+      }
+      break;
+
+    case Attrib::EQUALS:
+      switch (token.type) {
+      case TokenType::TEXT:
+        /* an attribute without a value */
+        attributes.emplace_back(std::move(attribute_name), tstring{});
+        attribute_name = token.text;
+        break;
+
+      case TokenType::SHORT_HAND_CLOSE:
+        pending_empty_element = true;
+        [[fallthrough]];
+
+      case TokenType::CLOSE_TAG:
+      case TokenType::ERROR:
+        attributes.emplace_back(std::move(attribute_name), tstring{});
+        stack.push_back(name);
+        return true;
+
+      case TokenType::EQUALS:
+        attrib = Attrib::VALUE;
+        break;
+
+      default:
+        throw std::runtime_error("Unexpected token found");
+      }
+      break;
+
+    case Attrib::VALUE:
+      switch (token.type) {
+      case TokenType::QUOTED_TEXT:
+        token.text.remove_prefix(1);
+        token.text.remove_suffix(1);
+        [[fallthrough]];
+
+      case TokenType::TEXT:
+        {
+          TCHAR *value = FromXMLString(token.text);
+          if (value == nullptr)
+            throw std::runtime_error("Unexpected token found");
+
+          attributes.emplace_back(std::move(attribute_name), value);
+          free(value);
+        }
+
+        attrib = Attrib::NAME;
+        break;
+
+      default:
+        throw std::runtime_error("Unexpected token found");
+      }
+      break;
+    }
+  }
+}
+
+PullParser::Event
+PullParser::CloseElement()
+{
+  assert(!end_tag.empty());
+  assert(!stack.empty());
+
+  if (CompareTagName(stack.back().c_str(), end_tag.c_str()))
+    end_tag.clear();
+
+  name = std::move(stack.back());
+  stack.pop_back();
+  return Event::END_ELEMENT;
+}
+
+PullParser::Event
+PullParser::Next()
+{
+  if (pending_empty_element) {
+    pending_empty_element = false;
+    name = std::move(stack.back());
+    stack.pop_back();
+    return Event::END_ELEMENT;
+  }
+
+  if (!end_tag.empty())
+    return CloseElement();
+
+  if (pending_start) {
+    pending_start = false;
+    if (ParseStartTag(pending_declaration))
+      return Event::START_ELEMENT;
+  }
+
+  const TCHAR *text_start = nullptr;
+
+  while (true) {
+    NextToken token = ReadToken();
+
+    switch (token.type) {
+    case TokenType::ERROR:
+      /* end of input; close all elements which are still open (like
+         ParseString() does) */
+      if (!stack.empty()) {
+        name = std::move(stack.back());
+        stack.pop_back();
+        return Event::END_ELEMENT;
+      }
+
+      return Event::END_DOCUMENT;
+
+    case TokenType::TEXT:
+    case TokenType::QUOTED_TEXT:
+    case TokenType::EQUALS:
+      if (text_start == nullptr)
+        text_start = token.text.data();
+      break;
+
+    case TokenType::TAG_START:
+    case TokenType::DECLARATION:
+      if (text_start != nullptr) {
+        /* report the text first, and parse the tag next time */
+        SetText({text_start, std::size_t(token.text.data() - text_start)});
+        pending_start = true;
+        pending_declaration = token.type == TokenType::DECLARATION;
+        return Event::TEXT;
+      }
+
+      if (ParseStartTag(token.type == TokenType::DECLARATION))
+        return Event::START_ELEMENT;
+
+      break;
+
+    case TokenType::TAG_END:
+      {
+        const TCHAR *const tag_start = token.text.data();
+
+        token = ReadToken();
+        if (token.type != TokenType::TEXT ||
+            ReadToken().type != TokenType::CLOSE_TAG)
+          throw std::runtime_error("Missing end tag name");
+
+        end_tag = token.text;
+
+        /* an end tag must close an open element, but it may close
+           unclosed inner elements, too */
+        bool found = false;
+        for (const auto &i : stack)
+          if (CompareTagName(i.c_str(), end_tag.c_str()))
+            found = true;
+
+        if (!found)
+          throw std::runtime_error("Unmatched end tag");
+
+        if (text_start != nullptr) {
+          SetText({text_start, std::size_t(tag_start - text_start)});
+          return Event::TEXT;
+        }
+
+        return CloseElement();
+      }
+
+    case TokenType::CLOSE_TAG:
+    case TokenType::SHORT_HAND_CLOSE:
+      throw std::runtime_error("Unexpected token found");
+    }
+  }
+}
+
+void
+PullParser::SkipElement()
+{
+  const std::size_t depth = stack.size();
+  assert(depth > 0);
+
+  while (stack.size() >= depth)
+    if (Next() == Event::END_DOCUMENT)
+      break;
+}
+
+static void
+ReadElementContents(PullParser &parser, XMLNode &node)
+{
+  for (const auto &[key, value] : parser.GetAttributes())
+    node.AddAttribute(key, value);
+
+  while (true) {
+    switch (parser.Next()) {
+    case PullParser::Event::START_ELEMENT:
+      ReadElementContents(parser, node.AddChild(parser.GetName()));
+      break;
+
+    case PullParser::Event::TEXT:
+      node.AddText(parser.GetText());
+      break;
+
+    case PullParser::Event::END_ELEMENT:
+    case PullParser::Event::END_DOCUMENT:
+      return;
+    }
+  }
+}
+
+XMLNode
+PullParser::ReadElement()
+{
+  assert(!stack.empty());
+
+  XMLNode node = XMLNode::CreateRoot(name.c_str());
+  ReadElementContents(*this, node);
+  return node;
+}
+
 } // namespace XML
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include "util/tstring.hpp"
+
 #include <tchar.h>
 
 class XMLNode;
@@ -45,4 +47,12 @@ XMLNode ParseString(const TCHAR *xml_string);
  */
 XMLNode ParseFile(Path path);
 
+/**
+ * Load a whole XML file into a string, auto-detecting its character
+ * set, e.g. for #PullParser.
+ *
+ * Throws on error.
+ */
+tstring LoadFile(Path path);
+
 } // namespace XML
@@ -0,0 +1,194 @@
+/**
+ ****************************************************************************
+ * <P> XML.c - implementation file for basic XML parser written in ANSI C++
+ * for portability. It works by using recursion and a node tree for breaking
+ * down the elements of an XML document.  </P>
+ *
+ * @version     V1.08
+ *
+ * @author      Frank Vanden Berghen
+ * based on original implementation by Martyn C Brown
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1 as published by the Free Software Foundation
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ ****************************************************************************
+ */
+
+
+#pragma once
+
+#include "util/tstring.hpp"
+#include "util/tstring_view.hxx"
+
+#include <utility>
+#include <vector>
+
+#include <tchar.h>
+
+class XMLNode;
+
+namespace XML {
+
+struct NextToken;
+
+/**
+ * An event based XML parser which does not build a tree of #XMLNode
+ * objects; the caller pulls one event after another with Next().
+ * The syntax is the same as the one accepted by ParseString(), and
+ * XML declarations ("<?...?>") are skipped.
+ */
+class PullParser {
+public:
+  enum class Event {
+    START_ELEMENT,
+    END_ELEMENT,
+    TEXT,
+    END_DOCUMENT,
+  };
+
+  using Attribute = std::pair<tstring, tstring>;
+
+private:
+  /**
+   * The input string; it is owned by the caller.
+   */
+  const TCHAR *const xml;
+
+  unsigned position = 0;
+
+  /**
+   * The names of all open elements.
+   */
+  std::vector<tstring> stack;
+
+  /**
+   * The name of the element reported by the last START_ELEMENT or
+   * END_ELEMENT event.
+   */
+  tstring name;
+
+  /**
+   * The attributes of the last START_ELEMENT event.
+   */
+  std::vector<Attribute> attributes;
+
+  /**
+   * The (decoded) text of the last TEXT event.
+   */
+  tstring text;
+
+  /**
+   * An end tag which still has to close elements; it may close more
+   * than one if inner end tags are missing.
+   */
+  tstring end_tag;
+
+  /**
+   * The last element was an empty-element tag ("<.../>"), and its
+   * END_ELEMENT event is still to be reported.
+   */
+  bool pending_empty_element = false;
+
+  /**
+   * A start tag was found after text, and will be parsed by the
+   * next Next() call.
+   */
+  bool pending_start = false, pending_declaration;
+
+public:
+  explicit PullParser(const TCHAR *_xml) noexcept
+    :xml(_xml) {}
+
+  PullParser(const PullParser &) = delete;
+  PullParser &operator=(const PullParser &) = delete;
+
+  /**
+   * Parse until the next event.  Unclosed elements are closed at the
+   * end of the input.
+   *
+   * Throws on error.
+   */
+  Event Next();
+
+  /**
+   * Skip the contents of the element which was reported by the last
+   * START_ELEMENT event, including its END_ELEMENT.
+   *
+   * Throws on error.
+   */
+  void SkipElement();
+
+  /**
+   * Read the element which was reported by the last START_ELEMENT
+   * event, including all of its children and its END_ELEMENT, into a
+   * #XMLNode tree.  This allows using the DOM for small parts of a
+   * large document.
+   *
+   * Throws on error.
+   */
+  XMLNode ReadElement();
+
+  /**
+   * The name of the element of the last START_ELEMENT or END_ELEMENT
+   * event.
+   */
+  const TCHAR *GetName() const noexcept {
+    return name.c_str();
+  }
+
+  /**
+   * The number of open elements.  After START_ELEMENT, this includes
+   * the new element; after END_ELEMENT, the closed element is not
+   * counted anymore.
+   */
+  unsigned GetDepth() const noexcept {
+    return stack.size();
+  }
+
+  const std::vector<Attribute> &GetAttributes() const noexcept {
+    return attributes;
+  }
+
+  /**
+   * Look up an attribute of the last START_ELEMENT event.
+   *
+   * @return the value or nullptr if it does not exist
+   */
+  [[gnu::pure]]
+  const TCHAR *GetAttribute(const TCHAR *name) const noexcept;
+
+  const TCHAR *GetText() const noexcept {
+    return text.c_str();
+  }
+
+private:
+  NextToken ReadToken() noexcept;
+  void SetText(tstring_view src);
+
+  /**
+   * Parse the remainder of a start tag after "<" or "<?".
+   *
+   * @return true if an element was opened, false if it was a
+   * declaration
+   */
+  bool ParseStartTag(bool is_declaration);
+
+  /**
+   * Close the innermost element on behalf of #end_tag.
+   */
+  Event CloseElement();
+};
+
+} // namespace XML
@@ -30,10 +30,10 @@ DeferEvent::Schedule() noexcept
 }
 
 void
-DeferEvent::ScheduleIdle() noexcept
+DeferEvent::ScheduleIdle(IdlePriority priority) noexcept
 {
 	if (!IsPending())
-		loop.AddIdle(*this);
+		loop.AddIdle(*this, priority);
 
 	assert(IsPending());
 }
@@ -22,6 +22,8 @@
 #include "util/BindMethod.hxx"
 #include "util/IntrusiveList.hxx"
 
+#include <cstdint>
+
 class EventLoop;
 
 /**
@@ -42,9 +44,26 @@ class DeferEvent final : AutoUnlinkIntrusiveListHook
 	using Callback = BoundMethod<void() noexcept>;
 	const Callback callback;
 
+	/**
+	 * An optional name which identifies this event in reports
+	 * about slow "idle" events.
+	 */
+	const char *const name;
+
 public:
-	DeferEvent(EventLoop &_loop, Callback _callback) noexcept
-		:loop(_loop), callback(_callback) {}
+	/**
+	 * The order in which "idle" events are invoked: all pending
+	 * #HIGH events run before any #NORMAL one.
+	 */
+	enum class IdlePriority : uint8_t {
+		HIGH,
+		NORMAL,
+		LOW,
+	};
+
+	DeferEvent(EventLoop &_loop, Callback _callback,
+		   const char *_name=nullptr) noexcept
+		:loop(_loop), callback(_callback), name(_name) {}
 
 	DeferEvent(const DeferEvent &) = delete;
 	DeferEvent &operator=(const DeferEvent &) = delete;
@@ -63,7 +82,7 @@ public:
 	 * Schedule this event, but only after the #EventLoop is idle,
 	 * i.e. before going to sleep.
 	 */
-	void ScheduleIdle() noexcept;
+	void ScheduleIdle(IdlePriority priority=IdlePriority::NORMAL) noexcept;
 
 	void Cancel() noexcept {
 		if (IsPending())
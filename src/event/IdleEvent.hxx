@@ -37,8 +37,20 @@ class IdleEvent final {
 	using Callback = BoundMethod<void() noexcept>;
 
 public:
-	IdleEvent(EventLoop &_loop, Callback _callback) noexcept
-		:event(_loop, _callback) {}
+	using Priority = DeferEvent::IdlePriority;
+
+private:
+	const Priority priority;
+
+public:
+	/**
+	 * @param name an optional name for reports about slow "idle"
+	 * events (see EventLoop::SetIdleReportCallback())
+	 */
+	IdleEvent(EventLoop &_loop, Callback _callback,
+		  Priority _priority=Priority::NORMAL,
+		  const char *name=nullptr) noexcept
+		:event(_loop, _callback, name), priority(_priority) {}
 
 	auto &GetEventLoop() const noexcept {
 		return event.GetEventLoop();
@@ -49,7 +61,7 @@ public:
 	}
 
 	void Schedule() noexcept {
-		event.ScheduleIdle();
+		event.ScheduleIdle(priority);
 	}
 
 	void Cancel() noexcept {
@@ -59,7 +59,8 @@ EventLoop::~EventLoop() noexcept
 #endif
 
 	assert(defer.empty());
-	assert(idle.empty());
+	for ([[maybe_unused]] const auto &i : idle)
+		assert(i.empty());
 #ifdef HAVE_THREADED_EVENT_LOOP
 	assert(inject.empty());
 #endif
@@ -190,9 +191,12 @@ EventLoop::AddDefer(DeferEvent &d) noexcept
 }
 
 void
-EventLoop::AddIdle(DeferEvent &e) noexcept
+EventLoop::AddIdle(DeferEvent &e, DeferEvent::IdlePriority priority) noexcept
 {
-	idle.push_front(e);
+	static_assert(std::size_t(DeferEvent::IdlePriority::LOW) + 1 ==
+		      N_IDLE_PRIORITIES);
+
+	idle[std::size_t(priority)].push_front(e);
 	again = true;
 }
 
@@ -207,16 +211,47 @@ EventLoop::RunDeferred() noexcept
 }
 
 bool
-EventLoop::RunOneIdle() noexcept
+EventLoop::RunIdle() noexcept
 {
-	if (idle.empty())
-		return false;
+	for (auto &list : idle) {
+		if (list.empty())
+			continue;
+
+		DeferEvent &e = list.front();
+		/* copy the name, because the handler may destroy the
+		   DeferEvent */
+		const char *const name = e.name;
+		list.pop_front();
+
+		const auto start = Event::Clock::now();
+		e.Run();
+		const auto duration = Event::Clock::now() - start;
+
+		++idle_statistics.n_invoked;
+		idle_statistics.total_duration += duration;
+		if (duration > idle_statistics.max_duration)
+			idle_statistics.max_duration = duration;
+
+		if (duration > idle_budget) {
+			++idle_statistics.n_over_budget;
+			if (idle_report_callback)
+				idle_report_callback(name, duration);
+		}
 
-	idle.pop_front_and_dispose([](DeferEvent *e){
-		e->Run();
-	});
+		return true;
+	}
 
-	return true;
+	return false;
+}
+
+inline bool
+EventLoop::IsIdlePending() const noexcept
+{
+	for (const auto &i : idle)
+		if (!i.empty())
+			return true;
+
+	return false;
 }
 
 template<class ToDuration, class Rep, class Period>
@@ -311,12 +346,21 @@ EventLoop::Run() noexcept
 		if (quit)
 			break;
 
-		if (RunOneIdle())
-			/* check for other new events after each
-			   "idle" invocation to ensure that the other
-			   "idle" events are really invoked at the
-			   very end */
-			continue;
+		/* if more "idle" events are pending, poll the sockets
+		   (without sleeping) and handle timers before the
+		   next one, so input does not starve behind
+		   background work */
+		bool idle_yield = false;
+		if (RunIdle()) {
+			idle_yield = IsIdlePending() && !quit &&
+				defer.empty();
+			if (!idle_yield)
+				/* check for other new events after
+				   the "idle" invocations to ensure
+				   that the other "idle" events are
+				   really invoked at the very end */
+				continue;
+		}
 
 #ifdef HAVE_THREADED_EVENT_LOOP
 		/* try to handle DeferEvents without WakeFD
@@ -326,7 +370,7 @@ EventLoop::Run() noexcept
 			HandleInject();
 #endif
 
-			if (again)
+			if (again && !idle_yield)
 				/* re-evaluate timers because one of
 				   the DeferEvents may have added a
 				   new timeout */
@@ -339,7 +383,7 @@ EventLoop::Run() noexcept
 
 		/* wait for new event */
 
-		Wait(finish ? Event::Duration{} : timeout);
+		Wait(finish || idle_yield ? Event::Duration{} : timeout);
 
 		steady_clock_cache.flush();
 
@@ -350,6 +394,9 @@ EventLoop::Run() noexcept
 		}
 #endif
 
+		/* return to the caller even if "idle" events are
+		   still pending; they run in the next Run() call,
+		   after the caller has handled its events */
 		if (finish && ready_sockets.empty())
 			break;
 
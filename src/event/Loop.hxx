@@ -24,8 +24,10 @@
 #include "TimerList.hxx"
 #include "Backend.hxx"
 #include "SocketEvent.hxx"
+#include "DeferEvent.hxx"
 #include "event/Features.h"
 #include "time/ClockCache.hxx"
+#include "util/BindMethod.hxx"
 #include "util/IntrusiveList.hxx"
 
 #ifdef HAVE_THREADED_EVENT_LOOP
@@ -36,8 +38,10 @@
 #include <boost/intrusive/list.hpp>
 #endif
 
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 
 #include "io/uring/Features.h"
 #ifdef HAVE_URING
@@ -71,10 +75,51 @@ class EventLoop final
 
 	DeferList defer;
 
+	/**
+	 * The number of DeferEvent::IdlePriority values.
+	 */
+	static constexpr std::size_t N_IDLE_PRIORITIES = 3;
+
 	/**
 	 * This is like #defer, but gets invoked when the loop is idle.
+	 * There is one list per DeferEvent::IdlePriority.
+	 */
+	std::array<DeferList, N_IDLE_PRIORITIES> idle;
+
+public:
+	struct IdleStatistics {
+		/**
+		 * The number of "idle" events invoked.
+		 */
+		uint64_t n_invoked = 0;
+
+		/**
+		 * The number of "idle" events whose execution took
+		 * longer than the budget.
+		 */
+		uint64_t n_over_budget = 0;
+
+		Event::Duration total_duration{}, max_duration{};
+	};
+
+	/**
+	 * Called after an "idle" event has exceeded the budget.  The
+	 * name is the one passed to the #DeferEvent constructor; it
+	 * may be nullptr.
+	 */
+	using IdleReportCallback =
+		BoundMethod<void(const char *name,
+				 Event::Duration duration) noexcept>;
+
+private:
+	/**
+	 * The time one "idle" event may take; see SetIdleBudget().
 	 */
-	DeferList idle;
+	Event::Duration idle_budget = std::chrono::milliseconds(5);
+
+	IdleStatistics idle_statistics;
+
+	IdleReportCallback idle_report_callback = nullptr;
 
 #ifdef HAVE_THREADED_EVENT_LOOP
 	Mutex mutex;
@@ -201,6 +246,8 @@ public:
 
 	/**
 	 * Finish Run() after all pending events have been handled.
+	 * Of the pending "idle" events, only one gets invoked; the
+	 * others are left for the next Run() call.
 	 */
 	void Finish() noexcept {
 		finish = true;
@@ -232,7 +279,28 @@ public:
 	 * Schedule a call to DeferEvent::RunDeferred().
 	 */
 	void AddDefer(DeferEvent &d) noexcept;
-	void AddIdle(DeferEvent &e) noexcept;
+	void AddIdle(DeferEvent &e, DeferEvent::IdlePriority priority) noexcept;
+
+	/**
+	 * Set the time budget for one "idle" event.  Handlers which
+	 * take longer are counted in the #IdleStatistics and reported
+	 * to the #IdleReportCallback.
+	 */
+	void SetIdleBudget(Event::Duration _budget) noexcept {
+		idle_budget = _budget;
+	}
+
+	/**
+	 * Install a callback which gets invoked each time an "idle"
+	 * event takes longer than the budget.
+	 */
+	void SetIdleReportCallback(IdleReportCallback callback) noexcept {
+		idle_report_callback = callback;
+	}
+
+	const IdleStatistics &GetIdleStatistics() const noexcept {
+		return idle_statistics;
+	}
 
 #ifdef HAVE_THREADED_EVENT_LOOP
 	/**
@@ -261,11 +329,16 @@ private:
 	void RunDeferred() noexcept;
 
 	/**
-	 * Invoke one "idle" #DeferEvent.
+	 * Invoke the first "idle" #DeferEvent of the highest priority.
+	 * Only one runs per loop iteration, so timers, deferred events
+	 * and sockets are handled between two of them.
 	 *
 	 * @return false if there was no such event
 	 */
-	bool RunOneIdle() noexcept;
+	bool RunIdle() noexcept;
+
+	[[gnu::pure]]
+	bool IsIdlePending() const noexcept;
 
 #ifdef HAVE_THREADED_EVENT_LOOP
 	/**
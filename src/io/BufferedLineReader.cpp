@@ -28,3 +28,9 @@ BufferedLineReader::ReadLine()
 {
   return buffered.ReadLine();
 }
+
+std::span<char>
+BufferedLineReader::ReadLineSpan()
+{
+  return buffered.ReadLineSpan();
+}
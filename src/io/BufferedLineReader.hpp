@@ -39,4 +39,5 @@ public:
 public:
   /* virtual methods from class NLineReader */
   char *ReadLine() override;
+  std::span<char> ReadLineSpan() override;
 };
@@ -99,19 +99,19 @@ BufferedReader::ReadFull(std::span<std::byte> dest)
 	}
 }
 
-char *
-BufferedReader::ReadLine()
+std::span<char>
+BufferedReader::ReadLineSpan()
 {
 	do {
-		char *line = ReadBufferedLine(buffer);
-		if (line != nullptr) {
+		const auto line = ReadBufferedLineSpan(buffer);
+		if (line.data() != nullptr) {
 			++line_number;
 			return line;
 		}
 	} while (Fill(true));
 
 	if (!eof || buffer.empty())
-		return nullptr;
+		return {};
 
 	auto w = buffer.Write();
 	if (w.empty()) {
@@ -123,7 +123,7 @@ BufferedReader::ReadLine()
 	/* terminate the last line */
 	w[0] = 0;
 
-	char *line = buffer.Read().data();
+	const auto line = buffer.Read();
 	buffer.Clear();
 	++line_number;
 	return line;
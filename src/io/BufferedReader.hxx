@@ -104,7 +104,17 @@ public:
 		return dest;
 	}
 
-	char *ReadLine();
+	/**
+	 * Read one line and null-terminate it in place; the span
+	 * does not include the null terminator.  Returns an empty
+	 * span with a nullptr data pointer at the end of the file.
+	 * The line is invalidated by the next call.
+	 */
+	std::span<char> ReadLineSpan();
+
+	char *ReadLine() {
+		return ReadLineSpan().data();
+	}
 
 	unsigned GetLineNumber() const noexcept {
 		return line_number;
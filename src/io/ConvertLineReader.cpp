@@ -33,12 +33,12 @@ ConvertLineReader::ConvertLineReader(std::unique_ptr<LineReader<char>> &&_source
 TCHAR *
 ConvertLineReader::ReadLine()
 {
-  char *narrow = source->ReadLine();
+  const auto narrow = source->ReadLineSpan();
 
-  if (narrow == nullptr)
+  if (narrow.data() == nullptr)
     return nullptr;
 
-  return converter.Convert(narrow);
+  return converter.Convert(narrow.data(), narrow.size());
 }
 
 long
@@ -25,11 +25,13 @@ Copyright_License {
 #include "FileReader.hxx"
 #include "FileOutputStream.hxx"
 #include "system/FileUtil.hpp"
+#include "system/FileMapping.hpp"
 
 #ifdef _WIN32
 #include "time/FileTime.hxx"
 #endif
 
+#include <algorithm>
 #include <cstdint>
 #include <stdexcept>
 
@@ -99,27 +101,62 @@ FileCache::Flush(const TCHAR *name)
   File::Delete(MakeCachePath(name));
 }
 
-std::unique_ptr<Reader>
-FileCache::Load(const TCHAR *name, Path original_path) noexcept
+void
+FileCache::Prune(const TCHAR *pattern, std::span<const tstring> keep)
 {
-  FileInfo original_info;
-  if (!GetRegularFileInfo(original_path, original_info))
-    return nullptr;
+  struct Visitor : public File::Visitor {
+    const std::span<const tstring> keep;
 
-  const auto path = MakeCachePath(name);
+    explicit Visitor(std::span<const tstring> _keep) noexcept
+      :keep(_keep) {}
+
+    void Visit(Path path, Path filename) override {
+      if (!std::binary_search(keep.begin(), keep.end(), filename.c_str()))
+        File::Delete(path);
+    }
+  } visitor(keep);
+
+  Directory::VisitSpecificFiles(cache_path, pattern, visitor);
+}
+
+/**
+ * Check whether the cache file may be used: both files must exist,
+ * and the cache file must not be older than the original file.  An
+ * outdated cache file is deleted.
+ *
+ * @param original_info receives information about the original file
+ */
+static bool
+CheckModificationTime(Path path, Path original_path,
+                      FileInfo &original_info) noexcept
+{
+  if (!GetRegularFileInfo(original_path, original_info))
+    return false;
 
   FileInfo cached_info;
   if (!GetRegularFileInfo(path, cached_info))
-    return nullptr;
+    return false;
 
   /* if the original file is newer than the cache, discard the cache -
      unless the system clock is skewed (origina file's modification
      time is in the future) */
   if (original_info.mtime > cached_info.mtime && !original_info.IsFuture()) {
     File::Delete(path);
-    return nullptr;
+    return false;
   }
 
+  return true;
+}
+
+std::unique_ptr<Reader>
+FileCache::Load(const TCHAR *name, Path original_path) noexcept
+{
+  const auto path = MakeCachePath(name);
+
+  FileInfo original_info;
+  if (!CheckModificationTime(path, original_path, original_info))
+    return nullptr;
+
   try {
     auto r = std::make_unique<FileReader>(path);
 
@@ -139,6 +176,41 @@ FileCache::Load(const TCHAR *name, Path original_path) noexcept
   return nullptr;
 }
 
+std::unique_ptr<FileMapping>
+FileCache::Map(const TCHAR *name, Path original_path) noexcept
+{
+  const auto path = MakeCachePath(name);
+
+  FileInfo original_info;
+  if (!CheckModificationTime(path, original_path, original_info))
+    return nullptr;
+
+  try {
+    auto m = std::make_unique<FileMapping>(path);
+    if (m->size() >= GetHeaderSize()) {
+      /* the mapping need not be aligned for FileInfo */
+      unsigned magic;
+      FileInfo old_info;
+      memcpy(&magic, m->at(0), sizeof(magic));
+      memcpy(&old_info, m->at(sizeof(magic)), sizeof(old_info));
+
+      if (magic == FILE_CACHE_MAGIC &&
+          old_info == original_info)
+        return m;
+    }
+  } catch (...) {
+  }
+
+  File::Delete(path);
+  return nullptr;
+}
+
+std::size_t
+FileCache::GetHeaderSize() noexcept
+{
+  return sizeof(FILE_CACHE_MAGIC) + sizeof(FileInfo);
+}
+
 std::unique_ptr<FileOutputStream>
 FileCache::Save(const TCHAR *name, Path original_path)
 {
@@ -24,13 +24,17 @@ Copyright_License {
 #pragma once
 
 #include "system/Path.hpp"
+#include "util/tstring.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <stdio.h>
 #include <tchar.h>
 
 class Reader;
 class FileOutputStream;
+class FileMapping;
 
 class FileCache {
   AllocatedPath cache_path;
@@ -47,11 +51,35 @@ protected:
 public:
   void Flush(const TCHAR *name);
 
+  /**
+   * Delete all cache files whose names match the specified pattern,
+   * except for those listed in #keep.
+   *
+   * @param keep a sorted list of names
+   */
+  void Prune(const TCHAR *pattern, std::span<const tstring> keep);
+
   /**
    * Returns nullptr on error.
    */
   std::unique_ptr<Reader> Load(const TCHAR *name, Path original_path) noexcept;
 
+  /**
+   * Like Load(), but map the whole cache file into memory.  The data
+   * written to the Save() stream begins at GetHeaderSize().
+   *
+   * Returns nullptr on error.
+   */
+  std::unique_ptr<FileMapping> Map(const TCHAR *name,
+                                   Path original_path) noexcept;
+
+  /**
+   * The size of the header which precedes the data in a mapped cache
+   * file.
+   */
+  [[gnu::const]]
+  static std::size_t GetHeaderSize() noexcept;
+
   /**
    * Throws on error.
    */
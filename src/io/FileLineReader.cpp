@@ -29,6 +29,12 @@ FileLineReaderA::ReadLine()
   return buffered.ReadLine();
 }
 
+std::span<char>
+FileLineReaderA::ReadLineSpan()
+{
+  return buffered.ReadLineSpan();
+}
+
 long
 FileLineReaderA::GetSize() const
 {
@@ -24,15 +24,23 @@ Copyright_License {
 #pragma once
 
 #include "FileReader.hxx"
+#include "ReadAheadReader.hpp"
 #include "BufferedReader.hxx"
 #include "ConvertLineReader.hpp"
 
 /**
  * Glue class which combines FileReader and BufferedReader, and provides
- * a public NLineReader interface.
+ * a public NLineReader interface.  Large files are read ahead in a
+ * separate thread while the caller parses them.
  */
 class FileLineReaderA : public NLineReader {
+  /**
+   * Files smaller than this are read synchronously.
+   */
+  static constexpr uint64_t READ_AHEAD_THRESHOLD = 256 * 1024;
+
   FileReader file;
+  ReadAheadReader read_ahead;
   BufferedReader buffered;
 
 public:
@@ -40,12 +48,15 @@ public:
    * Throws std::runtime_errror on error.
    */
   explicit FileLineReaderA(Path path)
-    :file(path), buffered(file) {}
+    :file(path),
+     read_ahead(file, file.GetSize() >= READ_AHEAD_THRESHOLD),
+     buffered(read_ahead) {}
 
   /**
    * Rewind the file to the beginning.
    */
   void Rewind() {
+    read_ahead.Reset();
     file.Rewind();
     buffered.Reset();
   }
@@ -53,6 +64,7 @@ public:
 public:
   /* virtual methods from class NLineReader */
   char *ReadLine() override;
+  std::span<char> ReadLineSpan() override;
   long GetSize() const override;
   long Tell() const override;
 };
@@ -23,6 +23,9 @@ Copyright_License {
 
 #pragma once
 
+#include "util/StringAPI.hxx"
+
+#include <span>
 #include <tchar.h>
 
 template<class T>
@@ -41,6 +44,20 @@ public:
    */
   virtual T *ReadLine() = 0;
 
+  /**
+   * Like ReadLine(), but also returns the length of the line (not
+   * including the null terminator), so callers don't need to scan it
+   * again.  Returns an empty span with a nullptr data pointer after
+   * the last line.
+   */
+  virtual std::span<T> ReadLineSpan() {
+    T *line = ReadLine();
+    if (line == nullptr)
+      return {};
+
+    return {line, StringLength(line)};
+  }
+
   /**
    * Determins the size of the file.  Returns -1 if the size is
    * unknown.
@@ -0,0 +1,148 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ReadAheadReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+void
+ReadAheadReader::Stop() noexcept
+{
+  if (!IsDefined())
+    return;
+
+  {
+    const std::lock_guard lock{mutex};
+    cancel = true;
+  }
+
+  cond.notify_all();
+  Join();
+}
+
+void
+ReadAheadReader::Reset() noexcept
+{
+  Stop();
+
+  head = 0;
+  n_filled = 0;
+  head_position = 0;
+  eof = cancel = false;
+  error = {};
+}
+
+void
+ReadAheadReader::Run() noexcept
+{
+  std::unique_lock lock{mutex};
+
+  while (true) {
+    while (!cancel && n_filled == N_CHUNKS)
+      cond.wait(lock);
+
+    if (cancel)
+      break;
+
+    /* the consumer does not touch chunks which are not filled, so
+       this one can be written without holding the lock */
+    Chunk &chunk = chunks[(head + n_filled) % N_CHUNKS];
+
+    std::size_t nbytes = 0;
+    std::exception_ptr e;
+
+    {
+      const ScopeUnlock unlock(mutex);
+
+      if (!chunk.data)
+        chunk.data = std::make_unique<std::byte[]>(CHUNK_SIZE);
+
+      try {
+        nbytes = source.Read(chunk.data.get(), CHUNK_SIZE);
+      } catch (...) {
+        e = std::current_exception();
+      }
+    }
+
+    if (e) {
+      error = std::move(e);
+      cond.notify_all();
+      break;
+    }
+
+    if (nbytes == 0) {
+      eof = true;
+      cond.notify_all();
+      break;
+    }
+
+    chunk.size = nbytes;
+    ++n_filled;
+    cond.notify_all();
+  }
+}
+
+std::size_t
+ReadAheadReader::Read(void *data, std::size_t size)
+{
+  if (!enabled)
+    return source.Read(data, size);
+
+  if (!IsDefined() && !eof && !error)
+    Start();
+
+  {
+    std::unique_lock lock{mutex};
+    while (n_filled == 0 && !eof && !error)
+      cond.wait(lock);
+
+    if (n_filled == 0) {
+      if (error)
+        std::rethrow_exception(error);
+
+      return 0;
+    }
+  }
+
+  /* the #head chunk is owned by the consumer until it is released
+     below */
+  const Chunk &chunk = chunks[head];
+  const std::size_t nbytes = std::min(size, chunk.size - head_position);
+  memcpy(data, chunk.data.get() + head_position, nbytes);
+  head_position += nbytes;
+
+  if (head_position == chunk.size) {
+    head_position = 0;
+
+    {
+      const std::lock_guard lock{mutex};
+      head = (head + 1) % N_CHUNKS;
+      --n_filled;
+    }
+
+    cond.notify_all();
+  }
+
+  return nbytes;
+}
@@ -0,0 +1,120 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "Reader.hxx"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <memory>
+
+/**
+ * A #Reader which reads ahead from another #Reader in a separate
+ * thread, so the (blocking) disk I/O overlaps with parsing the data
+ * which has already been read.
+ *
+ * If read-ahead is disabled in the constructor, all calls are
+ * forwarded synchronously; this avoids the thread for small files.
+ *
+ * The source must not be accessed by anybody else while read-ahead
+ * is in progress; call Reset() before seeking it.
+ */
+class ReadAheadReader final : public Reader, private Thread {
+  static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+  static constexpr std::size_t N_CHUNKS = 4;
+
+  struct Chunk {
+    std::unique_ptr<std::byte[]> data;
+    std::size_t size = 0;
+  };
+
+  Reader &source;
+
+  const bool enabled;
+
+  Mutex mutex;
+
+  /**
+   * Signalled by the thread after it has filled a chunk, and by the
+   * consumer after it has released one.
+   */
+  Cond cond;
+
+  std::array<Chunk, N_CHUNKS> chunks;
+
+  /**
+   * The chunk being consumed by Read().
+   */
+  std::size_t head = 0;
+
+  /**
+   * The number of chunks filled by the thread and not yet consumed.
+   * The first one is #head.  Protected by #mutex.
+   */
+  std::size_t n_filled = 0;
+
+  /**
+   * The number of bytes of the #head chunk already consumed.  Only
+   * accessed by the consumer.
+   */
+  std::size_t head_position = 0;
+
+  /**
+   * Protected by #mutex.
+   */
+  bool eof = false, cancel = false;
+
+  /**
+   * An error thrown by the source.  Protected by #mutex.
+   */
+  std::exception_ptr error;
+
+public:
+  ReadAheadReader(Reader &_source, bool _enabled=true) noexcept
+    :Thread("ReadAhead"), source(_source), enabled(_enabled) {}
+
+  ~ReadAheadReader() noexcept {
+    Stop();
+  }
+
+  /**
+   * Stop reading ahead and discard all data read so far.  Afterwards,
+   * the source may be seeked; the next Read() call continues at its
+   * new position.
+   */
+  void Reset() noexcept;
+
+  /* virtual methods from class Reader */
+  std::size_t Read(void *data, std::size_t size) override;
+
+private:
+  void Stop() noexcept;
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
@@ -25,6 +25,7 @@ Copyright_License {
 #include "util/Compiler.h"
 #include "util/UTF8.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
@@ -47,28 +48,34 @@ iso_latin_1_to_tchar(TCHAR *dest, const char *src)
 #endif
 
 TCHAR *
-StringConverter::Convert(char *narrow)
+StringConverter::Convert(char *narrow, std::size_t narrow_length)
 {
   assert(narrow != nullptr);
+  assert(narrow[narrow_length] == '\0');
 
   // Check if there is byte order mark in front
   if (charset == Charset::AUTO || charset == Charset::UTF8) {
     char *p = SkipByteOrderMark(narrow);
     if (p != nullptr) {
       narrow = p;
+      narrow_length -= 3;
 
       /* switch to UTF-8 now */
       charset = Charset::UTF8;
     }
   }
 
-  if (charset == Charset::AUTO && !ValidateUTF8(narrow))
+  const std::string_view view{narrow, narrow_length};
+
+  /* most lines are plain ASCII, which is the same in all supported
+     character sets, and needs neither validation nor conversion */
+  const bool ascii = FindNonASCII(view) == view.npos;
+
+  if (charset == Charset::AUTO && !ascii && !ValidateUTF8(view))
     /* invalid UTF-8 sequence detected: switch to ISO-Latin-1 */
     charset = Charset::ISO_LATIN_1;
 
 #ifdef _UNICODE
-  size_t narrow_length = strlen(narrow);
-
   TCHAR *t = tbuffer.get(narrow_length + 1);
   assert(t != nullptr);
 
@@ -77,6 +84,12 @@ StringConverter::Convert(char *narrow)
     return t;
   }
 
+  if (ascii) {
+    /* copy including the null terminator */
+    std::copy_n(narrow, narrow_length + 1, t);
+    return t;
+  }
+
   switch (charset) {
   case Charset::ISO_LATIN_1:
     iso_latin_1_to_tchar(t, narrow);
@@ -95,12 +108,15 @@ StringConverter::Convert(char *narrow)
 
   return t;
 #else
+  if (ascii)
+    return narrow;
+
   switch (charset) {
     size_t buffer_size;
     const char *utf8;
 
   case Charset::ISO_LATIN_1:
-    buffer_size = strlen(narrow) * 2 + 1;
+    buffer_size = narrow_length * 2 + 1;
     utf8 = Latin1ToUTF8(narrow, tbuffer.get(buffer_size), buffer_size);
     if (utf8 == nullptr)
       throw std::runtime_error("Latin-1 to UTF-8 conversion failed");
@@ -108,7 +124,7 @@ StringConverter::Convert(char *narrow)
     return const_cast<char *>(utf8);
 
   case Charset::UTF8:
-    if (!ValidateUTF8(narrow))
+    if (!ValidateUTF8(view))
       /* abort on invalid UTF-8 sequence */
       throw std::runtime_error("Invalid UTF-8");
 
@@ -123,3 +139,11 @@ StringConverter::Convert(char *narrow)
   gcc_unreachable();
 #endif
 }
+
+TCHAR *
+StringConverter::Convert(char *narrow)
+{
+  assert(narrow != nullptr);
+
+  return Convert(narrow, std::strlen(narrow));
+}
@@ -26,6 +26,7 @@ Copyright_License {
 #include "Charset.hpp"
 #include "util/ReusableArray.hpp"
 
+#include <cstddef>
 #include <tchar.h>
 
 /**
@@ -70,4 +71,10 @@ public:
    * Throws on error.
    */
   TCHAR *Convert(char *src);
+
+  /**
+   * Like Convert(char *), but the caller already knows the length of
+   * the (null-terminated) string.
+   */
+  TCHAR *Convert(char *src, std::size_t length);
 };
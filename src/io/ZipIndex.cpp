@@ -0,0 +1,80 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "ZipIndex.hpp"
+#include "ZipArchive.hpp"
+#include "FileCache.hpp"
+#include "FileOutputStream.hxx"
+#include "system/FileMapping.hpp"
+#include "system/Path.hpp"
+
+#include <zzip/zzip.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include <stdlib.h>
+
+static bool
+LoadZipIndexCache(ZipArchive &archive, Path path,
+                  FileCache &cache, const TCHAR *cache_name) noexcept
+{
+  const auto mapping = cache.Map(cache_name, path);
+  if (!mapping)
+    return false;
+
+  const std::size_t header_size = FileCache::GetHeaderSize();
+  return zzip_dir_index_import(archive.get(), mapping->at(header_size),
+                               mapping->size() - header_size) >= 0;
+}
+
+static void
+SaveZipIndexCache(ZipArchive &archive, Path path,
+                  FileCache &cache, const TCHAR *cache_name)
+{
+  zzip_size_t size;
+  const std::unique_ptr<void, decltype(&free)>
+    data{zzip_dir_index_export(archive.get(), &size), free};
+  if (data == nullptr)
+    /* nothing was indexed */
+    return;
+
+  auto os = cache.Save(cache_name, path);
+  os->Write(data.get(), size);
+  os->Commit();
+}
+
+void
+LoadZipIndex(ZipArchive &archive, Path path, const char *name,
+             FileCache *cache, const TCHAR *cache_name)
+{
+  if (cache != nullptr &&
+      LoadZipIndexCache(archive, path, *cache, cache_name))
+    return;
+
+  if (zzip_dir_index_build(archive.get(), name, ZIP_INDEX_SPAN) < 0)
+    throw std::runtime_error("Failed to index ZIP archive");
+
+  if (cache != nullptr)
+    SaveZipIndexCache(archive, path, *cache, cache_name);
+}
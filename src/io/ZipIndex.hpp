@@ -0,0 +1,59 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <tchar.h>
+
+class Path;
+class ZipArchive;
+class FileCache;
+
+/**
+ * The distance (in uncompressed bytes) between two checkpoints of a
+ * ZIP seek index.  A random access inside a deflated member never
+ * needs to inflate more than this.
+ */
+static constexpr std::size_t ZIP_INDEX_SPAN = 512 * 1024;
+
+/**
+ * Prepare cheap random access to deflated members of a ZIP archive
+ * (see zzip_dir_index_build()).  The checkpoints are loaded from the
+ * #FileCache; if there are none (or if the archive has been
+ * modified), they are built, which inflates each member once, and
+ * saved to the cache.
+ *
+ * Throws on error.
+ *
+ * @param path the path of the archive file; the cache is discarded
+ * when it gets modified
+ * @param name the member to be indexed; nullptr for all large
+ * deflated members
+ * @param cache an optional #FileCache
+ * @param cache_name the name of the cache file; each archive/member
+ * combination needs its own name
+ */
+void
+LoadZipIndex(ZipArchive &archive, Path path, const char *name,
+             FileCache *cache, const TCHAR *cache_name);
@@ -47,6 +47,11 @@ public:
   [[gnu::pure]]
   uint64_t GetPosition() const;
 
+  /**
+   * Throws on error.
+   */
+  void Seek(uint64_t offset);
+
   /* virtual methods from class Reader */
   std::size_t Read(void *data, std::size_t size) override;
 };
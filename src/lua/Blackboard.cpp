@@ -24,10 +24,23 @@ Copyright_License {
 #include "Blackboard.hpp"
 #include "Chrono.hpp"
 #include "Geo.hpp"
-#include "MetaTable.hxx"
 #include "Util.hxx"
-#include "util/StringAPI.hxx"
+#include "Value.hxx"
+#include "Error.hxx"
+#include "Catch.hpp"
+#include "Class.hxx"
+#include "Persistent.hpp"
+#include "Blackboard/BlackboardListener.hpp"
+#include "Blackboard/LiveBlackboard.hpp"
 #include "Interface.hpp"
+#include "ui/event/IdleEvent.hpp"
+#include "util/StringAPI.hxx"
+
+extern "C" {
+#include <lauxlib.h>
+}
+
+#include <iterator>
 
 namespace Lua {
 
@@ -60,77 +73,375 @@ static void PushOptional(lua_State *L, bool available, V &&value) {
 
 }
 
-static int
-l_blackboard_index(lua_State *L)
-{
-  const auto &basic = CommonInterface::Basic();
+/**
+ * Pushes the value of one blackboard attribute, or nil if it is not
+ * available.
+ */
+using PushFieldFunction = void (*)(lua_State *L, const MoreData &basic);
 
-  const char *name = lua_tostring(L, 2);
-  if (name == nullptr)
-    return 0;
-  else if (StringIsEqual(name, "clock"))
+struct BlackboardField {
+  const char *name;
+  PushFieldFunction push;
+};
+
+static constexpr BlackboardField blackboard_fields[] = {
+  {"clock", [](lua_State *L, const MoreData &basic){
     Lua::Push(L, basic.clock);
-  else if (StringIsEqual(name, "time"))
+  }},
+  {"time", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.time_available, basic.time);
-  else if (StringIsEqual(name, "date_time_utc"))
+  }},
+  {"date_time_utc", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.time_available, basic.date_time_utc);
-  else if (StringIsEqual(name, "location"))
+  }},
+  {"location", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.location_available, basic.location);
-  else if (StringIsEqual(name, "altitude"))
+  }},
+  {"altitude", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.NavAltitudeAvailable(), basic.nav_altitude);
-  else if (StringIsEqual(name, "track"))
+  }},
+  {"track", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.track_available, basic.track);
-  else if (StringIsEqual(name, "ground_speed"))
+  }},
+  {"ground_speed", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.ground_speed_available, basic.ground_speed);
-  else if (StringIsEqual(name, "air_speed"))
+  }},
+  {"air_speed", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.airspeed_available, basic.true_airspeed);
-  else if (StringIsEqual(name, "bank_angle"))
+  }},
+  {"bank_angle", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.attitude.bank_angle_available,
                       basic.attitude.bank_angle);
-  else if (StringIsEqual(name, "pitch_angle"))
+  }},
+  {"pitch_angle", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.attitude.pitch_angle_available,
                       basic.attitude.pitch_angle);
-  else if (StringIsEqual(name, "heading"))
-    Lua::PushOptional(L, basic.attitude.heading_available, basic.attitude.heading);
-  else if (StringIsEqual(name, "g_load"))
-    Lua::PushOptional(L, basic.acceleration.available, basic.acceleration.g_load);
-  else if (StringIsEqual(name, "static_pressure"))
-    Lua::PushOptional(L, basic.static_pressure_available, basic.static_pressure.GetPascal());
-  else if (StringIsEqual(name, "pitot_pressure"))
-    Lua::PushOptional(L, basic.pitot_pressure_available, basic.pitot_pressure.GetPascal());
-  else if (StringIsEqual(name, "dynamic_pressure"))
-    Lua::PushOptional(L, basic.dyn_pressure_available, basic.dyn_pressure.GetPascal());
-  else if (StringIsEqual(name, "temperature"))
+  }},
+  {"heading", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.attitude.heading_available,
+                      basic.attitude.heading);
+  }},
+  {"g_load", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.acceleration.available,
+                      basic.acceleration.g_load);
+  }},
+  {"static_pressure", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.static_pressure_available,
+                      basic.static_pressure.GetPascal());
+  }},
+  {"pitot_pressure", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.pitot_pressure_available,
+                      basic.pitot_pressure.GetPascal());
+  }},
+  {"dynamic_pressure", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.dyn_pressure_available,
+                      basic.dyn_pressure.GetPascal());
+  }},
+  {"temperature", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.temperature_available,
                       basic.temperature.ToKelvin());
-  else if (StringIsEqual(name, "humidity"))
+  }},
+  {"humidity", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.humidity_available, basic.humidity);
-  else if (StringIsEqual(name, "voltage"))
+  }},
+  {"voltage", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.voltage_available, basic.voltage);
-  else if (StringIsEqual(name, "battery_level"))
+  }},
+  {"battery_level", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.battery_level_available, basic.battery_level);
-  else if (StringIsEqual(name, "noncomp_vario"))
+  }},
+  {"noncomp_vario", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.noncomp_vario_available, basic.noncomp_vario);
-  else if (StringIsEqual(name, "total_energy_vario"))
-    Lua::PushOptional(L, basic.total_energy_vario_available, basic.total_energy_vario);
-  else if (StringIsEqual(name, "netto_vario"))
+  }},
+  {"total_energy_vario", [](lua_State *L, const MoreData &basic){
+    Lua::PushOptional(L, basic.total_energy_vario_available,
+                      basic.total_energy_vario);
+  }},
+  {"netto_vario", [](lua_State *L, const MoreData &basic){
     Lua::PushOptional(L, basic.netto_vario_available, basic.netto_vario);
-  else
+  }},
+};
+
+/**
+ * Push a table mapping each attribute name to its (1-based) index in
+ * #blackboard_fields.  Lua strings are interned, so looking up a name
+ * in this table is a hash lookup instead of a chain of string
+ * comparisons.
+ */
+static void
+PushFieldKeys(lua_State *L)
+{
+  lua_createtable(L, 0, std::size(blackboard_fields));
+
+  int i = 0;
+  for (const auto &field : blackboard_fields)
+    Lua::SetField(L, Lua::RelativeStackIndex{-1}, field.name, ++i);
+}
+
+static constexpr char snapshot_key[] = "xcsoar.blackboard.snapshot";
+static constexpr char snapshot_clock_key[] = "xcsoar.blackboard.snapshot_clock";
+
+/**
+ * Push a table containing all attributes.  The table built for the
+ * first subscriber of an update is kept in the registry and shared by
+ * all others.
+ */
+static void
+PushSnapshot(lua_State *L, const MoreData &basic)
+{
+  const Lua::ScopeCheckStack check_stack(L, 1);
+
+  Lua::Push(L, basic.clock);
+  lua_getfield(L, LUA_REGISTRYINDEX, snapshot_clock_key);
+  const bool cached = !lua_isnil(L, -1) && lua_rawequal(L, -1, -2);
+  lua_pop(L, 1);
+
+  if (cached) {
+    lua_pop(L, 1);
+    lua_getfield(L, LUA_REGISTRYINDEX, snapshot_key);
+    return;
+  }
+
+  lua_setfield(L, LUA_REGISTRYINDEX, snapshot_clock_key);
+
+  lua_createtable(L, 0, std::size(blackboard_fields));
+  for (const auto &field : blackboard_fields) {
+    field.push(L, basic);
+    lua_setfield(L, -2, field.name);
+  }
+
+  lua_pushvalue(L, -1);
+  lua_setfield(L, LUA_REGISTRYINDEX, snapshot_key);
+}
+
+static int
+l_blackboard_index(lua_State *L)
+{
+  /* upvalue 1 is the table created by PushFieldKeys() */
+  lua_pushvalue(L, 2);
+  lua_rawget(L, lua_upvalueindex(1));
+  const lua_Integer i = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+
+  if (i <= 0 || i > lua_Integer(std::size(blackboard_fields)))
     return 0;
 
+  blackboard_fields[i - 1].push(L, CommonInterface::Basic());
   return 1;
 }
 
+/**
+ * Calls a Lua function after each GPS update or after each calculated
+ * update, passing a snapshot of all attributes.
+ *
+ * The callback may subscribe or cancel, but the #LiveBlackboard's
+ * listener list must not be modified while it is being broadcast.
+ * Therefore, Subscribe() and Cancel() only change the #subscribed
+ * flag; the listener is added or removed later by a timer which runs
+ * from the main loop.
+ */
+class LuaBlackboardSubscription final : NullBlackboardListener {
+  Lua::Value callback;
+
+  /**
+   * A reference to this object's userdata.  It is only set while
+   * subscribed (or while the listener is still registered), to avoid
+   * holding a reference on an otherwise unused Lua object.
+   */
+  Lua::Value subscription;
+
+  /**
+   * Adds or removes the listener after the current broadcast.
+   */
+  UI::IdleEvent sync_event{[this]{ Sync(); },
+                           UI::IdleEvent::Priority::NORMAL,
+                           "Lua blackboard"};
+
+  /**
+   * Fire after the calculations instead of after the GPS update?
+   */
+  const bool calculated;
+
+  /**
+   * Does the script want updates?  The callback is only invoked
+   * while this is set.
+   */
+  bool subscribed = false;
+
+  /**
+   * Is this object registered in the #LiveBlackboard's listener list?
+   */
+  bool registered = false;
+
+public:
+  LuaBlackboardSubscription(lua_State *L, int callback_idx,
+                            bool _calculated) noexcept
+    :callback(L, Lua::StackIndex(callback_idx)), subscription(L),
+     calculated(_calculated) {}
+
+  ~LuaBlackboardSubscription() noexcept {
+    if (registered)
+      CommonInterface::GetLiveBlackboard().RemoveListener(*this);
+  }
+
+  lua_State *GetLuaState() noexcept {
+    return callback.GetState();
+  }
+
+  void Subscribe(Lua::StackIndex subscription_index) noexcept {
+    const Lua::ScopeCheckStack check_stack(GetLuaState());
+
+    Lua::AddPersistent(GetLuaState(), this);
+    subscription.Set(subscription_index);
+    subscribed = true;
+    sync_event.Schedule();
+  }
+
+  void Cancel() noexcept {
+    if (!subscribed)
+      return;
+
+    subscribed = false;
+    sync_event.Schedule();
+  }
+
+private:
+  void Invoke(const MoreData &basic) noexcept {
+    const auto L = GetLuaState();
+    const Lua::ScopeCheckStack check_stack(L);
+
+    callback.Push();
+    PushSnapshot(L, basic);
+    subscription.Push();
+    if (lua_pcall(L, 2, 0, 0))
+      Lua::ThrowError(L, Lua::PopError(L));
+
+    Lua::CheckPersistent(L);
+  }
+
+  /**
+   * Make the listener registration match #subscribed.  Called by
+   * #sync_event, i.e. never during a broadcast.
+   */
+  void Sync() noexcept {
+    auto &blackboard = CommonInterface::GetLiveBlackboard();
+
+    if (subscribed) {
+      if (!registered) {
+        blackboard.AddListener(*this);
+        registered = true;
+      }
+
+      return;
+    }
+
+    if (registered) {
+      blackboard.RemoveListener(*this);
+      registered = false;
+    }
+
+    /* now that the blackboard doesn't refer to this object anymore,
+       the Lua garbage collector may dispose it */
+    const Lua::ScopeCheckStack check_stack(GetLuaState());
+    subscription.Set(nullptr);
+    Lua::RemovePersistent(GetLuaState(), this);
+  }
+
+  /* virtual methods from class BlackboardListener */
+  void OnGPSUpdate(const MoreData &basic) override {
+    if (!calculated && subscribed)
+      Invoke(basic);
+  }
+
+  void OnCalculatedUpdate(const MoreData &basic,
+                          const DerivedInfo &) override {
+    if (calculated && subscribed)
+      Invoke(basic);
+  }
+
+public:
+  static int l_subscribe(lua_State *L);
+  static int l_cancel(lua_State *L);
+};
+
+static constexpr char lua_blackboard_subscription_class[] =
+  "xcsoar.blackboard.subscription";
+using LuaBlackboardSubscriptionClass =
+  Lua::Class<LuaBlackboardSubscription, lua_blackboard_subscription_class>;
+
+int
+LuaBlackboardSubscription::l_subscribe(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "Invalid parameters");
+
+  const char *event = lua_tostring(L, 1);
+  bool _calculated;
+  if (event != nullptr && StringIsEqual(event, "gps"))
+    _calculated = false;
+  else if (event != nullptr && StringIsEqual(event, "calculated"))
+    _calculated = true;
+  else
+    return luaL_argerror(L, 1, "\"gps\" or \"calculated\" expected");
+
+  if (!lua_isfunction(L, 2))
+    return luaL_argerror(L, 2, "function expected");
+
+  auto *subscription =
+    LuaBlackboardSubscriptionClass::New(L, L, 2, _calculated);
+  subscription->Subscribe(Lua::StackIndex(-2));
+  return 1;
+}
+
+int
+LuaBlackboardSubscription::l_cancel(lua_State *L)
+{
+  auto &subscription = LuaBlackboardSubscriptionClass::Cast(L, 1);
+  subscription.Cancel();
+  return 0;
+}
+
+static constexpr struct luaL_Reg subscription_methods[] = {
+  {"cancel", LuaBlackboardSubscription::l_cancel},
+  {nullptr, nullptr}
+};
+
+static void
+CreateSubscriptionMetatable(lua_State *L)
+{
+  LuaBlackboardSubscriptionClass::Register(L);
+
+  /* metatable.__index = subscription_methods */
+  luaL_newlib(L, subscription_methods);
+  lua_setfield(L, -2, "__index");
+
+  /* pop metatable */
+  lua_pop(L, 1);
+}
+
 void
 Lua::InitBlackboard(lua_State *L)
 {
+  const Lua::ScopeCheckStack check_stack(L);
+
   lua_getglobal(L, "xcsoar");
 
   lua_newtable(L);
 
-  MakeIndexMetaTableFor(L, RelativeStackIndex{-1}, l_blackboard_index);
+  SetField(L, RelativeStackIndex{-1}, "subscribe",
+           LuaBlackboardSubscription::l_subscribe);
+
+  /* the metatable's __index is a closure with the field key table as
+     its upvalue */
+  lua_newtable(L);
+  PushFieldKeys(L);
+  lua_pushcclosure(L, l_blackboard_index, 1);
+  lua_setfield(L, -2, "__index");
+  lua_setmetatable(L, -2);
 
   lua_setfield(L, -2, "blackboard");
 
   lua_pop(L, 1);
+
+  CreateSubscriptionMetatable(L);
 }
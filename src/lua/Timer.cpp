@@ -29,6 +29,7 @@ Copyright_License {
 #include "Catch.hpp"
 #include "Class.hxx"
 #include "Persistent.hpp"
+#include "ui/event/IdleEvent.hpp"
 #include "ui/event/PeriodicTimer.hpp"
 #include "time/FloatDuration.hxx"
 
@@ -37,7 +38,15 @@ extern "C" {
 }
 
 class LuaTimer final {
-  UI::PeriodicTimer timer_event{[this]{ OnTimer(); }};
+  UI::PeriodicTimer timer_event{[this]{ invoke_event.Schedule(); }};
+
+  /**
+   * Invokes the Lua callback after the timer has expired, when the
+   * main thread has handled all pending input.  If the callback is
+   * slower than the timer period, expirations get merged.
+   */
+  UI::IdleEvent invoke_event{[this]{ OnTimer(); },
+                             UI::IdleEvent::Priority::LOW, "Lua timer"};
 
   Lua::Value callback;
 
@@ -69,6 +78,7 @@ public:
     const Lua::ScopeCheckStack check_stack(GetLuaState());
 
     timer_event.Cancel();
+    invoke_event.Cancel();
     timer.Set(nullptr);
     Lua::RemovePersistent(GetLuaState(), this);
   }
@@ -0,0 +1,348 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "thread/TaskScheduler.hpp"
+#include "Operation/Operation.hpp"
+
+#include <thread>
+#include <utility>
+
+/**
+ * Never start more worker threads than this, no matter how many CPUs
+ * there are.
+ */
+static constexpr unsigned MAX_THREADS = 16;
+
+void
+TaskScheduler::Worker::Push(Task &&task) noexcept
+{
+  const std::lock_guard lock{queue_mutex};
+  queue.push_back(std::move(task));
+}
+
+std::optional<TaskScheduler::Task>
+TaskScheduler::Worker::Pop() noexcept
+{
+  const std::lock_guard lock{queue_mutex};
+  if (queue.empty())
+    return std::nullopt;
+
+  Task task = std::move(queue.back());
+  queue.pop_back();
+  return task;
+}
+
+std::optional<TaskScheduler::Task>
+TaskScheduler::Worker::Steal() noexcept
+{
+  const std::lock_guard lock{queue_mutex};
+  if (queue.empty())
+    return std::nullopt;
+
+  Task task = std::move(queue.front());
+  queue.pop_front();
+  return task;
+}
+
+bool
+TaskScheduler::Worker::HasTasks() noexcept
+{
+  const std::lock_guard lock{queue_mutex};
+  return !queue.empty();
+}
+
+bool
+TaskScheduler::Worker::Wake() noexcept
+{
+  const std::lock_guard lock{mutex};
+  if (!sleeping || woken)
+    return false;
+
+  woken = true;
+  command_trigger.notify_one();
+  return true;
+}
+
+void
+TaskScheduler::Worker::Run() noexcept
+{
+  if (scheduler.idle_priority)
+    SetIdlePriority();
+
+  std::unique_lock lock{mutex};
+
+  while (!_CheckStoppedOrSuspended(lock)) {
+    {
+      const ScopeUnlock unlock(mutex);
+
+      if (auto task = scheduler.FindTask(this, nullptr)) {
+        Execute(std::move(*task));
+        continue;
+      }
+    }
+
+    /* announce that we're going to sleep and check the queues again
+       while holding the mutex; TaskScheduler::Push() adds the task
+       before it checks the #sleeping flag, so no wakeup can get
+       lost */
+    sleeping = true;
+    if (!woken && !_IsCommandPending() && !scheduler.HasTasks())
+      command_trigger.wait(lock);
+    sleeping = woken = false;
+  }
+}
+
+TaskScheduler::TaskScheduler(unsigned n_threads, bool _idle_priority) noexcept
+  :idle_priority(_idle_priority)
+{
+  workers.reserve(n_threads);
+  for (unsigned i = 0; i < n_threads; ++i)
+    workers.emplace_back(std::make_unique<Worker>(*this));
+}
+
+TaskScheduler::~TaskScheduler() noexcept
+{
+  assert(normal_queue.empty());
+  assert(low_queue.empty());
+}
+
+unsigned
+TaskScheduler::GetDefaultThreadCount() noexcept
+{
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  return std::clamp(n_cpus, 1U, MAX_THREADS + 1) - 1;
+}
+
+void
+TaskScheduler::Start()
+{
+  for (auto &worker : workers)
+    worker->Start();
+}
+
+void
+TaskScheduler::Stop() noexcept
+{
+  for (auto &worker : workers)
+    if (worker->IsDefined())
+      worker->BeginStop();
+
+  for (auto &worker : workers)
+    if (worker->IsDefined())
+      worker->Join();
+}
+
+void
+TaskScheduler::Suspend() noexcept
+{
+  for (auto &worker : workers)
+    worker->BeginSuspend();
+
+  for (auto &worker : workers)
+    worker->WaitUntilSuspended();
+}
+
+void
+TaskScheduler::Resume() noexcept
+{
+  for (auto &worker : workers)
+    worker->Resume();
+}
+
+TaskScheduler::Worker *
+TaskScheduler::FindCurrentWorker() noexcept
+{
+  for (auto &worker : workers)
+    if (worker->IsInside())
+      return worker.get();
+
+  return nullptr;
+}
+
+void
+TaskScheduler::Push(Task &&task, Priority priority) noexcept
+{
+  Worker *const self = priority == Priority::NORMAL
+    ? FindCurrentWorker()
+    : nullptr;
+
+  if (self != nullptr) {
+    self->Push(std::move(task));
+  } else {
+    const std::lock_guard lock{queue_mutex};
+    (priority == Priority::LOW ? low_queue : normal_queue)
+      .push_back(std::move(task));
+  }
+
+  WakeOne();
+}
+
+void
+TaskScheduler::WakeOne() noexcept
+{
+  const std::size_t n = workers.size();
+  if (n == 0)
+    return;
+
+  /* start at a different worker each time to spread the load */
+  const std::size_t start = next_wake.fetch_add(1, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < n; ++i)
+    if (workers[(start + i) % n]->Wake())
+      return;
+}
+
+std::optional<TaskScheduler::Task>
+TaskScheduler::FindTask(Worker *self, const Group *waiting) noexcept
+{
+  if (self != nullptr)
+    if (auto task = self->Pop())
+      return task;
+
+  {
+    const std::lock_guard lock{queue_mutex};
+    if (!normal_queue.empty()) {
+      Task task = std::move(normal_queue.front());
+      normal_queue.pop_front();
+      return task;
+    }
+  }
+
+  const std::size_t n = workers.size();
+  std::size_t start = 0;
+  if (self != nullptr)
+    while (workers[start].get() != self)
+      ++start;
+
+  for (std::size_t i = 1; i <= n; ++i) {
+    Worker &victim = *workers[(start + i) % n];
+    if (&victim != self)
+      if (auto task = victim.Steal())
+        return task;
+  }
+
+  const std::lock_guard lock{queue_mutex};
+  for (auto i = low_queue.begin(); i != low_queue.end(); ++i) {
+    if (waiting == nullptr || i->group == waiting) {
+      Task task = std::move(*i);
+      low_queue.erase(i);
+      return task;
+    }
+  }
+
+  return std::nullopt;
+}
+
+bool
+TaskScheduler::HasTasks() noexcept
+{
+  {
+    const std::lock_guard lock{queue_mutex};
+    if (!normal_queue.empty() || !low_queue.empty())
+      return true;
+  }
+
+  for (auto &worker : workers)
+    if (worker->HasTasks())
+      return true;
+
+  return false;
+}
+
+void
+TaskScheduler::Execute(Task &&task) noexcept
+{
+  Group &group = *task.group;
+
+  std::exception_ptr error;
+  if (!group.IsCancelled()) {
+    try {
+      task.function();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+
+  /* free the closure before the waiter may return */
+  task.function = nullptr;
+
+  group.Done(std::move(error));
+}
+
+void
+TaskScheduler::Group::Spawn(std::function<void()> function,
+                            Priority priority) noexcept
+{
+  {
+    const std::lock_guard lock{mutex};
+    ++pending;
+  }
+
+  scheduler.Push({std::move(function), this}, priority);
+}
+
+bool
+TaskScheduler::Group::IsCancelled() const noexcept
+{
+  return cancelled.load(std::memory_order_relaxed) ||
+    (env != nullptr && env->IsCancelled());
+}
+
+void
+TaskScheduler::Group::Done(std::exception_ptr e) noexcept
+{
+  const std::lock_guard lock{mutex};
+  assert(pending > 0);
+
+  if (e && !error)
+    error = std::move(e);
+
+  if (--pending == 0)
+    cond.notify_all();
+}
+
+void
+TaskScheduler::Group::Wait()
+{
+  Worker *const self = scheduler.FindCurrentWorker();
+
+  std::unique_lock lock{mutex};
+  while (pending > 0) {
+    std::optional<Task> task;
+
+    {
+      const ScopeUnlock unlock(mutex);
+      task = scheduler.FindTask(self, this);
+      if (task)
+        Execute(std::move(*task));
+    }
+
+    if (!task && pending > 0)
+      /* the remaining tasks are being executed by other threads;
+         wake up now and then to help with tasks they may have
+         forked */
+      cond.wait_for(lock, std::chrono::milliseconds(1));
+  }
+
+  if (error)
+    std::rethrow_exception(std::exchange(error, {}));
+}
@@ -0,0 +1,330 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "thread/SuspensibleThread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class OperationEnvironment;
+
+/**
+ * A pool of worker threads executing short tasks on behalf of other
+ * subsystems.  Each worker owns a double-ended queue: tasks forked
+ * by a worker are pushed to (and popped from) the back of its own
+ * queue, while idle workers steal from the front of other workers'
+ * queues.  Tasks submitted by threads outside of the pool go to a
+ * shared queue.
+ *
+ * Tasks are always submitted through a #Group, which implements
+ * fork/join: Group::Wait() blocks until all tasks of the group have
+ * finished, and the waiting thread helps executing queued tasks
+ * meanwhile.  Therefore, a scheduler without any worker threads
+ * (e.g. on a single-core device) still works; the waiting thread
+ * then executes all tasks by itself.
+ *
+ * The workers are #SuspensibleThread instances; Suspend() waits
+ * until all workers have finished their current task.
+ */
+class TaskScheduler {
+public:
+  enum class Priority : uint8_t {
+    NORMAL,
+
+    /**
+     * Only executed if there is no #NORMAL task.  A thread waiting in
+     * Group::Wait() helps only with the #LOW tasks of its own group.
+     */
+    LOW,
+  };
+
+  class Group;
+
+private:
+  struct Task {
+    std::function<void()> function;
+    Group *group;
+  };
+
+  class Worker final : public SuspensibleThread {
+    TaskScheduler &scheduler;
+
+    Mutex queue_mutex;
+    std::deque<Task> queue;
+
+    /**
+     * Is the thread waiting for new tasks?  Protected by
+     * SuspensibleThread::mutex.
+     */
+    bool sleeping = false;
+
+    /**
+     * Was the thread woken up by Wake()?  Protected by
+     * SuspensibleThread::mutex.
+     */
+    bool woken = false;
+
+  public:
+    explicit Worker(TaskScheduler &_scheduler) noexcept
+      :SuspensibleThread("TaskWorker"), scheduler(_scheduler) {}
+
+    using SuspensibleThread::IsInside;
+
+    void Push(Task &&task) noexcept;
+
+    /**
+     * Remove the most recently pushed task (called by the owner).
+     */
+    std::optional<Task> Pop() noexcept;
+
+    /**
+     * Remove the oldest task (called by other threads).
+     */
+    std::optional<Task> Steal() noexcept;
+
+    [[gnu::pure]]
+    bool HasTasks() noexcept;
+
+    /**
+     * Wake up the thread if it is waiting for new tasks.
+     *
+     * @return true if the thread was sleeping
+     */
+    bool Wake() noexcept;
+
+  protected:
+    /* virtual methods from class Thread */
+    void Run() noexcept override;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  /**
+   * Protects #normal_queue and #low_queue.
+   */
+  Mutex queue_mutex;
+
+  /**
+   * Tasks submitted by threads which are not part of this pool, and
+   * all tasks with #Priority::LOW.
+   */
+  std::deque<Task> normal_queue, low_queue;
+
+  std::atomic_uint next_wake{0};
+
+  const bool idle_priority;
+
+public:
+  /**
+   * @param n_threads the number of worker threads; may be 0, see
+   * GetDefaultThreadCount()
+   * @param idle_priority run the worker threads with "idle" priority
+   */
+  explicit TaskScheduler(unsigned n_threads,
+                         bool idle_priority=false) noexcept;
+
+  ~TaskScheduler() noexcept;
+
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+  /**
+   * The recommended number of worker threads: one less than the
+   * number of CPUs, because the thread waiting for a #Group
+   * participates.
+   */
+  [[gnu::pure]]
+  static unsigned GetDefaultThreadCount() noexcept;
+
+  /**
+   * The number of threads which may execute tasks concurrently,
+   * including the thread waiting for a #Group.
+   */
+  unsigned GetConcurrency() const noexcept {
+    return workers.size() + 1;
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start();
+
+  /**
+   * Stop all worker threads and wait for them to exit.  All groups
+   * must have been waited for.
+   */
+  void Stop() noexcept;
+
+  /**
+   * Suspend all worker threads after they have finished their
+   * current task.  Tasks which are submitted meanwhile are only
+   * executed by threads waiting for their #Group.
+   */
+  void Suspend() noexcept;
+
+  void Resume() noexcept;
+
+  /**
+   * Invoke f(chunk_begin, chunk_end) for consecutive sub-ranges of
+   * [begin, end) in parallel and wait for completion.  Rethrows the
+   * first exception thrown by #f.
+   *
+   * @param grain the maximum size of each sub-range; 0 chooses one
+   * automatically
+   * @param env an optional #OperationEnvironment; after it has been
+   * cancelled, no more chunks will be started
+   */
+  template<typename F>
+  void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   F &&f, OperationEnvironment *env=nullptr,
+                   Priority priority=Priority::NORMAL);
+
+private:
+  [[gnu::pure]]
+  Worker *FindCurrentWorker() noexcept;
+
+  void Push(Task &&task, Priority priority) noexcept;
+  void WakeOne() noexcept;
+
+  /**
+   * Look for a task to execute.
+   *
+   * @param self the worker looking for a task, or nullptr if this
+   * is a thread outside of the pool
+   * @param waiting the group this thread is waiting for, or nullptr
+   * if called by an idle worker; limits the #Priority::LOW tasks
+   * which may be returned
+   */
+  std::optional<Task> FindTask(Worker *self,
+                               const Group *waiting) noexcept;
+
+  [[gnu::pure]]
+  bool HasTasks() noexcept;
+
+  static void Execute(Task &&task) noexcept;
+};
+
+/**
+ * A set of tasks which can be waited for (fork/join).  The caller
+ * must call Wait() before destructing this object.
+ */
+class TaskScheduler::Group {
+  friend class TaskScheduler;
+
+  TaskScheduler &scheduler;
+
+  OperationEnvironment *const env;
+
+  Mutex mutex;
+  Cond cond;
+
+  /**
+   * The number of tasks which were spawned and have not yet
+   * finished.  Protected by #mutex.
+   */
+  unsigned pending = 0;
+
+  /**
+   * The first exception thrown by a task.  Protected by #mutex.
+   */
+  std::exception_ptr error;
+
+  std::atomic_bool cancelled{false};
+
+public:
+  /**
+   * @param env an optional #OperationEnvironment; if it gets
+   * cancelled, tasks which have not yet been started are skipped
+   */
+  explicit Group(TaskScheduler &_scheduler,
+                 OperationEnvironment *_env=nullptr) noexcept
+    :scheduler(_scheduler), env(_env) {}
+
+  ~Group() noexcept {
+    assert(pending == 0);
+  }
+
+  Group(const Group &) = delete;
+  Group &operator=(const Group &) = delete;
+
+  void Spawn(std::function<void()> function,
+             Priority priority=Priority::NORMAL) noexcept;
+
+  /**
+   * Skip all tasks which have not yet been started.  Running tasks
+   * may check IsCancelled() to stop early.
+   */
+  void Cancel() noexcept {
+    cancelled.store(true, std::memory_order_relaxed);
+  }
+
+  [[gnu::pure]]
+  bool IsCancelled() const noexcept;
+
+  /**
+   * Wait until all tasks have finished, executing queued tasks in
+   * the meantime.  Rethrows the first exception thrown by a task.
+   */
+  void Wait();
+
+private:
+  void Done(std::exception_ptr e) noexcept;
+};
+
+template<typename F>
+void
+TaskScheduler::ParallelFor(std::size_t begin, std::size_t end,
+                           std::size_t grain, F &&f,
+                           OperationEnvironment *env, Priority priority)
+{
+  if (begin >= end)
+    return;
+
+  const std::size_t size = end - begin;
+  if (grain == 0)
+    /* create a few more chunks than there are threads to balance
+       uneven chunks */
+    grain = std::max<std::size_t>(size / (GetConcurrency() * 4), 1);
+
+  Group group(*this, env);
+
+  for (std::size_t i = begin; i < end; i += std::min(grain, end - i)) {
+    const std::size_t chunk_end = i + std::min(grain, end - i);
+    group.Spawn([&f, i, chunk_end](){ f(i, chunk_end); }, priority);
+  }
+
+  group.Wait();
+}
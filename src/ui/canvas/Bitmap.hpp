@@ -177,6 +177,14 @@ public:
 
   bool Load(ResourceId id, Type type=Type::STANDARD);
 
+#if !defined(USE_GDI) && !defined(ANDROID)
+  /**
+   * Decode the specified resource in the background, to speed up a
+   * later Load() call (see ResourceImageCache::Prefetch()).
+   */
+  static void Prefetch(ResourceId id) noexcept;
+#endif
+
 #ifndef ENABLE_OPENGL
   /**
    * Load a bitmap and stretch it by the specified zoom factor.
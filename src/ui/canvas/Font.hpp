@@ -40,6 +40,7 @@ Copyright_License {
 
 #ifdef USE_FREETYPE
 typedef struct FT_FaceRec_ *FT_Face;
+namespace FreeType { class GlyphCache; }
 #endif
 
 class FontDescription;
@@ -52,6 +53,11 @@ class Font {
 protected:
 #ifdef USE_FREETYPE
   FT_Face face = nullptr;
+
+  /**
+   * Rasterised glyphs of this font; created by LoadFile().
+   */
+  FreeType::GlyphCache *glyph_cache = nullptr;
 #elif defined(ANDROID)
   TextUtil *text_util_object = nullptr;
 
@@ -24,6 +24,8 @@ Copyright_License {
 #include "Icon.hpp"
 #include "Canvas.hpp"
 #include "Screen/Layout.hpp"
+#include "LogFile.hpp"
+#include "thread/Mutex.hxx"
 
 #ifdef ENABLE_OPENGL
 #include "opengl/Texture.hpp"
@@ -57,14 +59,27 @@ IconStretchInteger(unsigned source_dpi) noexcept
 
 #endif
 
+/**
+ * Serialises decoding of icons which are used by more than one
+ * thread (e.g. the UI thread and the DrawThread).
+ */
+static Mutex decode_mutex;
+
 void
-MaskedIcon::LoadResource(ResourceId id, ResourceId big_id, bool center)
+MaskedIcon::LoadResource(ResourceId id, ResourceId big_id, bool _center)
 {
+  Reset();
+
+  scaled = Layout::ScaleEnabled();
+  center = _center;
+
 #ifdef ENABLE_OPENGL
-  unsigned stretch = 1024;
+  stretch = 1024;
+#else
+  zoom = 1;
 #endif
 
-  if (Layout::ScaleEnabled()) {
+  if (scaled) {
     unsigned source_dpi = 96;
     if (big_id.IsDefined()) {
       id = big_id;
@@ -73,16 +88,48 @@ MaskedIcon::LoadResource(ResourceId id, ResourceId big_id, bool center)
 
 #ifdef ENABLE_OPENGL
     stretch = IconStretchFixed10(source_dpi);
-    bitmap.Load(id);
-    bitmap.EnableInterpolation();
 #else
-    bitmap.LoadStretch(id, IconStretchInteger(source_dpi));
+    zoom = IconStretchInteger(source_dpi);
 #endif
-  } else
-    bitmap.Load(id);
+  }
+
+  resource = id;
+}
+
+void
+MaskedIcon::DecodeSlow() const noexcept
+{
+  const std::lock_guard lock{decode_mutex};
+  if (decoded.load(std::memory_order_relaxed))
+    return;
 
   assert(IsDefined());
 
+  try {
+#ifdef ENABLE_OPENGL
+    bitmap.Load(resource);
+    if (scaled)
+      bitmap.EnableInterpolation();
+#else
+    if (scaled)
+      bitmap.LoadStretch(resource, zoom);
+    else
+      bitmap.Load(resource);
+#endif
+  } catch (...) {
+    /* decoding happens while drawing, where the exception cannot be
+       propagated; leave this icon empty */
+    LogError(std::current_exception(), "Failed to decode icon");
+    bitmap.Reset();
+  }
+
+  if (!bitmap.IsDefined()) {
+    size = {0, 0};
+    origin = {0, 0};
+    decoded.store(true, std::memory_order_release);
+    return;
+  }
+
   size = bitmap.GetSize();
 #ifdef ENABLE_OPENGL
   /* let the GPU stretch on-the-fly */
@@ -100,6 +147,17 @@ MaskedIcon::LoadResource(ResourceId id, ResourceId big_id, bool center)
     origin.x = 0;
     origin.y = 0;
   }
+
+  decoded.store(true, std::memory_order_release);
+}
+
+void
+MaskedIcon::Prefetch() const noexcept
+{
+#if !defined(USE_GDI) && !defined(ANDROID)
+  if (IsDefined() && !decoded.load(std::memory_order_relaxed))
+    Bitmap::Prefetch(resource);
+#endif
 }
 
 void
@@ -107,6 +165,10 @@ MaskedIcon::Draw([[maybe_unused]] Canvas &canvas, PixelPoint p) const noexcept
 {
   assert(IsDefined());
 
+  Decode();
+  if (!bitmap.IsDefined())
+    return;
+
   p -= origin;
 
 #ifdef ENABLE_OPENGL
@@ -134,6 +196,12 @@ MaskedIcon::Draw([[maybe_unused]] Canvas &canvas, PixelPoint p) const noexcept
 void
 MaskedIcon::Draw([[maybe_unused]] Canvas &canvas, const PixelRect &rc, bool inverse) const noexcept
 {
+  assert(IsDefined());
+
+  Decode();
+  if (!bitmap.IsDefined())
+    return;
+
   const PixelPoint position = rc.CenteredTopLeft(size);
 
 #ifdef ENABLE_OPENGL
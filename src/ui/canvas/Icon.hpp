@@ -28,37 +28,91 @@ Copyright_License {
 #include "ui/dim/Size.hpp"
 #include "ResourceId.hpp"
 
+#include <atomic>
+
 struct PixelRect;
 class Canvas;
 
 /**
  * An icon with a mask which marks transparent pixels.
+ *
+ * LoadResource() only remembers which resource to use; the bitmap is
+ * decoded when the icon is first drawn or measured.  This keeps the
+ * (many) icons which are not visible on the first screen from
+ * slowing down startup and look changes.
  */
 class MaskedIcon {
 protected:
-  Bitmap bitmap;
+  mutable Bitmap bitmap;
+
+  mutable PixelSize size;
+
+  mutable PixelPoint origin;
+
+  /**
+   * The resource which will be decoded by Decode().
+   */
+  ResourceId resource = ResourceId::Null();
+
+#ifdef ENABLE_OPENGL
+  /**
+   * The stretch factor (fixed point, 10 bits) applied by the GPU.
+   */
+  unsigned stretch;
+#else
+  /**
+   * The integer zoom factor passed to Bitmap::LoadStretch().
+   */
+  unsigned zoom;
+#endif
 
-  PixelSize size;
+  bool scaled, center;
 
-  PixelPoint origin;
+  /**
+   * Has #resource been decoded into #bitmap?
+   */
+  mutable std::atomic_bool decoded{false};
 
 public:
   const PixelSize &GetSize() const noexcept {
+    Decode();
     return size;
   }
 
   bool IsDefined() const noexcept {
-    return bitmap.IsDefined();
+    return resource.IsDefined();
   }
 
   void LoadResource(ResourceId id, ResourceId big_id = ResourceId::Null(),
                     bool center=true);
 
   void Reset() noexcept {
+    resource = ResourceId::Null();
+    decoded.store(false, std::memory_order_relaxed);
     bitmap.Reset();
   }
 
+  /**
+   * Decode the bitmap in the background if that has not been done
+   * yet, so the first Draw() call does not have to wait for the
+   * decoder.
+   */
+  void Prefetch() const noexcept;
+
   void Draw(Canvas &canvas, PixelPoint p) const noexcept;
 
   void Draw(Canvas &canvas, const PixelRect &rc, bool inverse) const noexcept;
+
+private:
+  /**
+   * Decode the bitmap if that has not been done yet.  This may be
+   * called from any thread which draws.  If decoding fails, the
+   * error is logged and the icon remains empty (zero size).
+   */
+  void Decode() const noexcept {
+    if (!decoded.load(std::memory_order_acquire))
+      DecodeSlow();
+  }
+
+  void DecodeSlow() const noexcept;
 };
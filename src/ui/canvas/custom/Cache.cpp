@@ -33,12 +33,16 @@ Copyright_License {
 #include "ui/canvas/opengl/Debug.hpp"
 #else
 #include "thread/Mutex.hxx"
+
+#include <algorithm>
+#include <vector>
 #endif
 
 #ifdef UNICODE
 #include "util/ConvertString.hpp"
 #endif
 
+#include <atomic>
 #include <cassert>
 #include <memory>
 
@@ -167,27 +171,133 @@ struct RenderedText {
   }
 };
 
+/**
+ * The cached sizes and rendered strings of one thread.
+ */
+struct TextCacheInstance {
+  Cache<TextCacheKey, PixelSize, 1024u, 701u, TextCacheKey::Hash> size_cache;
+  Cache<TextCacheKey, RenderedText, 256u, 211u, TextCacheKey::Hash> text_cache;
+
+  /**
+   * Written only by the owning thread, but may be read by
+   * TextCache::GetStatistics() in another thread.
+   */
+  std::atomic<unsigned long> size_hits{0}, size_misses{0};
+  std::atomic<unsigned long> text_hits{0}, text_misses{0};
+
 #ifndef ENABLE_OPENGL
+  /**
+   * The #flush_generation this cache was last cleared at.
+   */
+  unsigned generation;
+
+  TextCacheInstance() noexcept;
+  ~TextCacheInstance() noexcept;
+#endif
+
+  static void Count(std::atomic<unsigned long> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  void Clear() noexcept {
+    size_cache.Clear();
+    text_cache.Clear();
+  }
+};
+
+#ifdef ENABLE_OPENGL
+
+/**
+ * With OpenGL, this library is only used by the OpenGL thread.
+ */
+static TextCacheInstance instance;
+
+static TextCacheInstance &
+GetInstance() noexcept
+{
+  return instance;
+}
+
+#else
+
 /**
  * Without OpenGL, this library is accessed from DrawThread and UI
- * thread, therefore we need to protect it.
+ * thread.  Instead of serialising them on one global cache, each
+ * thread gets its own cache, which needs no locking at all.  This
+ * also guarantees that a #Result stays valid until the same thread
+ * calls TextCache::Get() again.
  */
-static Mutex text_cache_mutex;
-#endif
+static thread_local std::unique_ptr<TextCacheInstance> thread_instance;
+
+/**
+ * Incremented by TextCache::Flush(); each thread clears its own cache
+ * on its next access.
+ */
+static std::atomic<unsigned> flush_generation;
 
-static Cache<TextCacheKey, PixelSize, 1024u, 701u, TextCacheKey::Hash> size_cache;
-static Cache<TextCacheKey, RenderedText, 256u, 211u, TextCacheKey::Hash> text_cache;
+/**
+ * Protects #instances and #retired.
+ */
+static Mutex instances_mutex;
+
+/**
+ * All live #TextCacheInstance objects, for TextCache::GetStatistics().
+ */
+static std::vector<const TextCacheInstance *> instances;
+
+/**
+ * The counters of threads which have exited.
+ */
+static TextCache::Statistics retired;
+
+TextCacheInstance::TextCacheInstance() noexcept
+  :generation(flush_generation.load(std::memory_order_acquire))
+{
+  const std::lock_guard lock{instances_mutex};
+  instances.push_back(this);
+}
+
+TextCacheInstance::~TextCacheInstance() noexcept
+{
+  const std::lock_guard lock{instances_mutex};
+  instances.erase(std::find(instances.begin(), instances.end(), this));
+
+  retired.size_hits += size_hits;
+  retired.size_misses += size_misses;
+  retired.text_hits += text_hits;
+  retired.text_misses += text_misses;
+}
+
+static TextCacheInstance &
+GetInstance() noexcept
+{
+  if (!thread_instance) {
+    thread_instance = std::make_unique<TextCacheInstance>();
+  } else if (const unsigned generation =
+             flush_generation.load(std::memory_order_acquire);
+             thread_instance->generation != generation) {
+    thread_instance->Clear();
+    thread_instance->generation = generation;
+  }
+
+  return *thread_instance;
+}
+
+#endif
 
 PixelSize
 TextCache::GetSize(const Font &font, std::string_view text) noexcept
 {
-#ifndef ENABLE_OPENGL
-  const std::lock_guard lock{text_cache_mutex};
-#endif
+  auto &instance = GetInstance();
 
   TextCacheKey key(font, text);
-  if (const PixelSize *cached = size_cache.Get(key))
+  if (const PixelSize *cached = instance.size_cache.Get(key)) {
+    instance.Count(instance.size_hits);
     return *cached;
+  }
+
+  instance.Count(instance.size_misses);
 
 #ifdef UNICODE
   PixelSize size = font.TextSize(UTF8ToWideConverter(text));
@@ -196,22 +306,20 @@ TextCache::GetSize(const Font &font, std::string_view text) noexcept
 #endif
 
   key.Allocate();
-  size_cache.Put(std::move(key), size);
+  instance.size_cache.Put(std::move(key), size);
   return size;
 }
 
 PixelSize
 TextCache::LookupSize(const Font &font, std::string_view text) noexcept
 {
-#ifndef ENABLE_OPENGL
-  const std::lock_guard lock{text_cache_mutex};
-#endif
-
   if (text.empty())
     return {};
 
+  auto &instance = GetInstance();
+
   TextCacheKey key(font, text);
-  const RenderedText *cached = text_cache.Get(key);
+  const RenderedText *cached = instance.text_cache.Get(key);
   if (cached == nullptr)
     return {};
 
@@ -233,15 +341,16 @@ TextCache::Get(const Font &font, std::string_view text) noexcept
 
   /* look it up */
 
-#ifndef ENABLE_OPENGL
-  const std::lock_guard lock{text_cache_mutex};
-#endif
+  auto &instance = GetInstance();
 
-  if (const RenderedText *cached = text_cache.Get(key))
+  if (const RenderedText *cached = instance.text_cache.Get(key)) {
+    instance.Count(instance.text_hits);
     return *cached;
+  }
 
-  /* render the text into a OpenGL texture */
+  instance.Count(instance.text_misses);
 
+  /* render the text into a OpenGL texture */
 #if defined(USE_FREETYPE) || defined(USE_APPKIT) || defined(USE_UIKIT)
 #ifdef UNICODE
   UTF8ToWideConverter text2(text);
@@ -277,7 +386,7 @@ TextCache::Get(const Font &font, std::string_view text) noexcept
   Result result = rt;
 
   key.Allocate();
-  text_cache.Put(std::move(key), std::move(rt));
+  instance.text_cache.Put(std::move(key), std::move(rt));
 
   /* done */
 
@@ -289,12 +398,38 @@ TextCache::Flush() noexcept
 {
 #ifdef ENABLE_OPENGL
   assert(pthread_equal(pthread_self(), OpenGL::thread));
-#endif
 
-#ifndef ENABLE_OPENGL
-  const std::lock_guard lock{text_cache_mutex};
+  instance.Clear();
+#else
+  /* other threads will notice this on their next access */
+  flush_generation.fetch_add(1, std::memory_order_release);
 #endif
+}
+
+TextCache::Statistics
+TextCache::GetStatistics() noexcept
+{
+#ifdef ENABLE_OPENGL
+  const auto &i = instance;
+
+  return {
+    i.size_hits, i.size_misses,
+    i.text_hits, i.text_misses,
+    1,
+  };
+#else
+  const std::lock_guard lock{instances_mutex};
 
-  size_cache.Clear();
-  text_cache.Clear();
+  Statistics result = retired;
+  result.n_threads = instances.size();
+
+  for (const auto *i : instances) {
+    result.size_hits += i->size_hits.load(std::memory_order_relaxed);
+    result.size_misses += i->size_misses.load(std::memory_order_relaxed);
+    result.text_hits += i->text_hits.load(std::memory_order_relaxed);
+    result.text_misses += i->text_misses.load(std::memory_order_relaxed);
+  }
+
+  return result;
+#endif
 }
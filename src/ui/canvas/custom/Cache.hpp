@@ -70,4 +70,22 @@ Get(const Font &font, std::string_view text) noexcept;
 void
 Flush() noexcept;
 
+struct Statistics {
+  unsigned long size_hits, size_misses;
+  unsigned long text_hits, text_misses;
+
+  /**
+   * The number of threads which currently own a cache.
+   */
+  unsigned n_threads;
+};
+
+/**
+ * Obtain the cache counters summed over all threads (including
+ * threads which have already exited).  Only misses need to call the
+ * font renderer; hits never block on another thread.
+ */
+Statistics
+GetStatistics() noexcept;
+
 } //namespace TextCache
@@ -25,6 +25,14 @@ Copyright_License {
 #include "Screen/Debug.hpp"
 #include "ResourceLoader.hpp"
 #include "ResourceId.hpp"
+#include "ResourceImageCache.hpp"
+#include "UncompressedImage.hpp"
+
+#ifdef ENABLE_COREGRAPHICS
+#include "../apple/ImageDecoder.hpp"
+#else
+#include "LibPNG.hpp"
+#endif
 
 #ifdef ENABLE_OPENGL
 
@@ -53,7 +61,30 @@ Bitmap::Load(ResourceId id, Type type)
   if (data.data() == nullptr)
     return false;
 
-  return Load(data, type);
+  auto uncompressed = ResourceImageCache::Load(data);
+  if (!uncompressed.IsDefined()) {
+    uncompressed = LoadPNG(data.data(), data.size());
+    if (!uncompressed.IsDefined())
+      return false;
+
+    /* this may be the DrawThread; let the cache write the file in
+       background */
+    ResourceImageCache::SaveAsync(data, uncompressed);
+  }
+
+  return Load(std::move(uncompressed), type);
+}
+
+void
+Bitmap::Prefetch(ResourceId id) noexcept
+{
+  ResourceLoader::Data data = ResourceLoader::Load(id);
+  if (data.data() == nullptr)
+    return;
+
+  ResourceImageCache::Prefetch(data, [](std::span<const std::byte> compressed){
+    return LoadPNG(compressed.data(), compressed.size());
+  });
 }
 
 #ifdef USE_MEMORY_CANVAS
@@ -0,0 +1,349 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "ResourceImageCache.hpp"
+#include "UncompressedImage.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileMapping.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/StandbyThread.hpp"
+#include "util/StringFormat.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+
+static constexpr uint32_t RESOURCE_IMAGE_CACHE_MAGIC = 0x3e9c0a71;
+
+struct ResourceImageHeader {
+  uint32_t magic;
+  uint8_t format;
+  uint8_t flipped;
+  uint16_t reserved;
+  uint32_t width, height, pitch;
+
+  /**
+   * The size of the compressed data, to detect hash collisions.
+   */
+  uint64_t compressed_size;
+};
+
+static Mutex directory_mutex;
+static AllocatedPath directory = nullptr;
+
+[[gnu::pure]]
+static uint64_t
+HashData(std::span<const std::byte> data) noexcept
+{
+  /* FNV-1a */
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const std::byte i : data) {
+    hash ^= uint8_t(i);
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+/**
+ * Returns the cache file path for the given compressed data, or
+ * nullptr if the cache is disabled.
+ */
+static AllocatedPath
+MakeCachePath(std::span<const std::byte> compressed) noexcept
+{
+  TCHAR name[32];
+  StringFormat(name, std::size(name), _T("image-%016llx"),
+               (unsigned long long)HashData(compressed));
+
+  const std::lock_guard lock{directory_mutex};
+  if (directory == nullptr)
+    return nullptr;
+
+  return AllocatedPath::Build(directory, name);
+}
+
+/**
+ * Read the cache file for the given compressed data.
+ */
+static UncompressedImage
+LoadFile(std::span<const std::byte> compressed) noexcept
+{
+  const auto path = MakeCachePath(compressed);
+  if (path == nullptr || !File::Exists(path))
+    return {};
+
+  try {
+    const FileMapping mapping(path);
+    if (mapping.size() < sizeof(ResourceImageHeader))
+      return {};
+
+    ResourceImageHeader header;
+    memcpy(&header, mapping.data(), sizeof(header));
+
+    const std::size_t data_size = std::size_t(header.pitch) * header.height;
+    if (header.magic != RESOURCE_IMAGE_CACHE_MAGIC ||
+        header.compressed_size != compressed.size() ||
+        header.format == uint8_t(UncompressedImage::Format::INVALID) ||
+        header.format > uint8_t(UncompressedImage::Format::GRAY) ||
+        mapping.size() != sizeof(header) + data_size)
+      return {};
+
+    std::unique_ptr<uint8_t[]> data(new uint8_t[data_size]);
+    memcpy(data.get(), mapping.at(sizeof(header)), data_size);
+
+    return UncompressedImage(UncompressedImage::Format(header.format),
+                             header.pitch, header.width, header.height,
+                             std::move(data), header.flipped);
+  } catch (...) {
+    return {};
+  }
+}
+
+void
+ResourceImageCache::Save(std::span<const std::byte> compressed,
+                         const UncompressedImage &image) noexcept
+{
+  const auto path = MakeCachePath(compressed);
+  if (path == nullptr)
+    return;
+
+  ResourceImageHeader header{};
+  header.magic = RESOURCE_IMAGE_CACHE_MAGIC;
+  header.format = uint8_t(image.GetFormat());
+  header.flipped = image.IsFlipped();
+  header.width = image.GetWidth();
+  header.height = image.GetHeight();
+  header.pitch = image.GetPitch();
+  header.compressed_size = compressed.size();
+
+  try {
+    Directory::Create(path.GetParent());
+
+    /* the file appears atomically on Commit(), so concurrent
+       readers never see a partial entry */
+    FileOutputStream os(path);
+    os.Write(&header, sizeof(header));
+    os.Write(image.GetData(), std::size_t(header.pitch) * header.height);
+    os.Commit();
+  } catch (...) {
+  }
+}
+
+/**
+ * The background thread which writes cache files and decodes images
+ * for ResourceImageCache::Prefetch().
+ */
+class ResourceImageCacheThread final : StandbyThread {
+  struct PendingSave {
+    std::span<const std::byte> compressed;
+    UncompressedImage image;
+  };
+
+  struct PendingPrefetch {
+    std::span<const std::byte> compressed;
+    ResourceImageCache::Decoder decoder;
+  };
+
+  /* the following attributes are protected by StandbyThread::mutex */
+
+  std::list<PendingSave> saves;
+  std::list<PendingPrefetch> prefetches;
+
+  /**
+   * Images decoded by Tick() which have not yet been picked up by
+   * Take(), keyed by the address of the compressed data.
+   */
+  std::map<const std::byte *, UncompressedImage> prefetched;
+
+public:
+  ResourceImageCacheThread() noexcept
+    :StandbyThread("ImageCache") {}
+
+  void AddSave(std::span<const std::byte> compressed,
+               UncompressedImage &&image) noexcept {
+    const std::lock_guard lock{mutex};
+    saves.push_back({compressed, std::move(image)});
+    TryTrigger();
+  }
+
+  void AddPrefetch(std::span<const std::byte> compressed,
+                   ResourceImageCache::Decoder decoder) noexcept {
+    const std::lock_guard lock{mutex};
+    prefetches.push_back({compressed, decoder});
+    TryTrigger();
+  }
+
+  UncompressedImage Take(std::span<const std::byte> compressed) noexcept {
+    const std::lock_guard lock{mutex};
+    auto i = prefetched.find(compressed.data());
+    if (i == prefetched.end())
+      return {};
+
+    auto image = std::move(i->second);
+    prefetched.erase(i);
+    return image;
+  }
+
+  void Flush() noexcept {
+    LockWaitDone();
+  }
+
+  /**
+   * Finish pending work, stop the thread and free all prefetched
+   * images.
+   */
+  void StopAndClear() noexcept {
+    std::unique_lock lock{mutex};
+    WaitDone(lock);
+    Stop();
+    saves.clear();
+    prefetches.clear();
+    prefetched.clear();
+  }
+
+private:
+  void TryTrigger() noexcept {
+    try {
+      Trigger();
+    } catch (...) {
+      /* without a thread, the work is simply not done; the
+         drawing code decodes all images by itself */
+      saves.clear();
+      prefetches.clear();
+    }
+  }
+
+  void RunPrefetch(const PendingPrefetch &p) noexcept;
+
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override;
+};
+
+inline void
+ResourceImageCacheThread::RunPrefetch(const PendingPrefetch &p) noexcept
+{
+  if (prefetched.find(p.compressed.data()) != prefetched.end())
+    return;
+
+  UncompressedImage image;
+
+  {
+    const ScopeUnlock unlock(mutex);
+
+    image = LoadFile(p.compressed);
+    if (!image.IsDefined()) {
+      try {
+        image = p.decoder(p.compressed);
+      } catch (...) {
+        /* the error will be reported when the image is loaded
+           again while drawing */
+        return;
+      }
+
+      if (image.IsDefined())
+        ResourceImageCache::Save(p.compressed, image);
+    }
+  }
+
+  if (image.IsDefined())
+    prefetched.emplace(p.compressed.data(), std::move(image));
+}
+
+void
+ResourceImageCacheThread::Tick() noexcept
+{
+  SetIdlePriority();
+
+  while (!IsStopped()) {
+    if (!prefetches.empty()) {
+      const auto p = prefetches.front();
+      prefetches.pop_front();
+      RunPrefetch(p);
+    } else if (!saves.empty()) {
+      const auto save = std::move(saves.front());
+      saves.pop_front();
+
+      const ScopeUnlock unlock(mutex);
+      ResourceImageCache::Save(save.compressed, save.image);
+    } else
+      break;
+  }
+}
+
+static ResourceImageCacheThread cache_thread;
+
+void
+ResourceImageCache::SetDirectory(Path _directory) noexcept
+{
+  if (_directory == nullptr)
+    cache_thread.StopAndClear();
+
+  const std::lock_guard lock{directory_mutex};
+  directory = _directory;
+}
+
+UncompressedImage
+ResourceImageCache::Load(std::span<const std::byte> compressed) noexcept
+{
+  auto image = cache_thread.Take(compressed);
+  if (!image.IsDefined())
+    image = LoadFile(compressed);
+  return image;
+}
+
+void
+ResourceImageCache::SaveAsync(std::span<const std::byte> compressed,
+                              const UncompressedImage &image) noexcept
+{
+  {
+    const std::lock_guard lock{directory_mutex};
+    if (directory == nullptr)
+      return;
+  }
+
+  const std::size_t data_size = image.GetPitch() * image.GetHeight();
+  std::unique_ptr<uint8_t[]> data(new uint8_t[data_size]);
+  memcpy(data.get(), image.GetData(), data_size);
+
+  cache_thread.AddSave(compressed,
+                       UncompressedImage(image.GetFormat(), image.GetPitch(),
+                                         image.GetWidth(), image.GetHeight(),
+                                         std::move(data), image.IsFlipped()));
+}
+
+void
+ResourceImageCache::Prefetch(std::span<const std::byte> compressed,
+                             Decoder decoder) noexcept
+{
+  cache_thread.AddPrefetch(compressed, decoder);
+}
+
+void
+ResourceImageCache::Flush() noexcept
+{
+  cache_thread.Flush();
+}
@@ -0,0 +1,107 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+class Path;
+class UncompressedImage;
+
+/**
+ * An on-disk cache of decoded resource images.  Decoding a PNG is a
+ * considerable part of the startup time on slow devices; reading the
+ * raw pixels back from a file is much cheaper.
+ *
+ * Entries are keyed by a hash of the compressed image data, so a new
+ * program version with different resources never picks up stale
+ * entries.  The cache is disabled until SetDirectory() is called.
+ *
+ * Writing files and decoding images ahead of time is done by a
+ * background thread, so callers on the drawing path never wait for
+ * file I/O or for the decoder of another image.
+ *
+ * All functions are thread-safe.
+ */
+namespace ResourceImageCache {
+
+/**
+ * A function which decodes compressed image data, e.g. LoadPNG().
+ * It may throw.
+ */
+using Decoder = UncompressedImage (*)(std::span<const std::byte> compressed);
+
+/**
+ * Enable the cache, storing its files in the given directory.  Pass
+ * nullptr to disable it; this waits for the background thread to
+ * finish pending work, stops it and frees all images which were
+ * prefetched but not yet used.
+ */
+void
+SetDirectory(Path directory) noexcept;
+
+/**
+ * Look up the decoded image for the given compressed data.  An image
+ * prepared by Prefetch() is returned (and forgotten) first; otherwise
+ * the cache file is read.
+ *
+ * @return the image or an undefined #UncompressedImage on cache miss
+ */
+UncompressedImage
+Load(std::span<const std::byte> compressed) noexcept;
+
+/**
+ * Store the decoded image for the given compressed data.  This
+ * writes the file synchronously; callers on the drawing path should
+ * use SaveAsync() instead.  Errors are ignored.
+ */
+void
+Save(std::span<const std::byte> compressed,
+     const UncompressedImage &image) noexcept;
+
+/**
+ * Like Save(), but copy the image and write it in the background.
+ * The compressed data must remain valid until SetDirectory(nullptr)
+ * returns (resources are static).
+ */
+void
+SaveAsync(std::span<const std::byte> compressed,
+          const UncompressedImage &image) noexcept;
+
+/**
+ * Prepare the decoded image for the given compressed data in the
+ * background, from the cache file or with the given decoder, so a
+ * later Load() call returns it immediately.  The compressed data
+ * must remain valid until SetDirectory(nullptr) returns.
+ */
+void
+Prefetch(std::span<const std::byte> compressed, Decoder decoder) noexcept;
+
+/**
+ * Wait until the background thread has finished all pending work.
+ */
+void
+Flush() noexcept;
+
+} // namespace ResourceImageCache
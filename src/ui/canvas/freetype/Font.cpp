@@ -48,6 +48,8 @@ Copyright_License {
 #include FT_FREETYPE_H
 
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 #include <cassert>
 #include <cstdint>
@@ -111,6 +113,212 @@ NextChar(tstring_view &s) noexcept
 #endif
 }
 
+static void
+ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n) noexcept
+{
+  for (; n >= 8; n -= 8, ++src) {
+    for (unsigned i = 0x80; i != 0; i >>= 1)
+      *dest++ = (*src & i) ? 0xff : 0x00;
+  }
+
+  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
+    *dest++ = (*src & i) ? 0xff : 0x00;
+}
+
+namespace FreeType {
+
+/**
+ * Remembers the metrics of all glyphs used with one #Font, and keeps
+ * their rasterised bitmaps (8 bits per pixel, tightly packed) in one
+ * growing "atlas" buffer.  This way, FreeType needs to load and
+ * render each glyph only once, and rendering a string just copies
+ * pixels from the atlas.
+ *
+ * The caller is responsible for locking.
+ */
+class GlyphCache {
+  /**
+   * Flush everything when this number of glyphs is exceeded; this
+   * protects against unbounded growth with exotic scripts.
+   */
+  static constexpr std::size_t MAX_GLYPHS = 1024;
+
+  /**
+   * Discard all bitmaps when the atlas grows beyond this number of
+   * bytes.  The metrics are kept.
+   */
+  static constexpr std::size_t MAX_ATLAS_SIZE = 256 * 1024;
+
+  static constexpr std::size_t MAX_KERNING = 4096;
+
+public:
+  struct Glyph {
+    /**
+     * The FreeType glyph index; 0 if the font does not have this
+     * character or if it failed to load.
+     */
+    FT_UInt index;
+
+    /**
+     * The position of the bitmap relative to the pen position
+     * (x) and the baseline (y, upwards).
+     */
+    int left, top;
+
+    /**
+     * The right edge of the glyph's outline relative to the pen
+     * position.
+     */
+    int right;
+
+    int advance;
+
+    /**
+     * The bitmap in the atlas; only valid if #rendered is set.
+     */
+    std::size_t offset;
+    unsigned width, rows;
+    bool rendered;
+  };
+
+private:
+  std::unordered_map<unsigned, Glyph> glyphs;
+
+  /**
+   * Horizontal kerning in pixels; the key combines the two glyph
+   * indexes.
+   */
+  std::unordered_map<uint_least64_t, int> kerning;
+
+  std::vector<uint8_t> atlas;
+
+  /**
+   * The IsMono() setting the bitmaps were rendered with.
+   */
+  bool mono = IsMono();
+
+public:
+  /**
+   * Look up a glyph, loading it if it is not yet known.
+   *
+   * @param need_bitmap if true, the bitmap is rendered into the
+   * atlas
+   * @return nullptr if the font does not have this character; the
+   * pointer is valid until the next call
+   */
+  const Glyph *Get(FT_Face face, unsigned ch, bool need_bitmap) noexcept {
+    if (mono != IsMono()) {
+      /* the Kobo may switch between mono and greyscale at runtime */
+      glyphs.clear();
+      atlas.clear();
+      mono = IsMono();
+    }
+
+    auto i = glyphs.find(ch);
+    if (i == glyphs.end()) {
+      if (glyphs.size() >= MAX_GLYPHS) {
+        glyphs.clear();
+        atlas.clear();
+      }
+
+      i = glyphs.emplace(ch, Load(face, ch)).first;
+      if (i->second.index != 0 && need_bitmap)
+        /* the glyph slot is still loaded; render it right away */
+        Render(i->second, face->glyph);
+    } else if (i->second.index != 0 && need_bitmap && !i->second.rendered &&
+               FT_Load_Glyph(face, i->second.index, load_flags) == 0)
+      Render(i->second, face->glyph);
+
+    const Glyph &glyph = i->second;
+    if (glyph.index == 0)
+      return nullptr;
+
+    return &glyph;
+  }
+
+  const uint8_t *GetBitmap(const Glyph &glyph) const noexcept {
+    assert(glyph.rendered);
+
+    return atlas.data() + glyph.offset;
+  }
+
+  int GetKerning(FT_Face face, FT_UInt prev, FT_UInt next) noexcept {
+    const uint_least64_t key = (uint_least64_t(prev) << 32) | next;
+    if (auto i = kerning.find(key); i != kerning.end())
+      return i->second;
+
+    if (kerning.size() >= MAX_KERNING)
+      kerning.clear();
+
+    FT_Vector delta;
+    FT_Get_Kerning(face, prev, next, ft_kerning_default, &delta);
+    const int x = delta.x >> 6;
+    kerning.emplace(key, x);
+    return x;
+  }
+
+private:
+  static Glyph Load(FT_Face face, unsigned ch) noexcept {
+    Glyph glyph{};
+    glyph.index = FT_Get_Char_Index(face, ch);
+    if (glyph.index == 0)
+      return glyph;
+
+    if (FT_Load_Glyph(face, glyph.index, load_flags) != 0) {
+      glyph.index = 0;
+      return glyph;
+    }
+
+    const FT_Glyph_Metrics &metrics = face->glyph->metrics;
+    glyph.left = FT_FLOOR(metrics.horiBearingX);
+    glyph.top = FT_FLOOR(metrics.horiBearingY);
+    glyph.right = glyph.left + FT_CEIL(metrics.width);
+    glyph.advance = FT_CEIL(metrics.horiAdvance);
+    return glyph;
+  }
+
+  /**
+   * Render the glyph which is currently loaded in the slot and
+   * append its bitmap to the atlas.
+   */
+  void Render(Glyph &glyph, FT_GlyphSlot slot) noexcept {
+    if (FT_Render_Glyph(slot, render_mode) != 0)
+      return;
+
+    const FT_Bitmap &bitmap = slot->bitmap;
+    const std::size_t size = std::size_t(bitmap.width) * bitmap.rows;
+
+    if (atlas.size() + size > MAX_ATLAS_SIZE) {
+      /* start over; only the bitmaps are lost, the metrics (and
+         the caller's pointer) remain valid */
+      atlas.clear();
+      for (auto &i : glyphs)
+        i.second.rendered = false;
+    }
+
+    glyph.offset = atlas.size();
+    glyph.width = bitmap.width;
+    glyph.rows = bitmap.rows;
+    atlas.resize(atlas.size() + size);
+
+    uint8_t *dest = atlas.data() + glyph.offset;
+    const uint8_t *src = bitmap.buffer;
+    for (unsigned y = 0; y < glyph.rows;
+         ++y, dest += glyph.width, src += bitmap.pitch) {
+      if (mono)
+        /* with anti-aliasing disabled, FreeType writes each pixel
+           in one bit; convert it to 1 byte per pixel */
+        ConvertMono(dest, src, glyph.width);
+      else
+        std::copy_n(src, glyph.width, dest);
+    }
+
+    glyph.rendered = true;
+  }
+};
+
+} // namespace FreeType
+
 void
 Font::Initialise()
 {
@@ -182,6 +390,7 @@ Font::LoadFile(const char *file, unsigned ptsize, [[maybe_unused]] bool bold, [[
   // TODO: handle bold/italic
 
   face = new_face;
+  glyph_cache = new FreeType::GlyphCache();
 }
 
 void
@@ -225,6 +434,9 @@ Font::Destroy() noexcept
 
   assert(IsScreenInitialized());
 
+  delete glyph_cache;
+  glyph_cache = nullptr;
+
   ::FT_Done_Face(face);
   face = nullptr;
 }
@@ -245,48 +457,36 @@ ForEachChar(tstring_view text, F &&f)
 
 template<typename T, typename F>
 static void
-ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
+ForEachGlyph(const FT_Face face, FreeType::GlyphCache &cache,
+             unsigned ascent_height, T &&text, bool need_bitmap,
              F &&f) noexcept
 {
   const bool use_kerning = FT_HAS_KERNING(face);
 
   int x = 0;
-  unsigned prev_index = 0;
+  FT_UInt prev_index = 0;
 
 #ifndef ENABLE_OPENGL
   const std::lock_guard lock{freetype_mutex};
 #endif
 
   ForEachChar(std::forward<T>(text),
-              [face, ascent_height, &f, use_kerning,
+              [face, &cache, ascent_height, need_bitmap, &f, use_kerning,
                &x, &prev_index](unsigned ch){
-      const FT_UInt i = FT_Get_Char_Index(face, ch);
-      if (i == 0)
-        return;
-
-      const FT_Error error = FT_Load_Glyph(face, i, load_flags);
-      if (error)
+      const auto *glyph = cache.Get(face, ch, need_bitmap);
+      if (glyph == nullptr)
         return;
 
-      const FT_GlyphSlot glyph = face->glyph;
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-
       if (use_kerning) {
-        if (prev_index != 0 && i != 0) {
-          FT_Vector delta;
-          FT_Get_Kerning(face, prev_index, i, ft_kerning_default,
-                         &delta);
-          x += delta.x >> 6;
-        }
-
-        prev_index = i;
+        if (prev_index != 0)
+          x += cache.GetKerning(face, prev_index, glyph->index);
+
+        prev_index = glyph->index;
       }
 
-      f(x + FT_FLOOR(metrics.horiBearingX),
-        ascent_height - FT_FLOOR(metrics.horiBearingY),
-        glyph);
+      f(x + glyph->left, ascent_height - glyph->top, *glyph);
 
-      x += FT_CEIL(metrics.horiAdvance);
+      x += glyph->advance;
     });
 }
 
@@ -295,13 +495,10 @@ Font::TextSize(tstring_view text) const noexcept
 {
   int maxx = 0;
 
-  ForEachGlyph(face, ascent_height, text,
-               [&maxx](int x, [[maybe_unused]] int y, const FT_GlyphSlot glyph){
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-      const int glyph_minx = FT_FLOOR(metrics.horiBearingX);
-      const int glyph_maxx = glyph_minx + FT_CEIL(metrics.width);
-
-      int z = x + glyph_maxx;
+  ForEachGlyph(face, *glyph_cache, ascent_height, text, false,
+               [&maxx](int x, [[maybe_unused]] int y,
+                       const FreeType::GlyphCache::Glyph &glyph){
+      int z = x + glyph.right;
       if (z > maxx)
         maxx = z;
     });
@@ -319,11 +516,10 @@ MixLine(uint8_t *dest, const uint8_t *src, size_t n) noexcept
 
 static void
 RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
-            const FT_Bitmap &bitmap, int x, int y) noexcept
+            const uint8_t *src, int width, int height,
+            int x, int y) noexcept
 {
-  const uint8_t *src = (const uint8_t *)bitmap.buffer;
-  int width = bitmap.width, height = bitmap.rows;
-  int pitch = bitmap.pitch;
+  const int pitch = width;
 
   if (x < 0) {
     src -= x;
@@ -355,50 +551,6 @@ RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
     MixLine(buffer, src, width);
 }
 
-static void
-ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n) noexcept
-{
-  for (; n >= 8; n -= 8, ++src) {
-    for (unsigned i = 0x80; i != 0; i >>= 1)
-      *dest++ = (*src & i) ? 0xff : 0x00;
-  }
-
-  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
-    *dest++ = (*src & i) ? 0xff : 0x00;
-}
-
-static void
-ConvertMono(FT_Bitmap &dest, const FT_Bitmap &src) noexcept
-{
-  dest = src;
-  dest.pitch = dest.width;
-  dest.buffer = new unsigned char[dest.pitch * dest.rows];
-
-  unsigned char *d = dest.buffer, *s = src.buffer;
-  for (unsigned y = 0; y < unsigned(dest.rows);
-       ++y, d += dest.pitch, s += src.pitch)
-    ConvertMono(d, s, dest.width);
-}
-
-static void
-RenderGlyph(uint8_t *buffer, size_t width, size_t height,
-            FT_GlyphSlot glyph, int x, int y) noexcept
-{
-  FT_Error error = FT_Render_Glyph(glyph, render_mode);
-  if (error)
-    return;
-
-  if (IsMono()) {
-    /* with anti-aliasing disabled, FreeType writes each pixel in one
-       bit; hack: convert it to 1 byte per pixel and then render it */
-    FT_Bitmap bitmap;
-    ConvertMono(bitmap, glyph->bitmap);
-    RenderGlyph(buffer, width, height, bitmap, x, y);
-    delete[] bitmap.buffer;
-  } else
-    RenderGlyph(buffer, width, height, glyph->bitmap, x, y);
-}
-
 void
 Font::Render(tstring_view text, const PixelSize size,
              void *_buffer) const noexcept
@@ -406,9 +558,13 @@ Font::Render(tstring_view text, const PixelSize size,
   uint8_t *buffer = (uint8_t *)_buffer;
   std::fill_n(buffer, BufferSize(size), 0);
 
-  ForEachGlyph(face, ascent_height, text,
-               [size, buffer](int x, int y, const FT_GlyphSlot glyph){
-      RenderGlyph(buffer, size.width, size.height, glyph,
-                  x, y);
+  const auto &cache = *glyph_cache;
+  ForEachGlyph(face, *glyph_cache, ascent_height, text, true,
+               [&cache, size, buffer](int x, int y,
+                                      const FreeType::GlyphCache::Glyph &glyph){
+      if (glyph.rendered)
+        RenderGlyph(buffer, size.width, size.height,
+                    cache.GetBitmap(glyph), glyph.width, glyph.rows,
+                    x, y);
     });
 }
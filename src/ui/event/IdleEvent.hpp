@@ -0,0 +1,122 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include "event/DeferEvent.hxx"
+
+#ifdef USE_POLL_EVENT
+#include "event/IdleEvent.hxx"
+#else
+#include "Timer.hpp"
+#endif
+
+#include <functional>
+
+namespace UI {
+
+/**
+ * Calls a given function in the main thread after all pending
+ * events (input, timers, redraws) have been handled.  Use it for
+ * work which may be postponed, e.g. refreshing a list.
+ *
+ * With #USE_POLL_EVENT, this is an "idle" event of the main
+ * #EventLoop: only one runs at a time, pending ones are invoked in
+ * the order of their priority, and the ones which exceed the time
+ * budget get logged by their name.  On other platforms, this falls
+ * back to a #Timer which expires immediately, and priority and name
+ * are ignored.
+ *
+ * This class is not thread safe; all of the methods must be called
+ * from the main thread.
+ */
+class IdleEvent final {
+public:
+  using Priority = DeferEvent::IdlePriority;
+
+private:
+  using Callback = std::function<void()>;
+  const Callback callback;
+
+#ifdef USE_POLL_EVENT
+  ::IdleEvent event;
+#else
+  Timer timer{[this]{ callback(); }};
+#endif
+
+public:
+  /**
+   * @param name a name for reports about slow "idle" events
+   */
+#ifdef USE_POLL_EVENT
+  explicit IdleEvent(Callback &&_callback,
+                     Priority priority=Priority::NORMAL,
+                     const char *name=nullptr) noexcept;
+#else
+  explicit IdleEvent(Callback &&_callback,
+                     [[maybe_unused]] Priority priority=Priority::NORMAL,
+                     [[maybe_unused]] const char *name=nullptr) noexcept
+    :callback(std::move(_callback)) {}
+#endif
+
+  IdleEvent(const IdleEvent &other) = delete;
+
+  bool IsPending() const noexcept {
+#ifdef USE_POLL_EVENT
+    return event.IsPending();
+#else
+    return timer.IsPending();
+#endif
+  }
+
+  /**
+   * Schedule the event.  Does nothing if it is already pending.
+   */
+  void Schedule() noexcept {
+#ifdef USE_POLL_EVENT
+    event.Schedule();
+#else
+    timer.SchedulePreserve({});
+#endif
+  }
+
+  /**
+   * Cancel the event, if it is pending.
+   */
+  void Cancel() noexcept {
+#ifdef USE_POLL_EVENT
+    event.Cancel();
+#else
+    timer.Cancel();
+#endif
+  }
+
+#ifdef USE_POLL_EVENT
+private:
+  void OnIdle() noexcept {
+    callback();
+  }
+#endif
+};
+
+} // namespace UI
@@ -29,6 +29,11 @@ Copyright_License {
 #include "ui/canvas/Font.hpp"
 #endif
 
+#if defined(ENABLE_OPENGL) || defined(USE_MEMORY_CANVAS)
+#include "ui/canvas/custom/Cache.hpp"
+#include "LogFile.hpp"
+#endif
+
 #ifdef KOBO
 #include "Hardware/RotateDisplay.hpp"
 #include "DisplayOrientation.hpp"
@@ -74,8 +79,25 @@ ScreenGlobalInit::ScreenGlobalInit()
   ScreenInitialized();
 }
 
+#if defined(ENABLE_OPENGL) || defined(USE_MEMORY_CANVAS)
+
+static void
+LogTextCacheStatistics() noexcept
+{
+  const auto s = TextCache::GetStatistics();
+  LogFormat("TextCache: size hits=%lu misses=%lu, text hits=%lu misses=%lu, threads=%u",
+            s.size_hits, s.size_misses, s.text_hits, s.text_misses,
+            s.n_threads);
+}
+
+#endif
+
 ScreenGlobalInit::~ScreenGlobalInit()
 {
+#if defined(ENABLE_OPENGL) || defined(USE_MEMORY_CANVAS)
+  LogTextCacheStatistics();
+#endif
+
   UI::event_queue = nullptr;
 
 #ifdef USE_GDI
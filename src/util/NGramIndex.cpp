@@ -0,0 +1,186 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "NGramIndex.hpp"
+#include "StringAPI.hxx"
+
+#include <algorithm>
+
+using Key = uint64_t;
+
+/**
+ * Pack the #NGramIndex::N characters at the specified position into
+ * one integer.
+ */
+[[gnu::pure]]
+static Key
+MakeKey(const TCHAR *p) noexcept
+{
+  Key key = 0;
+  for (std::size_t i = 0; i < NGramIndex::N; ++i)
+    key = (key << 16) | (std::make_unsigned_t<TCHAR>(p[i]) & 0xffff);
+  return key;
+}
+
+/**
+ * Collect the distinct trigrams of a string.
+ */
+static std::vector<Key>
+GetKeys(const TCHAR *text) noexcept
+{
+  std::vector<Key> result;
+
+  const std::size_t length = StringLength(text);
+  if (length < NGramIndex::N)
+    return result;
+
+  result.reserve(length - NGramIndex::N + 1);
+  for (std::size_t i = 0; i + NGramIndex::N <= length; ++i)
+    result.push_back(MakeKey(text + i));
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+void
+NGramIndex::Clear() noexcept
+{
+  pending.clear();
+  pending.shrink_to_fit();
+  keys.clear();
+  keys.shrink_to_fit();
+  offsets.clear();
+  offsets.shrink_to_fit();
+  postings.clear();
+  postings.shrink_to_fit();
+}
+
+void
+NGramIndex::Add(uint32_t id, const TCHAR *text) noexcept
+{
+  for (const Key key : GetKeys(text))
+    pending.emplace_back(key, id);
+}
+
+void
+NGramIndex::Build() noexcept
+{
+  std::sort(pending.begin(), pending.end());
+  pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+  keys.clear();
+  offsets.clear();
+  postings.clear();
+  postings.reserve(pending.size());
+
+  for (const auto &[key, id] : pending) {
+    if (keys.empty() || keys.back() != key) {
+      keys.push_back(key);
+      offsets.push_back(postings.size());
+    }
+
+    postings.push_back(id);
+  }
+
+  offsets.push_back(postings.size());
+
+  pending.clear();
+  pending.shrink_to_fit();
+  keys.shrink_to_fit();
+  offsets.shrink_to_fit();
+}
+
+bool
+NGramIndex::FindCandidates(const TCHAR *query, unsigned max_errors,
+                           std::vector<Candidate> &result) const noexcept
+{
+  result.clear();
+
+  const auto query_keys = GetKeys(query);
+
+  /* each edit operation destroys at most N trigrams of the query; if
+     that may be all of them, the index cannot rule out anything */
+  if (query_keys.size() <= max_errors * N)
+    return false;
+
+  const unsigned min_score = query_keys.size() - max_errors * N;
+
+  std::vector<uint32_t> ids;
+  for (const Key key : query_keys) {
+    const auto i = std::lower_bound(keys.begin(), keys.end(), key);
+    if (i == keys.end() || *i != key)
+      continue;
+
+    const std::size_t k = std::distance(keys.begin(), i);
+    ids.insert(ids.end(),
+               postings.begin() + offsets[k],
+               postings.begin() + offsets[k + 1]);
+  }
+
+  std::sort(ids.begin(), ids.end());
+
+  for (auto i = ids.begin(); i != ids.end();) {
+    const auto end = std::upper_bound(i, ids.end(), *i);
+    const unsigned score = std::distance(i, end);
+    if (score >= min_score)
+      result.push_back({*i, score});
+    i = end;
+  }
+
+  std::stable_sort(result.begin(), result.end(),
+                   [](const Candidate &a, const Candidate &b){
+                     return a.score > b.score;
+                   });
+  return true;
+}
+
+unsigned
+ApproximateSubstringDistance(const TCHAR *text, const TCHAR *pattern) noexcept
+{
+  const std::size_t m = StringLength(pattern);
+
+  /* column[i] is the edit distance between the first i pattern
+     characters and the best substring ending at the current text
+     position */
+  std::vector<unsigned> column(m + 1);
+  for (std::size_t i = 0; i <= m; ++i)
+    column[i] = i;
+
+  unsigned best = m;
+
+  for (; *text != 0; ++text) {
+    /* a match may start anywhere, so the first row is always 0 */
+    unsigned diagonal = 0;
+    for (std::size_t i = 1; i <= m; ++i) {
+      const unsigned substitution =
+        diagonal + (pattern[i - 1] == *text ? 0 : 1);
+      diagonal = column[i];
+      column[i] = std::min({substitution, column[i] + 1, column[i - 1] + 1});
+    }
+
+    best = std::min(best, column[m]);
+  }
+
+  return best;
+}
@@ -0,0 +1,112 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <tchar.h>
+
+/**
+ * An inverted index of the trigrams (three consecutive characters)
+ * of short strings, used for substring and typo-tolerant searches.
+ * Each string is identified by a caller-defined integer; one id may
+ * have several strings.
+ *
+ * The index only finds candidates; the caller must verify them,
+ * e.g. with ApproximateSubstringDistance().
+ *
+ * All strings should be normalised with NormalizeSearchString().
+ * After adding all strings, Build() must be called; the index is
+ * immutable afterwards.
+ */
+class NGramIndex {
+  using Key = uint64_t;
+
+  /**
+   * The (key, id) pairs collected by Add(), consumed by Build().
+   */
+  std::vector<std::pair<Key, uint32_t>> pending;
+
+  /**
+   * All distinct trigrams, sorted.
+   */
+  std::vector<Key> keys;
+
+  /**
+   * For each element of #keys, the start of its posting list in
+   * #postings, plus the end of the last one.
+   */
+  std::vector<uint32_t> offsets;
+
+  /**
+   * The sorted ids containing each trigram.
+   */
+  std::vector<uint32_t> postings;
+
+public:
+  static constexpr std::size_t N = 3;
+
+  struct Candidate {
+    uint32_t id;
+
+    /**
+     * The number of distinct query trigrams found in this id's
+     * strings.
+     */
+    unsigned score;
+  };
+
+  [[gnu::pure]]
+  bool IsEmpty() const noexcept {
+    return keys.empty();
+  }
+
+  void Clear() noexcept;
+
+  void Add(uint32_t id, const TCHAR *text) noexcept;
+
+  void Build() noexcept;
+
+  /**
+   * Look up the ids whose strings may contain the query with at most
+   * the specified number of errors (q-gram lemma), ordered by
+   * descending score.
+   *
+   * @return false if the index cannot filter this query (too short
+   * or too many errors); the caller must then examine all strings
+   */
+  bool FindCandidates(const TCHAR *query, unsigned max_errors,
+                      std::vector<Candidate> &result) const noexcept;
+};
+
+/**
+ * Calculates the smallest edit distance (Levenshtein) between the
+ * pattern and any substring of the text (Sellers' algorithm).  0
+ * means that the pattern is a substring.
+ */
+unsigned
+ApproximateSubstringDistance(const TCHAR *text,
+                             const TCHAR *pattern) noexcept;
@@ -0,0 +1,443 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * An immutable spatial index for points on a plane.  Unlike #QuadTree,
+ * all values are stored in one contiguous array, sorted along a
+ * Hilbert curve, so nearby points are also close in memory.  A
+ * static tree of bounding boxes (a packed R-tree) is built on top of
+ * that array.
+ *
+ * The index cannot be modified; it must be rebuilt with Build()
+ * after the data set has changed.
+ *
+ * The distance semantics are the same as #QuadTree's: ranges are
+ * circles, and distances are compared as unsigned squares.
+ *
+ * @param T the value type
+ * @param Accessor a class which provides the methods GetX(const T &)
+ * and GetY(const T &)
+ */
+template<typename T, typename Accessor>
+class PackedPointIndex {
+public:
+  using position_type = int;
+  using distance_type = unsigned;
+
+  struct Point {
+    position_type x, y;
+
+    constexpr Point(position_type _x, position_type _y) noexcept
+      :x(_x), y(_y) {}
+  };
+
+private:
+  /**
+   * The number of values covered by one leaf box.
+   */
+  static constexpr std::size_t LEAF_SIZE = 16;
+
+  /**
+   * The number of children of each inner box.
+   */
+  static constexpr std::size_t FANOUT = 16;
+
+  struct Entry {
+    Point position;
+    T value;
+  };
+
+  struct Box {
+    position_type left, top, right, bottom;
+
+    explicit constexpr Box(Point p) noexcept
+      :left(p.x), top(p.y), right(p.x), bottom(p.y) {}
+
+    constexpr void Scan(const Box &other) noexcept {
+      left = std::min(left, other.left);
+      top = std::min(top, other.top);
+      right = std::max(right, other.right);
+      bottom = std::max(bottom, other.bottom);
+    }
+
+    /**
+     * Calculate the minimum square distance of this box to the
+     * specified point.
+     */
+    [[gnu::pure]]
+    distance_type SquareDistanceTo(Point p) const noexcept {
+      const distance_type dx = p.x < left
+        ? distance_type(left) - distance_type(p.x)
+        : (p.x > right ? distance_type(p.x) - distance_type(right) : 0);
+      const distance_type dy = p.y < top
+        ? distance_type(top) - distance_type(p.y)
+        : (p.y > bottom ? distance_type(p.y) - distance_type(bottom) : 0);
+      return dx * dx + dy * dy;
+    }
+  };
+
+  std::vector<Entry> entries;
+
+  /**
+   * The bounding boxes of all levels.  Level 0 contains one box per
+   * #LEAF_SIZE entries; each box on level n covers #FANOUT boxes of
+   * level n-1.  The last level contains only the root box.
+   */
+  std::vector<Box> boxes;
+
+  /**
+   * The index of the first box of each level in #boxes, plus the end
+   * of the last level.
+   */
+  std::vector<std::size_t> levels;
+
+public:
+  [[gnu::pure]]
+  bool IsEmpty() const noexcept {
+    return entries.empty();
+  }
+
+  [[gnu::pure]]
+  std::size_t size() const noexcept {
+    return entries.size();
+  }
+
+  void clear() noexcept {
+    entries.clear();
+    entries.shrink_to_fit();
+    boxes.clear();
+    boxes.shrink_to_fit();
+    levels.clear();
+  }
+
+  /**
+   * Build the index from the specified range of values.
+   */
+  template<typename I>
+  void Build(I begin, I end) {
+    clear();
+
+    for (; begin != end; ++begin)
+      entries.push_back({GetPosition(*begin), *begin});
+
+    if (entries.empty())
+      return;
+
+    SortEntries();
+    BuildBoxes();
+  }
+
+  /**
+   * Find the nearest value matching the predicate.
+   *
+   * @return a pointer to the value (nullptr if none was found) and
+   * its square distance
+   */
+  template<typename P>
+  [[gnu::pure]]
+  std::pair<const T *, distance_type>
+  FindNearestIf(Point location, distance_type range,
+                const P &predicate) const noexcept {
+    std::pair<const T *, distance_type> result{nullptr, Square(range)};
+    if (!IsEmpty())
+      FindNearestIf(levels.size() - 2, 0, location, predicate, result);
+    return result;
+  }
+
+  [[gnu::pure]]
+  std::pair<const T *, distance_type>
+  FindNearest(Point location, distance_type range) const noexcept {
+    return FindNearestIf(location, range, [](const T &){ return true; });
+  }
+
+  /**
+   * Invoke the visitor for each value within the specified range.
+   */
+  template<typename V>
+  void VisitWithinRange(Point location, distance_type range,
+                        V &visitor) const {
+    if (!IsEmpty())
+      VisitWithinRange(levels.size() - 2, 0, location, Square(range),
+                       visitor);
+  }
+
+  /**
+   * Invoke the visitor for each value within the specified range
+   * which matches the predicate, nearest first (best-first search).
+   * The visitor returns false to stop the search; therefore, only as
+   * much of the index as needed is examined.
+   *
+   * @param visitor a function object with the signature
+   * bool(const T &value, distance_type square_distance)
+   */
+  template<typename P, typename V>
+  void VisitNearestIf(Point location, distance_type range,
+                      const P &predicate, V &&visitor) const {
+    if (IsEmpty())
+      return;
+
+    const distance_type square_range = Square(range);
+
+    std::priority_queue<Candidate, std::vector<Candidate>,
+                        std::greater<Candidate>> queue;
+    queue.push({0, levels.size() - 2, 0});
+
+    while (!queue.empty()) {
+      const Candidate c = queue.top();
+      queue.pop();
+
+      if (c.level == ENTRY_LEVEL) {
+        if (!visitor(entries[c.index].value, c.square_distance))
+          return;
+        continue;
+      }
+
+      const auto [begin, end] = GetChildren(c.level, c.index);
+      for (std::size_t j = begin; j < end; ++j) {
+        if (c.level == 0) {
+          const Entry &entry = entries[j];
+          const distance_type d = SquareDistance(entry.position, location);
+          if (d <= square_range && predicate(entry.value))
+            queue.push({d, ENTRY_LEVEL, j});
+        } else {
+          const distance_type d =
+            GetBox(c.level - 1, j).SquareDistanceTo(location);
+          if (d <= square_range)
+            queue.push({d, c.level - 1, j});
+        }
+      }
+    }
+  }
+
+private:
+  /**
+   * A special value for Candidate::level which refers to an #Entry.
+   */
+  static constexpr std::size_t ENTRY_LEVEL = std::numeric_limits<std::size_t>::max();
+
+  /**
+   * An item in the priority queue of VisitNearestIf().
+   */
+  struct Candidate {
+    distance_type square_distance;
+    std::size_t level, index;
+
+    constexpr bool operator>(const Candidate &other) const noexcept {
+      /* at the same distance, prefer entries over boxes, because
+         their distance is final */
+      return square_distance != other.square_distance
+        ? square_distance > other.square_distance
+        : level < other.level;
+    }
+  };
+
+  static constexpr distance_type Square(distance_type x) noexcept {
+    return x * x;
+  }
+
+  static constexpr distance_type SquareDistance(Point a, Point b) noexcept {
+    const distance_type dx = a.x > b.x
+      ? distance_type(a.x) - distance_type(b.x)
+      : distance_type(b.x) - distance_type(a.x);
+    const distance_type dy = a.y > b.y
+      ? distance_type(a.y) - distance_type(b.y)
+      : distance_type(b.y) - distance_type(a.y);
+    return dx * dx + dy * dy;
+  }
+
+  [[gnu::pure]]
+  static Point GetPosition(const T &value) noexcept {
+    const Accessor accessor;
+    return {accessor.GetX(value), accessor.GetY(value)};
+  }
+
+  /**
+   * Calculate the position of a point on a Hilbert curve filling a
+   * 65536x65536 grid.
+   */
+  [[gnu::const]]
+  static uint64_t HilbertIndex(uint32_t x, uint32_t y) noexcept {
+    constexpr uint32_t n = 1U << 16;
+
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+      const uint32_t rx = (x & s) != 0;
+      const uint32_t ry = (y & s) != 0;
+      d += uint64_t(s) * s * ((3 * rx) ^ ry);
+
+      if (ry == 0) {
+        if (rx == 1) {
+          x = n - 1 - x;
+          y = n - 1 - y;
+        }
+
+        std::swap(x, y);
+      }
+    }
+
+    return d;
+  }
+
+  void SortEntries() {
+    Box bounds(entries.front().position);
+    for (const auto &i : entries)
+      bounds.Scan(Box(i.position));
+
+    const uint64_t width = uint64_t(int64_t(bounds.right) - bounds.left) + 1;
+    const uint64_t height = uint64_t(int64_t(bounds.bottom) - bounds.top) + 1;
+
+    std::vector<std::pair<uint64_t, std::size_t>> keys;
+    keys.reserve(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const Point p = entries[i].position;
+      const uint32_t x = (uint64_t(int64_t(p.x) - bounds.left) << 16) / width;
+      const uint32_t y = (uint64_t(int64_t(p.y) - bounds.top) << 16) / height;
+      keys.emplace_back(HilbertIndex(x, y), i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<Entry> sorted;
+    sorted.reserve(entries.size());
+    for (const auto &i : keys)
+      sorted.push_back(std::move(entries[i.second]));
+
+    entries = std::move(sorted);
+  }
+
+  void BuildBoxes() {
+    /* level 0: the leaf boxes */
+    levels.push_back(0);
+    for (std::size_t i = 0; i < entries.size(); i += LEAF_SIZE) {
+      const std::size_t end = std::min(i + LEAF_SIZE, entries.size());
+      Box box(entries[i].position);
+      for (std::size_t j = i + 1; j < end; ++j)
+        box.Scan(Box(entries[j].position));
+      boxes.push_back(box);
+    }
+
+    levels.push_back(boxes.size());
+
+    /* inner levels, until there is only the root box */
+    while (levels.back() - levels[levels.size() - 2] > 1) {
+      const std::size_t begin = levels[levels.size() - 2];
+      const std::size_t end = levels.back();
+
+      for (std::size_t i = begin; i < end; i += FANOUT) {
+        const std::size_t chunk_end = std::min(i + FANOUT, end);
+        Box box = boxes[i];
+        for (std::size_t j = i + 1; j < chunk_end; ++j)
+          box.Scan(boxes[j]);
+        boxes.push_back(box);
+      }
+
+      levels.push_back(boxes.size());
+    }
+  }
+
+  /**
+   * Returns the range of child indices (relative to the level below
+   * or to #entries) covered by the specified box.
+   */
+  [[gnu::pure]]
+  std::pair<std::size_t, std::size_t>
+  GetChildren(std::size_t level, std::size_t i) const noexcept {
+    const std::size_t n_children = level == 0
+      ? entries.size()
+      : levels[level] - levels[level - 1];
+    const std::size_t size = level == 0 ? LEAF_SIZE : FANOUT;
+    return {i * size, std::min((i + 1) * size, n_children)};
+  }
+
+  [[gnu::pure]]
+  const Box &GetBox(std::size_t level, std::size_t i) const noexcept {
+    assert(levels[level] + i < levels[level + 1]);
+    return boxes[levels[level] + i];
+  }
+
+  template<typename P>
+  void FindNearestIf(std::size_t level, std::size_t i, Point location,
+                     const P &predicate,
+                     std::pair<const T *, distance_type> &result) const noexcept {
+    const auto [begin, end] = GetChildren(level, i);
+
+    if (level == 0) {
+      for (std::size_t j = begin; j < end; ++j) {
+        const Entry &entry = entries[j];
+        const distance_type d = SquareDistance(entry.position, location);
+        if (d <= result.second && predicate(entry.value))
+          result = {&entry.value, d};
+      }
+
+      return;
+    }
+
+    /* visit the nearest children first to shrink the search radius
+       quickly */
+    std::array<std::pair<distance_type, std::size_t>, FANOUT> children;
+    std::size_t n = 0;
+    for (std::size_t j = begin; j < end; ++j) {
+      const distance_type d = GetBox(level - 1, j).SquareDistanceTo(location);
+      if (d <= result.second)
+        children[n++] = {d, j};
+    }
+
+    std::sort(children.begin(), children.begin() + n);
+
+    for (std::size_t j = 0; j < n; ++j)
+      if (children[j].first <= result.second)
+        FindNearestIf(level - 1, children[j].second, location, predicate,
+                      result);
+  }
+
+  template<typename V>
+  void VisitWithinRange(std::size_t level, std::size_t i, Point location,
+                        distance_type square_range, V &visitor) const {
+    const auto [begin, end] = GetChildren(level, i);
+
+    if (level == 0) {
+      for (std::size_t j = begin; j < end; ++j)
+        if (SquareDistance(entries[j].position, location) <= square_range)
+          visitor(entries[j].value);
+
+      return;
+    }
+
+    for (std::size_t j = begin; j < end; ++j)
+      if (GetBox(level - 1, j).SquareDistanceTo(location) <= square_range)
+        VisitWithinRange(level - 1, j, location, square_range, visitor);
+  }
+};
@@ -30,20 +30,36 @@
 #pragma once
 
 #include <cstring>
+#include <span>
 
+/**
+ * Find the first complete line in the buffer, consume it and
+ * null-terminate it in place (without the line feed and an optional
+ * carriage return).
+ *
+ * @return the line (without the null terminator) or an empty span
+ * with a nullptr data pointer if there is no complete line
+ */
 template<typename B>
-char *
-ReadBufferedLine(B &buffer)
+std::span<char>
+ReadBufferedLineSpan(B &buffer)
 {
 	auto r = buffer.Read();
 	char *newline = reinterpret_cast<char*>(std::memchr(r.data(), '\n', r.size()));
 	if (newline == nullptr)
-		return nullptr;
+		return {};
 
 	buffer.Consume(newline + 1 - r.data());
 
 	if (newline > r.data() && newline[-1] == '\r')
 		--newline;
 	*newline = 0;
-	return r.data();
+	return {r.data(), newline};
+}
+
+template<typename B>
+char *
+ReadBufferedLine(B &buffer)
+{
+	return ReadBufferedLineSpan(buffer).data();
 }
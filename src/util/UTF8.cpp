@@ -28,6 +28,14 @@ Copyright_License {
 #include <algorithm>
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 /**
  * Is this a leading byte that is followed by 1 continuation byte?
@@ -119,47 +127,44 @@ MakeContinuation(unsigned char value) noexcept
   return 0x80 | (value & 0x3f);
 }
 
-bool
-ValidateUTF8(const char *p) noexcept
+std::size_t
+FindNonASCII(std::string_view s) noexcept
 {
-  for (; *p != 0; ++p) {
-    unsigned char ch = *p;
-    if (IsASCII(ch))
-      continue;
+  const char *const begin = s.data(), *const end = begin + s.size();
+  const char *p = begin;
 
-    if (IsContinuation(ch))
-      /* continuation without a prefix */
-      return false;
+#ifdef __SSE2__
+  for (; end - p >= 16; p += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    if (_mm_movemask_epi8(v) != 0)
+      break;
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  for (; end - p >= 16; p += 16)
+    if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(p))) >= 0x80)
+      break;
+#endif
 
-    if (IsLeading1(ch)) {
-      /* 1 continuation */
-      if (!IsContinuation(*++p))
-        return false;
-    } else if (IsLeading2(ch)) {
-      /* 2 continuations */
-      if (!IsContinuation(*++p) || !IsContinuation(*++p))
-        return false;
-    } else if (IsLeading3(ch)) {
-      /* 3 continuations */
-      if (!IsContinuation(*++p) || !IsContinuation(*++p) ||
-          !IsContinuation(*++p))
-        return false;
-    } else if (IsLeading4(ch)) {
-      /* 4 continuations */
-      if (!IsContinuation(*++p) || !IsContinuation(*++p) ||
-          !IsContinuation(*++p) || !IsContinuation(*++p))
-        return false;
-    } else if (IsLeading5(ch)) {
-      /* 5 continuations */
-      if (!IsContinuation(*++p) || !IsContinuation(*++p) ||
-          !IsContinuation(*++p) || !IsContinuation(*++p) ||
-          !IsContinuation(*++p))
-        return false;
-    } else
-      return false;
+  /* portable fallback (and the tail of the SIMD loop): test 8 bytes
+     at a time */
+  for (; end - p >= 8; p += 8) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    if ((w & 0x8080808080808080ULL) != 0)
+      break;
   }
 
-  return true;
+  for (; p != end; ++p)
+    if (!IsASCII(*p))
+      return p - begin;
+
+  return std::string_view::npos;
+}
+
+bool
+ValidateUTF8(const char *p) noexcept
+{
+  return ValidateUTF8(std::string_view{p});
 }
 
 static char
@@ -174,9 +179,14 @@ bool
 ValidateUTF8(std::string_view p) noexcept
 {
   while (!p.empty()) {
+    /* skip runs of ASCII characters quickly */
+    const std::size_t n_ascii = FindNonASCII(p);
+    if (n_ascii == p.npos)
+      return true;
+
+    p.remove_prefix(n_ascii);
+
     unsigned char ch = Shift(p);
-    if (IsASCII(ch))
-      continue;
 
     if (IsContinuation(ch))
       /* continuation without a prefix */
@@ -295,14 +305,6 @@ SequenceLengthUTF8(const char *p) noexcept
     return 0;
 }
 
-static const char *
-FindNonASCIIOrZero(const char *p) noexcept
-{
-  while (*p != 0 && IsASCII(*p))
-    ++p;
-  return p;
-}
-
 char *
 Latin1ToUTF8(unsigned char ch, char *buffer) noexcept
 {
@@ -320,11 +322,13 @@ const char *
 Latin1ToUTF8(const char *gcc_restrict src, char *gcc_restrict buffer,
              std::size_t buffer_size) noexcept
 {
-  const char *p = FindNonASCIIOrZero(src);
-  if (*p == 0)
+  const std::size_t n_ascii = FindNonASCII(src);
+  if (n_ascii == std::string_view::npos)
     /* everything is plain ASCII, we don't need to convert anything */
     return src;
 
+  const char *p = src + n_ascii;
+
   if ((std::size_t)(p - src) >= buffer_size)
     /* buffer too small */
     return nullptr;
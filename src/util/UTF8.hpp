@@ -27,6 +27,18 @@ Copyright_License {
 #include <string_view>
 #include <utility>
 
+/**
+ * Find the first byte which is not ASCII, i.e. which has the most
+ * significant bit set.  Scans 16 bytes at a time with SSE2 or NEON
+ * where available.
+ *
+ * @return the position of that byte or std::string_view::npos if the
+ * string is pure ASCII
+ */
+[[gnu::pure]]
+std::size_t
+FindNonASCII(std::string_view p) noexcept;
+
 /**
  * Is this a valid UTF-8 string?
  */
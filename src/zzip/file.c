@@ -20,6 +20,7 @@
 
 #include <zzip/format.h>
 #include <zzip/fetch.h>
+#include <zzip/index.h>
 #include <zzip/zzip32.h>
 #include <zzip/__debug.h>
 
@@ -291,6 +292,9 @@ zzip_file_open(ZZIP_DIR * dir, zzip_char_t * name, int o_mode)
             if (err)
                 goto error;
 
+            if (fp->method)
+                fp->index = zzip_index_find(dir, hdr);
+
             return fp;
         } else
         {
@@ -1043,6 +1047,10 @@ zzip_rewind(ZZIP_FILE * fp)
  * reached.  This can make the function terribly slow, but this is
  * how gzio implements it, so I'm not sure there is a better way
  * without using the internals of the algorithm.
+ *
+ * If checkpoints have been loaded with => zzip_dir_index_build or
+ * => zzip_dir_index_import, inflating resumes at the last checkpoint
+ * before the offset instead.
  */
 zzip_off_t
 zzip_seek(ZZIP_FILE * fp, zzip_off_t offset, int whence)
@@ -1079,6 +1087,35 @@ zzip_seek(ZZIP_FILE * fp, zzip_off_t offset, int whence)
     if (rel_ofs == 0)
         return cur_pos;         /* don't have to move */
 
+    if (fp->method && fp->index)
+    {                           /* deflated: try to resume at a checkpoint */
+        zzip_off_t offset = cur_pos + rel_ofs;
+
+        if (offset < 0 || offset > (zzip_off_t) fp->usize)
+            return -1;
+
+        dir = fp->dir;
+        if (dir->currentfp != fp)
+        {
+            if (zzip_file_saveoffset(dir->currentfp) < 0
+                || fp->io->fd.seeks(dir->fd, fp->offset, SEEK_SET) < 0)
+                { /* dir->errcode = ZZIP_DIR_SEEK; */ return -1; }
+            else
+                { dir->currentfp = fp; }
+        }
+
+        ofs = zzip_index_restore(fp, offset, cur_pos);
+        if (ofs < -1)
+            return -1;
+        else if (ofs >= 0)
+        {
+            cur_pos = ofs;
+            rel_ofs = offset - cur_pos;
+            if (rel_ofs == 0)
+                return cur_pos;
+        }
+    }
+
     if (rel_ofs < 0)
     {                           /* convert backward into forward */
         if (zzip_rewind(fp) == -1)
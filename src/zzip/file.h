@@ -69,4 +69,6 @@ struct zzip_file
     zzip_off_t offset; /* offset from the start of zipfile... */
     z_stream d_stream;
     zzip_plugin_io_t io;
+    /* checkpoints for zzip_seek(), owned by the zzip_dir; may be NULL */
+    const struct zzip_index* index;
 };
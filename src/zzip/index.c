@@ -0,0 +1,560 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Random access in deflated ZIP members.  Following the approach of
+ * zlib's examples/zran.c, the member is inflated once, and every
+ * "span" bytes of output, the decompressor state at the next deflate
+ * block boundary is recorded: the position in the compressed stream
+ * (including the bit offset) and the last 32 kB of output, which is
+ * the dictionary needed to resume.  zzip_seek() then only needs to
+ * inflate from the last checkpoint before the requested offset.
+ */
+
+#include <zzip/lib.h>
+#include <zzip/file.h>
+#include <zzip/index.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct zzip_index_point
+{
+  /* offset in the uncompressed data */
+  uint64_t out;
+
+  /* offset of the first complete byte in the compressed data */
+  uint64_t in;
+
+  /* number of bits (0-7) of the byte before "in" which have not been
+     consumed yet */
+  uint32_t bits;
+
+  uint32_t reserved;
+
+  /* the 32 kB of uncompressed data before "out" */
+  unsigned char window[ZZIP_32K];
+};
+
+struct zzip_index
+{
+  struct zzip_index *next;
+
+  /* identifies the member; copied from its struct zzip_dir_hdr */
+  uint32_t d_off, d_usize, d_csize, d_crc32;
+
+  uint32_t n_points;
+  struct zzip_index_point *points;
+};
+
+/* the serialised form, used by zzip_dir_index_export() */
+
+#define ZZIP_INDEX_MAGIC 0x5a5a4958
+#define ZZIP_INDEX_VERSION 1
+
+struct zzip_index_file_header
+{
+  uint32_t magic, version, n_indexes;
+};
+
+struct zzip_index_file_member
+{
+  uint32_t d_off, d_usize, d_csize, d_crc32;
+  uint32_t n_points;
+};
+
+static void
+zzip_index_free(struct zzip_index *index)
+{
+  free(index->points);
+  free(index);
+}
+
+void
+zzip_index_free_all(ZZIP_DIR *dir)
+{
+  while (dir->index != NULL) {
+    struct zzip_index *index = dir->index;
+    dir->index = index->next;
+    zzip_index_free(index);
+  }
+}
+
+const struct zzip_index *
+zzip_index_find(const ZZIP_DIR *dir, const struct zzip_dir_hdr *hdr)
+{
+  const struct zzip_index *index;
+
+  for (index = dir->index; index != NULL; index = index->next)
+    if (index->d_off == hdr->d_off)
+      return index;
+
+  return NULL;
+}
+
+static struct zzip_dir_hdr *
+zzip_index_find_hdr(ZZIP_DIR *dir, uint32_t d_off)
+{
+  struct zzip_dir_hdr *hdr = dir->hdr0;
+
+  if (hdr == NULL)
+    return NULL;
+
+  while (1) {
+    if (hdr->d_off == d_off)
+      return hdr;
+
+    if (hdr->d_reclen == 0)
+      return NULL;
+
+    hdr = (struct zzip_dir_hdr *)((char *)hdr + hdr->d_reclen);
+  }
+}
+
+static int
+zzip_index_add_point(struct zzip_index *index, unsigned *capacity,
+                     const z_stream *strm, uint64_t in, uint64_t out,
+                     const unsigned char *window)
+{
+  struct zzip_index_point *point;
+  const unsigned left = strm->avail_out;
+
+  if (index->n_points == *capacity) {
+    unsigned new_capacity = *capacity > 0 ? *capacity * 2 : 8;
+    point = realloc(index->points, new_capacity * sizeof(*point));
+    if (point == NULL)
+      return -1;
+
+    index->points = point;
+    *capacity = new_capacity;
+  }
+
+  point = &index->points[index->n_points++];
+  point->out = out;
+  point->in = in;
+  point->bits = strm->data_type & 7;
+  point->reserved = 0;
+
+  /* the window is a ring buffer; the oldest data begins at the
+     current output position */
+  if (left > 0)
+    memcpy(point->window, window + ZZIP_32K - left, left);
+  if (left < ZZIP_32K)
+    memcpy(point->window + left, window, ZZIP_32K - left);
+
+  return 0;
+}
+
+/**
+ * Inflate the whole member and record a checkpoint every "span"
+ * bytes.  Returns NULL on error.
+ */
+static struct zzip_index *
+zzip_index_build_member(ZZIP_DIR *dir, const struct zzip_dir_hdr *hdr,
+                        zzip_size_t span)
+{
+  ZZIP_FILE *fp;
+  struct zzip_index *index;
+  unsigned capacity = 0;
+  unsigned char *window;
+  z_stream strm;
+  uint64_t total_in = 0, total_out = 0, last = 0;
+  zzip_size_t crestlen;
+  int ret = Z_OK;
+
+  /* let zzip_file_open() locate the data behind the local header;
+     the dir's file position is now at the beginning of the data */
+  fp = zzip_file_open(dir, hdr->d_name, 0);
+  if (fp == NULL)
+    return NULL;
+
+  if (fp->method != 8 || fp->usize != hdr->d_usize) {
+    zzip_file_close(fp);
+    return NULL;
+  }
+
+  index = calloc(1, sizeof(*index));
+  window = malloc(ZZIP_32K);
+  if (index == NULL || window == NULL)
+    goto error;
+
+  index->d_off = hdr->d_off;
+  index->d_usize = hdr->d_usize;
+  index->d_csize = hdr->d_csize;
+  index->d_crc32 = hdr->d_crc32;
+
+  memset(&strm, 0, sizeof(strm));
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+    goto error;
+
+  crestlen = fp->csize;
+
+  do {
+    if (strm.avail_in == 0 && crestlen > 0) {
+      /* after the last byte, inflate() is called once more with no
+         input to report Z_STREAM_END (or Z_BUF_ERROR if the data is
+         truncated) */
+      zzip_size_t n = crestlen < ZZIP_32K ? crestlen : ZZIP_32K;
+      zzip_ssize_t nbytes;
+
+      nbytes = dir->io->fd.read(dir->fd, fp->buf32k, n);
+      if (nbytes <= 0)
+        break;
+
+      crestlen -= nbytes;
+      strm.avail_in = nbytes;
+      strm.next_in = (unsigned char *)fp->buf32k;
+    }
+
+    if (strm.avail_out == 0) {
+      strm.avail_out = ZZIP_32K;
+      strm.next_out = window;
+    }
+
+    total_in += strm.avail_in;
+    total_out += strm.avail_out;
+    ret = inflate(&strm, Z_BLOCK);
+    total_in -= strm.avail_in;
+    total_out -= strm.avail_out;
+
+    if (ret != Z_OK && ret != Z_STREAM_END)
+      break;
+
+    /* at the end of a block which is not the last one? */
+    if ((strm.data_type & 128) != 0 && (strm.data_type & 64) == 0 &&
+        total_out - last > span) {
+      if (zzip_index_add_point(index, &capacity, &strm,
+                               total_in, total_out, window) < 0)
+        break;
+
+      last = total_out;
+    }
+  } while (ret != Z_STREAM_END);
+
+  inflateEnd(&strm);
+
+  if (ret != Z_STREAM_END || total_out != hdr->d_usize)
+    goto error;
+
+  free(window);
+  zzip_file_close(fp);
+  return index;
+
+ error:
+  if (index != NULL)
+    zzip_index_free(index);
+  free(window);
+  zzip_file_close(fp);
+  return NULL;
+}
+
+/** build seek index.
+ * This function inflates deflated members of the archive once and
+ * records a checkpoint every span bytes (at least 32 kB), which
+ * allows => zzip_seek to resume inflating close to the requested
+ * offset instead of at the beginning of the member.  The checkpoints
+ * are used by files opened after this call.
+ *
+ * If name is NULL, all deflated members larger than two spans are
+ * indexed.  Members which already have an index are skipped.
+ *
+ * returns the number of members indexed, or -1 on error
+ */
+int
+zzip_dir_index_build(ZZIP_DIR *dir, zzip_char_t *name, zzip_size_t span)
+{
+  struct zzip_dir_hdr *hdr;
+  int n = 0;
+
+  if (dir == NULL || span < ZZIP_32K)
+    return -1;
+
+  hdr = dir->hdr0;
+  if (hdr == NULL)
+    return 0;
+
+  while (1) {
+    if (hdr->d_compr == 8 &&
+        (name != NULL
+         ? strcmp(hdr->d_name, name) == 0
+         : hdr->d_usize > 2 * span) &&
+        zzip_index_find(dir, hdr) == NULL) {
+      struct zzip_index *index = zzip_index_build_member(dir, hdr, span);
+      if (index == NULL)
+        return -1;
+
+      index->next = dir->index;
+      dir->index = index;
+      ++n;
+    }
+
+    if (hdr->d_reclen == 0)
+      break;
+
+    hdr = (struct zzip_dir_hdr *)((char *)hdr + hdr->d_reclen);
+  }
+
+  return n;
+}
+
+/** export seek index.
+ * This function serialises all checkpoints built by
+ * => zzip_dir_index_build into a buffer allocated with => malloc(3),
+ * to be stored in a cache file and passed to => zzip_dir_index_import
+ * later.  The format is specific to this machine.
+ *
+ * returns NULL if there are no checkpoints or on error
+ */
+void *
+zzip_dir_index_export(ZZIP_DIR *dir, zzip_size_t *size_p)
+{
+  const struct zzip_index *index;
+  struct zzip_index_file_header header;
+  zzip_size_t size = sizeof(header);
+  unsigned char *data, *p;
+
+  header.magic = ZZIP_INDEX_MAGIC;
+  header.version = ZZIP_INDEX_VERSION;
+  header.n_indexes = 0;
+
+  for (index = dir->index; index != NULL; index = index->next) {
+    ++header.n_indexes;
+    size += sizeof(struct zzip_index_file_member) +
+      index->n_points * sizeof(struct zzip_index_point);
+  }
+
+  if (header.n_indexes == 0)
+    return NULL;
+
+  data = p = malloc(size);
+  if (data == NULL)
+    return NULL;
+
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+
+  for (index = dir->index; index != NULL; index = index->next) {
+    struct zzip_index_file_member member;
+    member.d_off = index->d_off;
+    member.d_usize = index->d_usize;
+    member.d_csize = index->d_csize;
+    member.d_crc32 = index->d_crc32;
+    member.n_points = index->n_points;
+
+    memcpy(p, &member, sizeof(member));
+    p += sizeof(member);
+
+    memcpy(p, index->points, index->n_points * sizeof(*index->points));
+    p += index->n_points * sizeof(*index->points);
+  }
+
+  *size_p = size;
+  return data;
+}
+
+static int
+zzip_index_check_points(const struct zzip_index_file_member *member,
+                        const struct zzip_index_point *points)
+{
+  uint64_t out = 0;
+  uint32_t i;
+
+  for (i = 0; i < member->n_points; ++i) {
+    const struct zzip_index_point *point = &points[i];
+    if (point->out <= out || point->out >= member->d_usize ||
+        point->out < ZZIP_32K ||
+        point->in == 0 || point->in >= member->d_csize || point->bits > 7)
+      return -1;
+
+    out = point->out;
+  }
+
+  return 0;
+}
+
+/** import seek index.
+ * This function loads checkpoints created by => zzip_dir_index_export.
+ * All members must still exist unmodified in this archive, or else
+ * the whole data is rejected.  Members which already have an index
+ * are skipped.
+ *
+ * returns the number of members imported, or -1 on error
+ */
+int
+zzip_dir_index_import(ZZIP_DIR *dir, const void *data, zzip_size_t size)
+{
+  const unsigned char *p = data, *const end = p + size;
+  struct zzip_index_file_header header;
+  struct zzip_index *imported = NULL;
+  uint32_t i;
+  int n = 0;
+
+  if (dir == NULL || size < sizeof(header))
+    return -1;
+
+  memcpy(&header, p, sizeof(header));
+  p += sizeof(header);
+
+  if (header.magic != ZZIP_INDEX_MAGIC ||
+      header.version != ZZIP_INDEX_VERSION)
+    return -1;
+
+  for (i = 0; i < header.n_indexes; ++i) {
+    struct zzip_index_file_member member;
+    const struct zzip_dir_hdr *hdr;
+    struct zzip_index *index;
+    zzip_size_t points_size;
+
+    if ((zzip_size_t)(end - p) < sizeof(member))
+      goto error;
+
+    memcpy(&member, p, sizeof(member));
+    p += sizeof(member);
+
+    if (member.n_points > member.d_usize / ZZIP_32K ||
+        member.n_points > (zzip_size_t)(end - p) / sizeof(struct zzip_index_point))
+      goto error;
+
+    points_size = member.n_points * sizeof(struct zzip_index_point);
+
+    hdr = zzip_index_find_hdr(dir, member.d_off);
+    if (hdr == NULL || hdr->d_compr != 8 ||
+        hdr->d_usize != member.d_usize || hdr->d_csize != member.d_csize ||
+        hdr->d_crc32 != member.d_crc32)
+      /* the archive has been modified */
+      goto error;
+
+    index = calloc(1, sizeof(*index));
+    if (index == NULL)
+      goto error;
+
+    index->next = imported;
+    imported = index;
+
+    index->d_off = member.d_off;
+    index->d_usize = member.d_usize;
+    index->d_csize = member.d_csize;
+    index->d_crc32 = member.d_crc32;
+
+    if (member.n_points > 0) {
+      index->points = malloc(points_size);
+      if (index->points == NULL)
+        goto error;
+
+      memcpy(index->points, p, points_size);
+      if (zzip_index_check_points(&member, index->points) < 0)
+        goto error;
+
+      index->n_points = member.n_points;
+    }
+
+    p += points_size;
+  }
+
+  if (p != end)
+    goto error;
+
+  /* everything is valid; move the new indexes to the dir */
+  while (imported != NULL) {
+    struct zzip_index *index = imported;
+    imported = index->next;
+
+    if (zzip_index_find(dir, zzip_index_find_hdr(dir, index->d_off)) != NULL) {
+      zzip_index_free(index);
+      continue;
+    }
+
+    index->next = dir->index;
+    dir->index = index;
+    ++n;
+  }
+
+  return n;
+
+ error:
+  while (imported != NULL) {
+    struct zzip_index *index = imported;
+    imported = index->next;
+    zzip_index_free(index);
+  }
+
+  return -1;
+}
+
+zzip_off_t
+zzip_index_restore(ZZIP_FILE *fp, zzip_off_t offset, zzip_off_t cur_pos)
+{
+  const struct zzip_index *index = fp->index;
+  const struct zzip_index_point *point = NULL;
+  ZZIP_DIR *dir = fp->dir;
+  uint32_t lo = 0, hi = index->n_points;
+  uint64_t in;
+
+  /* binary search for the last checkpoint at or before the offset */
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (index->points[mid].out <= (uint64_t)offset) {
+      point = &index->points[mid];
+      lo = mid + 1;
+    } else
+      hi = mid;
+  }
+
+  if (point == NULL)
+    return -1;
+
+  if ((zzip_off_t)point->out <= cur_pos && cur_pos <= offset)
+    /* inflating from the current position is cheaper */
+    return -1;
+
+  in = point->in - (point->bits != 0);
+
+  if (dir->io->fd.seeks(dir->fd, fp->dataoffset + in, SEEK_SET) < 0)
+    return -2;
+
+  if (inflateReset(&fp->d_stream) != Z_OK)
+    return -2;
+
+  fp->d_stream.avail_in = 0;
+  fp->crestlen = fp->csize - in;
+
+  if (point->bits != 0) {
+    /* feed the remaining bits of the partially consumed byte */
+    unsigned char ch;
+    if (dir->io->fd.read(dir->fd, &ch, 1) != 1)
+      return -2;
+
+    --fp->crestlen;
+    if (inflatePrime(&fp->d_stream, point->bits,
+                     ch >> (8 - point->bits)) != Z_OK)
+      return -2;
+  }
+
+  if (inflateSetDictionary(&fp->d_stream, point->window,
+                           ZZIP_32K) != Z_OK)
+    return -2;
+
+  fp->restlen = fp->usize - point->out;
+  return point->out;
+}
@@ -0,0 +1,55 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#pragma once
+
+#include <zzip/lib.h>
+
+/*
+ * Internal interface between zzip/file.c and zzip/index.c.
+ */
+
+/**
+ * Look up the checkpoints of the given member.  Returns NULL if
+ * there are none.
+ */
+const struct zzip_index *
+zzip_index_find(const ZZIP_DIR *dir, const struct zzip_dir_hdr *hdr);
+
+/**
+ * Restore the inflate state of a deflated member from the last
+ * checkpoint at or before the given uncompressed offset, unless
+ * continuing from the current position is cheaper.  The caller must
+ * have made this file the dir's current file.
+ *
+ * @return the new uncompressed position, -1 if no checkpoint was
+ * used (the file is unchanged) or -2 on error
+ */
+zzip_off_t
+zzip_index_restore(ZZIP_FILE *fp, zzip_off_t offset, zzip_off_t cur_pos);
+
+/**
+ * Free all checkpoints of the given dir.
+ */
+void
+zzip_index_free_all(ZZIP_DIR *dir);
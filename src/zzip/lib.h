@@ -62,6 +62,7 @@ struct zzip_dir
     char*  realname;
     zzip_strings_t* fileext;      /* list of fileext to test for */
     zzip_plugin_io_t io;          /* vtable for io routines */
+    struct zzip_index * index;    /* seek indexes of deflated members */
 }; 
 
 #define ZZIP_32K 32768
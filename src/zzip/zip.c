@@ -10,6 +10,7 @@
 #include <zzip/file.h>
 #include <zzip/format.h>
 #include <zzip/fetch.h>
+#include <zzip/index.h>
 
 #include <ctype.h>
 #ifdef ZZIP_DISABLED
@@ -687,6 +688,7 @@ zzip_dir_free(ZZIP_DIR * dir)
         free(dir->cache.buf32k);
     if (dir->realname)
         free(dir->realname);
+    zzip_index_free_all(dir);
     free(dir);
     return 0;
 }
@@ -211,6 +211,19 @@ zzip_off_t      zzip_seek(ZZIP_FILE * fp, zzip_off_t offset, int whence);
 _zzip_export
 zzip_off_t      zzip_tell(ZZIP_FILE * fp);
 
+/*
+ * random access in deflated files
+ * zzip/index.c
+ */
+_zzip_export
+int             zzip_dir_index_build(ZZIP_DIR * dir, zzip_char_t * name,
+                                     zzip_size_t span);
+_zzip_export
+void *          zzip_dir_index_export(ZZIP_DIR * dir, zzip_size_t * size_p);
+_zzip_export
+int             zzip_dir_index_import(ZZIP_DIR * dir, const void * data,
+                                      zzip_size_t size);
+
 /*
  * reading info of a single file 
  * zzip/stat.c
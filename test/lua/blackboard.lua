@@ -0,0 +1,23 @@
+-- Exercises blackboard subscriptions which are modified from inside
+-- their own callbacks.  This needs the full XCSoar (RunLua has no
+-- blackboard); run it with a replay or the simulator.
+
+local n = 0
+
+xcsoar.blackboard.subscribe("gps", function(data, s)
+  n = n + 1
+  print("gps update " .. n)
+
+  if n == 3 then
+    -- cancel from inside the callback, and subscribe a new
+    -- function which cancels itself on its first call
+    s:cancel()
+
+    xcsoar.blackboard.subscribe("calculated", function(data, s2)
+      print("calculated update, ground speed: " .. tostring(data.ground_speed))
+      s2:cancel()
+    end)
+  elseif n > 3 then
+    error("callback invoked after cancel()")
+  end
+end)
@@ -0,0 +1,182 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Measure random reads inside the members of ZIP archives (e.g. map
+ * files), with and without the seek index.  Pass a map file with
+ * deflated members and one with stored members to compare them.
+ */
+
+#include "io/ZipArchive.hpp"
+#include "io/ZipIndex.hpp"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+#include "util/ScopeExit.hxx"
+
+#include <zzip/util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct Pattern {
+  const char *name;
+  std::size_t min_size, max_size;
+  unsigned count;
+};
+
+static constexpr Pattern patterns[] = {
+  /* shapelib reads one record at a random offset */
+  { "shape", 64, 4096, 500 },
+  /* the JPEG2000 decoder reads larger chunks */
+  { "tile", 16384, 65536, 100 },
+};
+
+struct Member {
+  std::string name;
+  bool deflated;
+  std::size_t size;
+};
+
+static double
+ToMilliseconds(Clock::duration d) noexcept
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+static std::vector<Member>
+ListMembers(ZipArchive &archive)
+{
+  std::vector<Member> members;
+
+  std::string name;
+  while (!(name = archive.NextName()).empty()) {
+    ZZIP_STAT st;
+    if (zzip_dir_stat(archive.get(), name.c_str(), &st, 0) < 0 ||
+        st.st_size < 65536)
+      continue;
+
+    members.push_back({std::move(name), st.d_compr != 0,
+                       std::size_t(st.st_size)});
+  }
+
+  return members;
+}
+
+static Clock::duration
+RandomReads(ZipArchive &archive, const Member &member,
+            const Pattern &pattern)
+{
+  ZZIP_FILE *file = zzip_open_rb(archive.get(), member.name.c_str());
+  if (file == nullptr)
+    throw std::runtime_error("Failed to open " + member.name);
+
+  AtScopeExit(file) { zzip_close(file); };
+
+  std::vector<char> buffer(pattern.max_size);
+  std::minstd_rand random(42);
+
+  const auto start = Clock::now();
+
+  for (unsigned i = 0; i < pattern.count; ++i) {
+    const std::size_t offset = random() % member.size;
+    const std::size_t size =
+      std::min(pattern.min_size +
+               random() % (pattern.max_size - pattern.min_size),
+               member.size - offset);
+
+    if (zzip_pread(file, buffer.data(), size, offset) != size)
+      throw std::runtime_error("Failed to read " + member.name);
+  }
+
+  return Clock::now() - start;
+}
+
+static void
+Benchmark(Path path)
+{
+  ZipArchive plain(path), indexed(path);
+  const auto members = ListMembers(plain);
+
+  printf("%s\n", path.c_str());
+  printf("  %-28s %-8s %9s %9s", "member", "method", "KiB", "index ms");
+  for (const auto &pattern : patterns)
+    printf(" %9s ms %9s ms", pattern.name, "indexed");
+  printf("\n");
+
+  Clock::duration total_plain{}, total_indexed{}, total_build{};
+
+  for (const auto &member : members) {
+    const auto start = Clock::now();
+    if (member.deflated &&
+        zzip_dir_index_build(indexed.get(), member.name.c_str(),
+                             ZIP_INDEX_SPAN) < 0)
+      throw std::runtime_error("Failed to index " + member.name);
+    const auto build = Clock::now() - start;
+    total_build += build;
+
+    printf("  %-28s %-8s %9zu %9.1f", member.name.c_str(),
+           member.deflated ? "deflated" : "stored", member.size / 1024,
+           ToMilliseconds(build));
+
+    for (const auto &pattern : patterns) {
+      const auto a = RandomReads(plain, member, pattern);
+      const auto b = RandomReads(indexed, member, pattern);
+      total_plain += a;
+      total_indexed += b;
+
+      printf(" %12.1f %12.1f", ToMilliseconds(a), ToMilliseconds(b));
+    }
+
+    printf("\n");
+  }
+
+  printf("  total: %.1f ms without index, %.1f ms with index"
+         " (+%.1f ms to build it)\n\n",
+         ToMilliseconds(total_plain), ToMilliseconds(total_indexed),
+         ToMilliseconds(total_build));
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.xcm ...");
+
+  do {
+    Benchmark(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -51,6 +51,10 @@ LoadEmulator(Args &args)
     return new VegaEmulator();
   else if (strcmp(driver, "FLARM") == 0)
     return new FLARMEmulator();
+  else if (strcmp(driver, "FLARM_OLD") == 0)
+    return new FLARMEmulator(true);
+  else if (strcmp(driver, "FLARM_LOSSY") == 0)
+    return new FLARMEmulator(false, true);
   else {
     fprintf(stderr, "No such emulator driver: %s\n", driver);
     exit(EXIT_FAILURE);
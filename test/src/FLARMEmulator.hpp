@@ -26,6 +26,7 @@ Copyright_License {
 #include "DeviceEmulator.hpp"
 #include "Device/Util/LineSplitter.hpp"
 #include "Device/Driver/FLARM/BinaryProtocol.hpp"
+#include "Device/Driver/FLARM/CRC16.hpp"
 #include "Device/Util/NMEAWriter.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
@@ -35,18 +36,48 @@ Copyright_License {
 
 #include <string>
 #include <map>
+#include <cassert>
 #include <stdio.h>
 #include <string.h>
 
 class FLARMEmulator : public Emulator, PortLineSplitter {
+  static constexpr size_t IGC_BLOCK_SIZE = 512;
+
   std::map<std::string, std::string> settings;
 
   bool binary;
   StaticFifoBuffer<std::byte, 256u> binary_buffer;
 
+  /**
+   * Emulate an old firmware which handles only one binary frame at a
+   * time and drops all frames received while it is busy.
+   */
+  const bool single_frame;
+
+  /**
+   * If non-zero, the answer to this GetIGCData request (counting
+   * down) gets lost once, as on a noisy Bluetooth link.
+   */
+  unsigned drop_countdown;
+
+  bool record_selected = false;
+  std::string igc_file;
+  size_t igc_position;
+
 public:
-  FLARMEmulator():binary(false) {
+  explicit FLARMEmulator(bool _single_frame=false, bool lossy=false)
+    :binary(false), single_frame(_single_frame),
+     drop_countdown(lossy ? 10 : 0) {
     handler = this;
+
+    /* a fake flight; it contains bytes which need to be escaped */
+    igc_file = "AFLAxxxsss\r\n";
+    for (unsigned i = 0; i < 4000; ++i) {
+      char line[64];
+      snprintf(line, sizeof(line),
+               "B%06u5206343N00006198WA0058700558sx%04u\r\n", i, i);
+      igc_file += line;
+    }
   }
 
 private:
@@ -96,29 +127,36 @@ private:
     binary_buffer.Clear();
   }
 
-  size_t Unescape(const uint8_t *const data, const uint8_t *const end,
-                  void *_dest, size_t length) {
+  /**
+   * Unescape exactly the specified number of bytes.
+   *
+   * @return the number of source bytes consumed, 0 if the source is
+   * incomplete or -1 if it is malformed
+   */
+  static ptrdiff_t Unescape(const uint8_t *const data,
+                            const uint8_t *const end,
+                            void *_dest, size_t length) {
     uint8_t *dest = (uint8_t *)_dest;
 
-    const uint8_t *p;
-    for (p = data; length > 0; ++p) {
-      if (p >= end)
-        return std::min(p - data, end - data - 1);
+    const uint8_t *p = data;
+    for (; length > 0; --length, ++p) {
+      if (p == end)
+        return 0;
 
       if (*p == FLARM::START_FRAME)
-        return std::min(p - data, end - data - 1);
+        return -1;
 
       if (*p == FLARM::ESCAPE) {
         ++p;
-        if (p >= end)
-          return std::min(p - data, end - data - 1);
+        if (p == end)
+          return 0;
 
         if (*p == FLARM::ESCAPE_START)
           *dest++ = FLARM::START_FRAME;
         else if (*p == FLARM::ESCAPE_ESCAPE)
           *dest++ = FLARM::ESCAPE;
         else
-          return std::min(p - data, end - data - 1);
+          return -1;
       } else
         *dest++ = *p;
     }
@@ -126,47 +164,146 @@ private:
     return p - data;
   }
 
-  void SendACK(uint16_t sequence_number) {
-    uint16_t payload = ToLE16(sequence_number);
+  void SendFrame(FLARM::MessageType type, uint16_t sequence_number,
+                 const void *data, size_t length) {
+    /* the payload of (N)ACK frames starts with the acknowledged
+       sequence number */
+    uint8_t payload[2 + 1 + IGC_BLOCK_SIZE + 1];
+    assert(length <= sizeof(payload) - 2);
+
+    const PackedLE16 le_sequence_number = sequence_number;
+    memcpy(payload, &le_sequence_number, sizeof(le_sequence_number));
+    if (length > 0)
+      memcpy(payload + 2, data, length);
+
     FLARM::FrameHeader header =
-      FLARM::PrepareFrameHeader(sequence_number, FLARM::MT_ACK,
-                                &payload, sizeof(payload));
+      FLARM::PrepareFrameHeader(sequence_number, type,
+                                payload, 2 + length);
     port->Write(FLARM::START_FRAME);
     FLARM::SendEscaped(*port, &header, sizeof(header), *env,
                        std::chrono::seconds(2));
-    FLARM::SendEscaped(*port, &payload, sizeof(payload), *env,
+    FLARM::SendEscaped(*port, payload, 2 + length, *env,
                        std::chrono::seconds(2));
   }
 
-  size_t HandleBinary(const void *_data, size_t length) {
-    const uint8_t *const data = (const uint8_t *)_data, *end = data + length;
-    const uint8_t *p = data;
+  void SendACK(uint16_t sequence_number,
+               const void *data=nullptr, size_t length=0) {
+    SendFrame(FLARM::MT_ACK, sequence_number, data, length);
+  }
 
-    p = std::find(p, end, FLARM::START_FRAME);
-    if (p == NULL)
-      return length;
+  void SendNACK(uint16_t sequence_number) {
+    SendFrame(FLARM::MT_NACK, sequence_number, nullptr, 0);
+  }
 
-    ++p;
+  void SendIGCData(uint16_t sequence_number) {
+    if (!record_selected) {
+      SendNACK(sequence_number);
+      return;
+    }
 
-    FLARM::FrameHeader header;
-    size_t nbytes = Unescape(p, end, &header, sizeof(header));
-    p += nbytes;
-    if (nbytes < sizeof(header))
-      return p - data;
+    const size_t remaining = igc_file.size() - igc_position;
+    const size_t length = std::min(remaining, IGC_BLOCK_SIZE);
+    const bool last = length == remaining;
+
+    uint8_t payload[1 + IGC_BLOCK_SIZE + 1];
+    payload[0] = (igc_position + length) * 100 / igc_file.size();
+    memcpy(payload + 1, igc_file.data() + igc_position, length);
+    igc_position += length;
 
-    //XXX size_t payload_length = header.GetLength();
+    size_t payload_length = 1 + length;
+    if (last) {
+      payload[payload_length++] = 0x1A;
+      record_selected = false;
+    }
+
+    if (drop_countdown > 0 && --drop_countdown == 0)
+      return;
+
+    SendACK(sequence_number, payload, payload_length);
+  }
+
+  void HandleFrame(const FLARM::FrameHeader &header,
+                   const uint8_t *payload, size_t payload_length) {
+    const uint16_t sequence_number = header.sequence_number;
 
     switch (header.type) {
     case FLARM::MT_PING:
+      SendACK(sequence_number);
+      break;
+
     case FLARM::MT_SELECTRECORD:
-      SendACK(header.sequence_number);
+      /* there is only one flight */
+      if (payload_length >= 1 && payload[0] == 0) {
+        record_selected = true;
+        igc_position = 0;
+        SendACK(sequence_number);
+      } else
+        SendNACK(sequence_number);
+      break;
+
+    case FLARM::MT_GETRECORDINFO:
+      {
+        static constexpr char info[] =
+          "18CG6NG1.IGC|2011-08-12|12:23:48|02:03:25|TOBIAS BIENIEK|TH|Club";
+        SendACK(sequence_number, info, sizeof(info));
+      }
+      break;
+
+    case FLARM::MT_GETIGCDATA:
+      SendIGCData(sequence_number);
       break;
 
     case FLARM::MT_EXIT:
-      SendACK(header.sequence_number);
+      SendACK(sequence_number);
       binary = false;
       break;
     }
+  }
+
+  size_t HandleBinary(const void *_data, size_t length) {
+    const uint8_t *const data = (const uint8_t *)_data, *end = data + length;
+
+    const uint8_t *start = std::find(data, end, FLARM::START_FRAME);
+    if (start == end)
+      return length;
+
+    const uint8_t *p = start + 1;
+
+    FLARM::FrameHeader header;
+    ptrdiff_t nbytes = Unescape(p, end, &header, sizeof(header));
+    if (nbytes == 0)
+      /* incomplete: wait for more data */
+      return start - data;
+    else if (nbytes < 0)
+      return p - data;
+
+    p += nbytes;
+
+    uint8_t payload[64];
+    /* the header fields are little-endian (PackedLE16); convert them
+       once */
+    const uint16_t frame_length = header.length;
+    const size_t payload_length = frame_length > sizeof(header)
+      ? frame_length - sizeof(header)
+      : 0;
+    if (payload_length > sizeof(payload))
+      return p - data;
+
+    if (payload_length > 0) {
+      nbytes = Unescape(p, end, payload, payload_length);
+      if (nbytes == 0)
+        return start - data;
+      else if (nbytes < 0)
+        return p - data;
+
+      p += nbytes;
+    }
+
+    const uint16_t crc = header.crc;
+    if (crc == FLARM::CalculateCRC(header,
+                                   payload_length > 0 ? payload : nullptr,
+                                   payload_length))
+      HandleFrame(header, payload, payload_length);
 
     return p - data;
   }
@@ -201,6 +338,12 @@ private:
         }
 
         binary_buffer.Consume(nbytes);
+
+        if (single_frame) {
+          /* drop everything which has arrived meanwhile */
+          binary_buffer.Clear();
+          return;
+        }
       }
     } while (data < end);
   }
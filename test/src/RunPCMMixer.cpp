@@ -0,0 +1,120 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Plays a tone through a #PCMMixer and prints the output buffer
+ * statistics.  To exercise the ALSA player without a sound card, run
+ * it with ALSA_DEVICE=null; ALSA_LATENCY and ALSA_MAX_LATENCY select
+ * the (adaptive) buffer size.  The optional second argument blocks
+ * the event loop once per second for the given number of
+ * milliseconds, which provokes underruns.
+ */
+
+#include "Audio/Features.hpp"
+
+#ifndef HAVE_PCM_PLAYER
+#error PCMPlayer not available
+#endif
+
+#include "Audio/PCMMixer.hpp"
+#include "Audio/PCMPlayerFactory.hpp"
+#include "Audio/ToneSynthesiser.hpp"
+#include "ui/window/Init.hpp"
+#include "event/Loop.hxx"
+#include "event/FineTimerEvent.hxx"
+#include "system/Args.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+static constexpr unsigned sample_rate = 44100;
+
+struct Instance {
+  EventLoop event_loop;
+
+  PCMMixer mixer{sample_rate, std::unique_ptr<PCMPlayer>(PCMPlayerFactory::CreateInstanceForDirectAccess(event_loop))};
+
+  FineTimerEvent stop_timer{event_loop, BIND_THIS_METHOD(OnStopTimer)};
+  FineTimerEvent stall_timer{event_loop, BIND_THIS_METHOD(OnStallTimer)};
+
+  std::chrono::milliseconds stall{};
+
+  Instance(std::chrono::seconds duration,
+           std::chrono::milliseconds _stall) noexcept
+    :stall(_stall) {
+    stop_timer.Schedule(duration);
+    if (stall.count() > 0)
+      stall_timer.Schedule(std::chrono::seconds(1));
+  }
+
+  void OnStopTimer() noexcept {
+    event_loop.Break();
+  }
+
+  void OnStallTimer() noexcept {
+    std::this_thread::sleep_for(stall);
+    stall_timer.Schedule(std::chrono::seconds(1));
+  }
+};
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "SECONDS [STALL_MS]");
+  const int duration = args.ExpectNextInt();
+  const int stall = args.IsEmpty() ? 0 : args.ExpectNextInt();
+  args.ExpectEnd();
+
+  if (duration <= 0 || stall < 0) {
+    fprintf(stderr, "Invalid duration\n");
+    return EXIT_FAILURE;
+  }
+
+  ScreenGlobalInit screen;
+
+  Instance instance{std::chrono::seconds(duration),
+                    std::chrono::milliseconds(stall)};
+
+  ToneSynthesiser tone(sample_rate);
+  tone.SetTone(440);
+
+  if (!instance.mixer.Start(tone)) {
+    fprintf(stderr, "Failed to start PCMMixer\n");
+    return EXIT_FAILURE;
+  }
+
+  instance.event_loop.Run();
+
+  instance.mixer.Stop(tone);
+
+  const auto statistics = instance.mixer.GetStatistics();
+  printf("underruns=%u buffer=%u fill=%u min_fill=%u latency=%uus\n",
+         statistics.underruns, statistics.buffer_frames,
+         statistics.fill_frames, statistics.min_fill_frames,
+         statistics.latency_us);
+
+  return EXIT_SUCCESS;
+}
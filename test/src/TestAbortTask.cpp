@@ -0,0 +1,133 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Engine/Task/Unordered/AbortTask.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+static TaskBehaviour task_behaviour;
+
+/* MC=0: fields above the aircraft can't be reached by climbing */
+static const GlidePolar glide_polar(0);
+
+static const GeoPoint center(Angle::Degrees(7), Angle::Degrees(51));
+
+static WaypointPtr
+AddWaypoint(Waypoints &waypoints, Angle bearing, double distance,
+            Waypoint::Type type, double elevation)
+{
+  Waypoint waypoint(GeoVector(distance, bearing).EndPoint(center));
+  waypoint.type = type;
+  waypoint.elevation = elevation;
+  waypoint.name = _T("Field");
+  return waypoints.Append(std::move(waypoint));
+}
+
+static AircraftState
+MakeAircraft(double altitude) noexcept
+{
+  AircraftState aircraft;
+  aircraft.Reset();
+  aircraft.location = center;
+  aircraft.altitude = altitude;
+  return aircraft;
+}
+
+/**
+ * Many airports close to the aircraft can't be reached (mountain
+ * strips above the aircraft), but one farther away can.  The abort
+ * list must still find it, no matter how many unreachable airports are
+ * nearer.
+ */
+static void
+TestDenseUnreachable()
+{
+  Waypoints waypoints;
+
+  for (unsigned i = 0; i < 200; ++i)
+    AddWaypoint(waypoints, Angle::Degrees(i * 7.3), 1000 + i * 50,
+                Waypoint::Type::AIRFIELD, 2000);
+
+  const auto far_airport =
+    AddWaypoint(waypoints, Angle::Degrees(90), 20000,
+                Waypoint::Type::AIRFIELD, 0);
+  const auto outlanding =
+    AddWaypoint(waypoints, Angle::Degrees(180), 15000,
+                Waypoint::Type::OUTLANDING, 0);
+
+  waypoints.Optimise();
+
+  AbortTask task(task_behaviour, waypoints);
+  const auto aircraft = MakeAircraft(1000);
+  task.Update(aircraft, aircraft, glide_polar);
+
+  ok1(task.HasReachableLandable());
+  ok1(task.TaskSize() >= 2);
+  ok1(task.TaskSize() >= 1 &&
+      &task.GetAlternate(0).GetWaypoint() == far_airport.get());
+  ok1(task.TaskSize() >= 2 &&
+      &task.GetAlternate(1).GetWaypoint() == outlanding.get());
+}
+
+/**
+ * With more reachable landables than fit into the list, the list is
+ * full and begins with airports.
+ */
+static void
+TestDenseReachable()
+{
+  Waypoints waypoints;
+
+  for (unsigned i = 0; i < 200; ++i)
+    AddWaypoint(waypoints, Angle::Degrees(i * 7.3), 1000 + i * 50,
+                i % 2 == 0
+                ? Waypoint::Type::AIRFIELD
+                : Waypoint::Type::OUTLANDING,
+                0);
+
+  waypoints.Optimise();
+
+  AbortTask task(task_behaviour, waypoints);
+  const auto aircraft = MakeAircraft(1000);
+  task.Update(aircraft, aircraft, glide_polar);
+
+  ok1(task.HasReachableLandable());
+  ok1(task.TaskSize() == 10);
+  ok1(task.TaskSize() >= 1 && task.GetAlternate(0).GetWaypoint().IsAirport());
+}
+
+int main()
+{
+  plan_tests(7);
+
+  task_behaviour.SetDefaults();
+
+  TestDenseUnreachable();
+  TestDenseReachable();
+
+  return exit_status();
+}
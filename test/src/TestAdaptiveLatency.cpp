@@ -0,0 +1,65 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Audio/AdaptiveLatency.hpp"
+#include "TestUtil.hpp"
+
+static void
+TestFixed()
+{
+  AdaptiveLatency latency(10000, 0);
+  ok1(latency.GetLatency() == 10000);
+  ok1(!latency.CanGrow());
+  ok1(!latency.OnUnderrun());
+  ok1(latency.GetLatency() == 10000);
+}
+
+static void
+TestGrow()
+{
+  AdaptiveLatency latency(10000, 50000);
+  ok1(latency.CanGrow());
+
+  ok1(latency.OnUnderrun());
+  ok1(latency.GetLatency() == 20000);
+
+  ok1(latency.OnUnderrun());
+  ok1(latency.GetLatency() == 40000);
+
+  /* clipped at the maximum */
+  ok1(latency.OnUnderrun());
+  ok1(latency.GetLatency() == 50000);
+  ok1(!latency.CanGrow());
+
+  ok1(!latency.OnUnderrun());
+  ok1(latency.GetLatency() == 50000);
+}
+
+int main()
+{
+  plan_tests(4 + 10);
+
+  TestFixed();
+  TestGrow();
+
+  return exit_status();
+}
@@ -25,11 +25,116 @@
 #include "FLARM/FlarmNetRecord.hpp"
 #include "FLARM/FlarmId.hpp"
 #include "system/Path.hpp"
+#include "system/FileUtil.hpp"
+#include "system/FileMapping.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "TestUtil.hpp"
 
+#include <algorithm>
+
+static void
+TestCache(const FlarmNetDatabase &db)
+{
+  const Path fln(_T("test/data/flarmnet/data.fln"));
+  Directory::Create(Path(_T("output")));
+  FileCache cache(AllocatedPath(_T("output/cache")));
+
+  {
+    auto os = cache.Save(_T("flarmnet"), fln);
+    BufferedOutputStream bos(*os);
+    db.SaveCache(bos);
+    bos.Flush();
+    os->Commit();
+  }
+
+  auto mapping = cache.Map(_T("flarmnet"), fln);
+  ok1(mapping != nullptr);
+
+  FlarmNetDatabase cached;
+  ok1(mapping != nullptr &&
+      cached.LoadCache(std::move(mapping), FileCache::GetHeaderSize()));
+  ok1(cached.size() == db.size());
+
+  const FlarmId id = FlarmId::Parse("DDA85C", NULL);
+  const FlarmNetRecord *record = cached.FindRecordById(id);
+  ok1(record != NULL && StringIsEqual(record->pilot, _T("Tobias Bieniek")));
+  ok1(cached.FindRecordById(FlarmId::Parse("123456", NULL)) == NULL);
+
+  const FlarmNetRecord *array[3];
+  ok1(cached.Search(_T("Bienek"), 1, array, 3) >= 1 &&
+      array[0]->GetId() == id);
+
+  /* modifications copy the mapped records */
+  FlarmNetRecord new_record = *record;
+  new_record.id = _T("000001");
+  cached.Insert(new_record);
+  ok1(cached.size() == db.size() + 1);
+  ok1(StringIsEqual(cached.begin()->id, _T("000001")));
+  record = cached.FindRecordById(id);
+  ok1(record != NULL && StringIsEqual(record->pilot, _T("Tobias Bieniek")));
+
+  /* a truncated file is rejected */
+  mapping = std::make_unique<FileMapping>(Path(_T("test/data/flarmnet/data.fln")));
+  ok1(!cached.LoadCache(std::move(mapping), 0));
+
+  /* so is a record with an unterminated string */
+  {
+    FlarmNetDatabase corrupt;
+    FlarmNetRecord bad_record = *db.begin();
+    std::fill_n(bad_record.callsign.data(), bad_record.callsign.capacity(),
+                _T('X'));
+    corrupt.Append(bad_record);
+    corrupt.Finish();
+
+    auto os = cache.Save(_T("flarmnet"), fln);
+    BufferedOutputStream bos(*os);
+    corrupt.SaveCache(bos);
+    bos.Flush();
+    os->Commit();
+  }
+
+  mapping = cache.Map(_T("flarmnet"), fln);
+  ok1(mapping != nullptr &&
+      !cached.LoadCache(std::move(mapping), FileCache::GetHeaderSize()));
+}
+
+static FlarmNetRecord
+MakeRecord(const TCHAR *id, const TCHAR *pilot)
+{
+  FlarmNetRecord record{};
+  record.id = id;
+  record.pilot = pilot;
+  return record;
+}
+
+static void
+TestBulkLoad()
+{
+  FlarmNetDatabase db;
+  db.Append(MakeRecord(_T("DDA896"), _T("first")));
+  db.Append(MakeRecord(_T("000001"), _T("low")));
+  db.Append(MakeRecord(_T("DDA896"), _T("duplicate")));
+  db.Append(MakeRecord(_T("DDA85C"), _T("middle")));
+  db.Finish();
+
+  ok1(db.size() == 3);
+  ok1(StringIsEqual(db.begin()->id, _T("000001")));
+
+  const FlarmNetRecord *record =
+    db.FindRecordById(FlarmId::Parse("DDA896", NULL));
+  ok1(record != NULL && StringIsEqual(record->pilot, _T("first")));
+  record = db.FindRecordById(FlarmId::Parse("DDA85C", NULL));
+  ok1(record != NULL && StringIsEqual(record->pilot, _T("middle")));
+
+  const FlarmNetRecord *array[3];
+  ok1(db.Search(_T("middle"), 0, array, 3) == 1 && array[0] == record);
+}
+
 int main()
 {
-  plan_tests(15);
+  plan_tests(38);
 
   FlarmNetDatabase db;
   int count = FlarmNetReader::LoadFile(Path(_T("test/data/flarmnet/data.fln")),
@@ -78,5 +183,25 @@ int main()
   ok1(foundDDA85C);
   ok1(foundDDA896);
 
+  /* the array size is honoured */
+  ok1(db.FindIdsByCallSign(_T("TH"), ids, 1) == 1);
+
+  /* substring search in pilot names and registrations */
+  id = FlarmId::Parse("DDA85C", NULL);
+  ok1(db.Search(_T("Bieniek"), 0, array, 3) == 1 &&
+      array[0]->GetId() == id);
+  ok1(db.Search(_T("4449"), 0, array, 3) == 1 &&
+      array[0]->GetId() == id);
+  ok1(db.Search(_T("tobias"), 0, array, 3) == 2);
+  ok1(db.Search(_T("tobias"), 0, array, 1) == 1);
+
+  /* one typing error */
+  ok1(db.Search(_T("Bienek"), 0, array, 3) == 0);
+  ok1(db.Search(_T("Bienek"), 1, array, 3) >= 1 &&
+      array[0]->GetId() == id);
+
+  TestCache(db);
+  TestBulkLoad();
+
   return exit_status();
 }
@@ -0,0 +1,136 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Logger/FlightIndex.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+static constexpr Path log_path{_T("output/TestFlightIndex.log")};
+static constexpr Path index_path{_T("output/TestFlightIndex.idx")};
+
+static void
+Append(const char *data, bool truncate=false)
+{
+  FileOutputStream file(log_path,
+                        truncate
+                        ? FileOutputStream::Mode::CREATE
+                        : FileOutputStream::Mode::APPEND_OR_CREATE);
+  file.Write(data, strlen(data));
+  file.Commit();
+}
+
+static bool
+IsFlight(const FlightInfo &flight, unsigned day,
+         unsigned start_hour, unsigned end_hour)
+{
+  return flight.date.day == day &&
+    flight.start_time.IsPlausible() &&
+    flight.start_time.hour == start_hour &&
+    (end_hour == 0
+     ? !flight.end_time.IsPlausible()
+     : flight.end_time.IsPlausible() && flight.end_time.hour == end_hour);
+}
+
+int main()
+{
+  plan_tests(22);
+
+  Directory::Create(Path{_T("output")});
+  File::Delete(index_path);
+
+  Append("2022-05-01T10:00:00 start\n"
+         "2022-05-01T12:00:00 landing\n"
+         "2022-05-02T11:00:00 start\n", true);
+
+  /* initial build; the second flight has not landed yet */
+  auto index = LoadFlightIndex(log_path, index_path);
+  ok1(index.GetFlights().size() == 2);
+  ok1(IsFlight(index.GetFlights()[0], 1, 10, 12));
+  ok1(IsFlight(index.GetFlights()[1], 2, 11, 0));
+
+  /* the landing of the second flight, and half a line */
+  Append("2022-05-02T15:00:00 landing\n"
+         "2022-05-03T09:00");
+
+  index = LoadFlightIndex(log_path, index_path);
+  ok1(index.GetFlights().size() == 2);
+  ok1(IsFlight(index.GetFlights()[1], 2, 11, 15));
+
+  /* nothing new in the file: the saved index is used as-is */
+  FlightIndex loaded;
+  loaded.Load(index_path);
+  ok1(loaded.GetFlights().size() == 2);
+  ok1(!loaded.Update(log_path));
+  ok1(loaded.GetFlights().size() == 2);
+  ok1(IsFlight(loaded.GetFlights()[1], 2, 11, 15));
+
+  /* complete the line, and add another flight */
+  Append(":00 start\n"
+         "2022-05-03T13:00:00 start\n"
+         "2022-05-03T14:00:00 landing\n");
+
+  ok1(loaded.Update(log_path));
+  ok1(loaded.GetFlights().size() == 4);
+  ok1(IsFlight(loaded.GetFlights()[2], 3, 9, 0));
+  ok1(IsFlight(loaded.GetFlights()[3], 3, 13, 14));
+
+  /* a new (shorter) log file replaces the old one */
+  Append("2022-06-01T08:00:00 start\n"
+         "2022-06-01T09:00:00 landing\n", true);
+
+  index = LoadFlightIndex(log_path, index_path);
+  ok1(index.GetFlights().size() == 1);
+  ok1(IsFlight(index.GetFlights()[0], 1, 8, 9));
+
+  /* a missing or corrupt index is rebuilt */
+  Append("garbage");
+  File::Delete(index_path);
+  FileOutputStream(index_path).Commit();
+
+  index = LoadFlightIndex(log_path, index_path);
+  ok1(index.GetFlights().size() == 1);
+  ok1(IsFlight(index.GetFlights()[0], 1, 8, 9));
+
+  /* readers see new flights, but never write the index */
+  Append("\n2022-06-02T08:00:00 start\n"
+         "2022-06-02T10:00:00 landing\n");
+  File::Delete(index_path);
+
+  index = ReadFlightIndex(log_path, index_path);
+  ok1(index.GetFlights().size() == 2);
+  ok1(IsFlight(index.GetFlights()[1], 2, 8, 10));
+  ok1(!File::Exists(index_path));
+
+  /* the index directory is created when saving */
+  static constexpr Path nested_index_path{_T("output/TestFlightIndex/flights.idx")};
+  File::Delete(nested_index_path);
+  index = LoadFlightIndex(log_path, nested_index_path);
+  ok1(index.GetFlights().size() == 2);
+  ok1(File::Exists(nested_index_path));
+
+  return exit_status();
+}
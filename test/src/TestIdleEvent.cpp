@@ -0,0 +1,226 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "event/Loop.hxx"
+#include "event/IdleEvent.hxx"
+#include "event/FineTimerEvent.hxx"
+#include "TestUtil.hpp"
+
+#include <string>
+#include <string_view>
+#include <thread>
+
+using std::string_literals::operator""s;
+
+class Recorder {
+  IdleEvent event;
+
+  std::string &log;
+  const char name;
+
+  const std::chrono::steady_clock::duration delay;
+
+  /**
+   * An optional timer which gets scheduled by the handler.
+   */
+  FineTimerEvent *timer = nullptr;
+
+public:
+  Recorder(EventLoop &loop, std::string &_log, char _name,
+           IdleEvent::Priority priority=IdleEvent::Priority::NORMAL,
+           const char *event_name=nullptr,
+           std::chrono::steady_clock::duration _delay={}) noexcept
+    :event(loop, BIND_THIS_METHOD(OnIdle), priority, event_name),
+     log(_log), name(_name), delay(_delay) {}
+
+  void SetTimer(FineTimerEvent &_timer) noexcept {
+    timer = &_timer;
+  }
+
+  void Schedule() noexcept {
+    event.Schedule();
+  }
+
+private:
+  void OnIdle() noexcept {
+    if (delay.count() > 0)
+      std::this_thread::sleep_for(delay);
+    log.push_back(name);
+
+    if (timer != nullptr)
+      timer->Schedule({});
+  }
+};
+
+static unsigned n_reports;
+static bool slow_reported;
+
+static void
+OnReport(const char *name, Event::Duration) noexcept
+{
+  ++n_reports;
+  if (name != nullptr && std::string_view{name} == "slow")
+    slow_reported = true;
+}
+
+/**
+ * Run the loop like the UI event queue does when it has no events:
+ * until the pending events have been handled, which invokes at most
+ * one "idle" event.
+ */
+static void
+Poll(EventLoop &loop) noexcept
+{
+  loop.ResetFinish();
+  loop.Finish();
+  loop.Run();
+}
+
+static void
+TestPriorities()
+{
+  EventLoop loop;
+  std::string log;
+
+  Recorder low(loop, log, 'l', IdleEvent::Priority::LOW);
+  Recorder normal(loop, log, 'n', IdleEvent::Priority::NORMAL);
+  Recorder high(loop, log, 'h', IdleEvent::Priority::HIGH);
+
+  low.Schedule();
+  normal.Schedule();
+  high.Schedule();
+
+  /* only one "idle" event per Run() after Finish() */
+  Poll(loop);
+  ok1(log == "h"s);
+
+  Poll(loop);
+  Poll(loop);
+  ok1(log == "hnl"s);
+  ok1(loop.GetIdleStatistics().n_invoked == 3);
+}
+
+static void
+TestOrder()
+{
+  EventLoop loop;
+  std::string log;
+
+  Recorder a(loop, log, 'a');
+  Recorder b(loop, log, 'b');
+
+  a.Schedule();
+  b.Schedule();
+
+  Poll(loop);
+  Poll(loop);
+
+  /* the most recently scheduled one runs first */
+  ok1(log == "ba"s);
+}
+
+static void
+TestYieldToTimers()
+{
+  EventLoop loop;
+  std::string log;
+
+  struct Timer {
+    std::string &log;
+    FineTimerEvent event;
+
+    Timer(EventLoop &loop, std::string &_log) noexcept
+      :log(_log), event(loop, BIND_THIS_METHOD(OnTimer)) {}
+
+    void OnTimer() noexcept {
+      log.push_back('t');
+    }
+  } timer(loop, log);
+
+  Recorder a(loop, log, 'a');
+  Recorder b(loop, log, 'b');
+  a.SetTimer(timer.event);
+
+  struct Quit {
+    EventLoop &loop;
+    IdleEvent event;
+
+    explicit Quit(EventLoop &_loop) noexcept
+      :loop(_loop),
+       event(loop, BIND_THIS_METHOD(OnIdle), IdleEvent::Priority::LOW) {}
+
+    void OnIdle() noexcept {
+      loop.Break();
+    }
+  } quit(loop);
+
+  quit.event.Schedule();
+  b.Schedule();
+  a.Schedule();
+
+  /* the timer scheduled by the first "idle" event runs before the
+     second one */
+  loop.Run();
+
+  ok1(log == "atb"s);
+}
+
+static void
+TestBudget()
+{
+  EventLoop loop;
+  loop.SetIdleBudget(std::chrono::milliseconds(1));
+  loop.SetIdleReportCallback(BIND_FUNCTION(OnReport));
+
+  std::string log;
+
+  Recorder slow(loop, log, 's', IdleEvent::Priority::NORMAL, "slow",
+                std::chrono::milliseconds(3));
+  Recorder fast(loop, log, 'f');
+
+  fast.Schedule();
+  slow.Schedule();
+
+  Poll(loop);
+  Poll(loop);
+
+  ok1(log == "sf"s);
+
+  const auto &statistics = loop.GetIdleStatistics();
+  ok1(statistics.n_invoked == 2);
+  ok1(statistics.n_over_budget >= 1);
+  ok1(n_reports == statistics.n_over_budget);
+  ok1(slow_reported);
+  ok1(statistics.max_duration >= std::chrono::milliseconds(3));
+}
+
+int main()
+{
+  plan_tests(11);
+
+  TestPriorities();
+  TestOrder();
+  TestYieldToTimers();
+  TestBudget();
+
+  return exit_status();
+}
@@ -27,6 +27,7 @@
 #include "util/PrintException.hxx"
 #include "TestUtil.hpp"
 
+#include <algorithm>
 #include <memory>
 
 #include <stdio.h>
@@ -39,8 +40,30 @@ static const char *lxn_path = "test/data/lxn_to_igc/18BF14K1.FIL";
 static const char *igc_in_path = "test/data/lxn_to_igc/18BF14K1.igc";
 static const char *igc_out_path = "output/18BF14K1.igc";
 
+/**
+ * Feed the data to the converter in small pieces of varying size, so
+ * packets get split at all possible positions.
+ */
 static bool
-RunConversion()
+ConvertChunked(const void *_data, size_t size, BufferedOutputStream &os)
+{
+  const std::byte *data = (const std::byte *)_data;
+  LX::LXNToIGCConverter converter(os);
+
+  for (size_t position = 0, chunk_size = 1; position < size;
+       chunk_size = chunk_size % 97 + 1) {
+    chunk_size = std::min(chunk_size, size - position);
+    if (!converter.Feed({data + position, chunk_size}))
+      return false;
+
+    position += chunk_size;
+  }
+
+  return converter.Finish();
+}
+
+static bool
+RunConversion(bool chunked)
 {
   FILE *lxn_file = fopen(lxn_path, "rb");
   if (lxn_file == NULL) {
@@ -69,7 +92,9 @@ RunConversion()
     return false;
   }
 
-  bool success = ok1(LX::ConvertLXNToIGC(data, n, igc_bos));
+  bool success = chunked
+    ? ok1(ConvertChunked(data, n, igc_bos))
+    : ok1(LX::ConvertLXNToIGC(data, n, igc_bos));
   free(data);
 
   igc_bos.Flush();
@@ -140,12 +165,14 @@ CompareFiles()
 
 int main()
 try {
-  plan_tests(2);
+  plan_tests(4);
 
-  if (!RunConversion())
-    skip(1, 0, "conversion failed");
-
-  ok1(CompareFiles());
+  for (const bool chunked : {false, true}) {
+    if (!RunConversion(chunked))
+      skip(1, 0, "conversion failed");
+    else
+      ok1(CompareFiles());
+  }
 
   return exit_status();
 } catch (...) {
@@ -0,0 +1,113 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Renderer/LabelBlock.hpp"
+#include "TestUtil.hpp"
+
+static void
+TestOverlap()
+{
+  LabelBlock lb;
+  lb.reset();
+
+  ok1(lb.check({10, 10, 50, 20}));
+  ok1(!lb.check({10, 10, 50, 20}));
+  ok1(!lb.check({40, 15, 80, 30}));
+  ok1(lb.check({51, 10, 90, 20}));
+  ok1(lb.check({10, 21, 50, 30}));
+
+  /* negative coordinates and cell boundaries */
+  ok1(lb.check({-100, -40, -10, -20}));
+  ok1(!lb.check({-20, -30, 5, -25}));
+  ok1(lb.check({60, 60, 70, 70}));
+  ok1(!lb.check({0, 0, 200, 200}));
+
+  /* a wide label spanning many cells */
+  ok1(lb.check({-500, 300, 1500, 320}));
+  ok1(!lb.check({1000, 310, 1010, 315}));
+
+  lb.reset();
+  ok1(lb.check({0, 0, 200, 200}));
+}
+
+static void
+TestUnlimited()
+{
+  LabelBlock lb;
+  lb.reset();
+
+  /* many more labels in one row than the old fixed buckets could
+     hold */
+  bool all = true;
+  for (int i = 0; i < 1000; ++i)
+    all = all && lb.check({i * 12, 100, i * 12 + 10, 110});
+  ok1(all);
+
+  bool none = true;
+  for (int i = 0; i < 1000; ++i)
+    none = none && !lb.check({i * 12 + 2, 105, i * 12 + 8, 108});
+  ok1(none);
+}
+
+static void
+TestCoherence()
+{
+  LabelBlock lb;
+  lb.reset(1.);
+  lb.Remember(3);
+  lb.Remember(1);
+  ok1(!lb.WasPlaced(1));
+
+  /* small scale change: keep the previous placement */
+  lb.reset(1.05);
+  ok1(lb.WasPlaced(1));
+  ok1(lb.WasPlaced(3));
+  ok1(!lb.WasPlaced(2));
+  lb.Remember(2);
+
+  lb.reset(1.);
+  ok1(!lb.WasPlaced(1));
+  ok1(lb.WasPlaced(2));
+  lb.Remember(2);
+
+  /* zoomed: forget it */
+  lb.reset(2.);
+  ok1(!lb.WasPlaced(2));
+  lb.Remember(2);
+
+  /* unknown scale */
+  lb.reset();
+  ok1(!lb.WasPlaced(2));
+}
+
+int
+main()
+{
+  plan_tests(22);
+
+  TestOverlap();
+  TestUnlimited();
+  TestCoherence();
+
+  return exit_status();
+}
@@ -0,0 +1,118 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "util/NGramIndex.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+static const TCHAR *const names[] = {
+  _T("AACHENMERZBRUECK"),
+  _T("BERLINTEMPELHOF"),
+  _T("MUENCHEN"),
+  _T("MUENCHENRIEM"),
+  _T("NEUMARKT"),
+  _T("KLIXTEGELBERG"),
+  _T("TH"),
+};
+
+static bool
+HasCandidate(const std::vector<NGramIndex::Candidate> &candidates,
+             uint32_t id)
+{
+  return std::any_of(candidates.begin(), candidates.end(),
+                     [id](const NGramIndex::Candidate &c){
+                       return c.id == id;
+                     });
+}
+
+static void
+TestDistance()
+{
+  ok1(ApproximateSubstringDistance(_T("MUENCHEN"), _T("NCHE")) == 0);
+  ok1(ApproximateSubstringDistance(_T("MUENCHEN"), _T("MUNCHEN")) == 1);
+  ok1(ApproximateSubstringDistance(_T("MUENCHEN"), _T("MUENXHEN")) == 1);
+  ok1(ApproximateSubstringDistance(_T("MUENCHEN"), _T("MUEENCHEN")) == 1);
+  ok1(ApproximateSubstringDistance(_T("MUENCHEN"), _T("BERLIN")) >= 4);
+  ok1(ApproximateSubstringDistance(_T(""), _T("ABC")) == 3);
+  ok1(ApproximateSubstringDistance(_T("ABC"), _T("")) == 0);
+}
+
+static void
+TestIndex()
+{
+  NGramIndex index;
+  ok1(index.IsEmpty());
+
+  for (unsigned i = 0; i < std::size(names); ++i)
+    index.Add(i, names[i]);
+
+  /* a second string for the same id */
+  index.Add(0, _T("EDKA"));
+
+  index.Build();
+  ok1(!index.IsEmpty());
+
+  std::vector<NGramIndex::Candidate> candidates;
+
+  /* exact substring */
+  ok1(index.FindCandidates(_T("ENCHEN"), 0, candidates));
+  ok1(candidates.size() == 2);
+  ok1(HasCandidate(candidates, 2));
+  ok1(HasCandidate(candidates, 3));
+
+  /* the best candidate comes first */
+  ok1(index.FindCandidates(_T("MUENCHENRIE"), 1, candidates));
+  ok1(!candidates.empty() && candidates.front().id == 3);
+
+  /* one typing error */
+  ok1(index.FindCandidates(_T("TEMPELHOV"), 1, candidates));
+  ok1(HasCandidate(candidates, 1));
+  ok1(!HasCandidate(candidates, 2));
+
+  /* the second string */
+  ok1(index.FindCandidates(_T("EDKA"), 0, candidates));
+  ok1(candidates.size() == 1 && candidates.front().id == 0);
+
+  /* too short to be filtered */
+  ok1(!index.FindCandidates(_T("TH"), 0, candidates));
+  ok1(!index.FindCandidates(_T("EDKA"), 1, candidates));
+
+  /* no match */
+  ok1(index.FindCandidates(_T("XYZXYZ"), 0, candidates));
+  ok1(candidates.empty());
+
+  index.Clear();
+  ok1(index.IsEmpty());
+}
+
+int main()
+{
+  plan_tests(7 + 18);
+
+  TestDistance();
+  TestIndex();
+
+  return exit_status();
+}
@@ -0,0 +1,180 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "util/PackedPointIndex.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+struct TestPoint {
+  int x, y;
+  unsigned id;
+};
+
+struct TestAccessor {
+  int GetX(const TestPoint &p) const noexcept {
+    return p.x;
+  }
+
+  int GetY(const TestPoint &p) const noexcept {
+    return p.y;
+  }
+};
+
+using Index = PackedPointIndex<TestPoint, TestAccessor>;
+
+static unsigned
+SquareDistance(const TestPoint &p, int x, int y)
+{
+  const unsigned dx = std::abs(p.x - x), dy = std::abs(p.y - y);
+  return dx * dx + dy * dy;
+}
+
+static std::vector<unsigned>
+BruteForceWithinRange(const std::vector<TestPoint> &points,
+                      int x, int y, unsigned range)
+{
+  std::vector<unsigned> result;
+  for (const auto &p : points)
+    if (SquareDistance(p, x, y) <= range * range)
+      result.push_back(p.id);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+static unsigned
+BruteForceNearest(const std::vector<TestPoint> &points,
+                  int x, int y, bool odd)
+{
+  unsigned best = std::numeric_limits<unsigned>::max();
+  for (const auto &p : points)
+    if (!odd || p.id % 2 == 1)
+      best = std::min(best, SquareDistance(p, x, y));
+  return best;
+}
+
+static void
+TestRandom(unsigned n)
+{
+  std::mt19937 random(n);
+  std::uniform_int_distribution<int> coordinate(-20000, 20000);
+
+  std::vector<TestPoint> points;
+  for (unsigned i = 0; i < n; ++i)
+    points.push_back({coordinate(random), coordinate(random), i});
+
+  Index index;
+  index.Build(points.begin(), points.end());
+  ok1(index.size() == n);
+
+  bool range_ok = true, nearest_ok = true, nearest_if_ok = true;
+  for (unsigned i = 0; i < 100; ++i) {
+    const int x = coordinate(random), y = coordinate(random);
+    const unsigned range = std::uniform_int_distribution<unsigned>(0, 8000)(random);
+
+    std::vector<unsigned> found;
+    auto visitor = [&found](const TestPoint &p){ found.push_back(p.id); };
+    index.VisitWithinRange({x, y}, range, visitor);
+    std::sort(found.begin(), found.end());
+    if (found != BruteForceWithinRange(points, x, y, range))
+      range_ok = false;
+
+    const auto nearest = index.FindNearest({x, y}, 60000);
+    if (nearest.first == nullptr ||
+        SquareDistance(*nearest.first, x, y) != BruteForceNearest(points, x, y, false))
+      nearest_ok = false;
+
+    const auto nearest_odd =
+      index.FindNearestIf({x, y}, 60000,
+                          [](const TestPoint &p){ return p.id % 2 == 1; });
+    if (n > 1 &&
+        (nearest_odd.first == nullptr || nearest_odd.first->id % 2 != 1 ||
+         SquareDistance(*nearest_odd.first, x, y) != BruteForceNearest(points, x, y, true)))
+      nearest_if_ok = false;
+  }
+
+  ok1(range_ok);
+  ok1(nearest_ok);
+  ok1(nearest_if_ok);
+
+  /* the best-first search must return all values in range in
+     ascending order of distance */
+  bool best_first_ok = true;
+  for (unsigned i = 0; i < 20; ++i) {
+    const int x = coordinate(random), y = coordinate(random);
+    const unsigned range = std::uniform_int_distribution<unsigned>(0, 8000)(random);
+
+    std::vector<unsigned> found;
+    unsigned last = 0;
+    index.VisitNearestIf({x, y}, range,
+                         [](const TestPoint &){ return true; },
+                         [&](const TestPoint &p, unsigned d){
+                           if (d < last || d != SquareDistance(p, x, y))
+                             best_first_ok = false;
+                           last = d;
+                           found.push_back(p.id);
+                           return true;
+                         });
+    std::sort(found.begin(), found.end());
+    if (found != BruteForceWithinRange(points, x, y, range))
+      best_first_ok = false;
+
+    /* stop after the first three */
+    found.clear();
+    index.VisitNearestIf({x, y}, 60000,
+                         [](const TestPoint &p){ return p.id % 2 == 0; },
+                         [&found](const TestPoint &p, unsigned){
+                           found.push_back(p.id);
+                           return found.size() < 3;
+                         });
+    if (found.size() != std::min(3U, (n + 1) / 2))
+      best_first_ok = false;
+  }
+
+  ok1(best_first_ok);
+}
+
+int main()
+{
+  plan_tests(4 + 4 * 5);
+
+  Index index;
+  ok1(index.IsEmpty());
+  ok1(index.FindNearest({0, 0}, 1000).first == nullptr);
+
+  /* no match within range */
+  const TestPoint far[] = {{5000, 5000, 0}};
+  index.Build(std::begin(far), std::end(far));
+  ok1(index.FindNearest({0, 0}, 1000).first == nullptr);
+  ok1(index.FindNearest({0, 0}, 8000).first != nullptr);
+
+  TestRandom(1);
+  TestRandom(17);
+  TestRandom(1000);
+  TestRandom(50000);
+
+  return exit_status();
+}
@@ -0,0 +1,187 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "io/ReadAheadReader.hpp"
+#include "io/MemoryReader.hxx"
+#include "TestUtil.hpp"
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A #Reader which fails after the specified number of bytes.
+ */
+class FailingReader final : public Reader {
+  std::size_t remaining;
+
+public:
+  explicit FailingReader(std::size_t _remaining) noexcept
+    :remaining(_remaining) {}
+
+  std::size_t Read(void *data, std::size_t size) override {
+    if (remaining == 0)
+      throw std::runtime_error("error");
+
+    size = std::min(size, remaining);
+    std::fill_n((std::byte *)data, size, std::byte{0});
+    remaining -= size;
+    return size;
+  }
+};
+
+/**
+ * Forwards to another #Reader which may be replaced.
+ */
+class ProxyReader final : public Reader {
+  Reader *source;
+
+public:
+  explicit ProxyReader(Reader &_source) noexcept
+    :source(&_source) {}
+
+  void SetSource(Reader &_source) noexcept {
+    source = &_source;
+  }
+
+  std::size_t Read(void *data, std::size_t size) override {
+    return source->Read(data, size);
+  }
+};
+
+static std::vector<std::byte>
+ReadAll(Reader &reader, std::mt19937 &random)
+{
+  std::uniform_int_distribution<std::size_t> size_distribution(1, 100000);
+
+  std::vector<std::byte> result;
+  while (true) {
+    const std::size_t size = size_distribution(random);
+    const std::size_t old_size = result.size();
+    result.resize(old_size + size);
+
+    const std::size_t nbytes = reader.Read(result.data() + old_size, size);
+    result.resize(old_size + nbytes);
+    if (nbytes == 0)
+      return result;
+  }
+}
+
+static void
+TestCopy(std::size_t size, bool enabled)
+{
+  std::mt19937 random(size);
+
+  std::vector<std::byte> data(size);
+  for (auto &i : data)
+    i = std::byte(random());
+
+  MemoryReader source(data);
+  ReadAheadReader reader(source, enabled);
+  ok1(ReadAll(reader, random) == data);
+}
+
+static void
+TestReset(bool enabled)
+{
+  std::mt19937 random(42);
+
+  std::vector<std::byte> data(1024 * 1024);
+  for (auto &i : data)
+    i = std::byte(random());
+
+  /* a source which can be seeked */
+  std::unique_ptr<MemoryReader> source = std::make_unique<MemoryReader>(data);
+  ProxyReader proxy(*source);
+  ReadAheadReader reader(proxy, enabled);
+
+  std::byte buffer[1000];
+  ok1(reader.Read(buffer, sizeof(buffer)) > 0);
+
+  /* start again from the beginning */
+  reader.Reset();
+  source = std::make_unique<MemoryReader>(data);
+  proxy.SetSource(*source);
+  ok1(ReadAll(reader, random) == data);
+}
+
+static void
+TestError()
+{
+  FailingReader source(200000);
+  ReadAheadReader reader(source);
+
+  std::byte buffer[4096];
+  std::size_t total = 0;
+  bool caught = false;
+
+  try {
+    while (true) {
+      const std::size_t nbytes = reader.Read(buffer, sizeof(buffer));
+      if (nbytes == 0)
+        break;
+
+      total += nbytes;
+    }
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+
+  ok1(caught);
+  ok1(total == 200000);
+}
+
+static void
+TestEarlyDestruction()
+{
+  /* destroy the reader while its thread is blocked on full
+     buffers */
+  std::vector<std::byte> data(4 * 1024 * 1024);
+  MemoryReader source(data);
+
+  {
+    ReadAheadReader reader(source);
+    std::byte buffer[16];
+    reader.Read(buffer, sizeof(buffer));
+  }
+
+  ok1(true);
+}
+
+int main()
+{
+  plan_tests(2 * (4 + 2) + 3);
+
+  for (const bool enabled : {false, true}) {
+    TestCopy(0, enabled);
+    TestCopy(1000, enabled);
+    TestCopy(64 * 1024, enabled);
+    TestCopy(1234567, enabled);
+    TestReset(enabled);
+  }
+
+  TestError();
+  TestEarlyDestruction();
+
+  return exit_status();
+}
@@ -0,0 +1,176 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "ui/canvas/custom/ResourceImageCache.hpp"
+#include "ui/canvas/custom/UncompressedImage.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+static constexpr Path cache_path{_T("output/TestResourceImageCache")};
+
+static UncompressedImage
+MakeImage(unsigned width, unsigned height) noexcept
+{
+  const std::size_t pitch = width * 4;
+  std::unique_ptr<uint8_t[]> data(new uint8_t[pitch * height]);
+  for (std::size_t i = 0; i < pitch * height; ++i)
+    data[i] = uint8_t(i * 7);
+
+  return UncompressedImage(UncompressedImage::Format::RGBA, pitch,
+                           width, height, std::move(data), true);
+}
+
+/**
+ * Remove leftovers from a previous run.
+ */
+static void
+ClearCache()
+{
+  struct DeleteVisitor final : File::Visitor {
+    void Visit(Path path, [[maybe_unused]] Path filename) override {
+      File::Delete(path);
+    }
+  } visitor;
+
+  Directory::VisitFiles(cache_path, visitor);
+}
+
+static UncompressedImage
+DecodeFake([[maybe_unused]] std::span<const std::byte> compressed)
+{
+  return MakeImage(7, 7);
+}
+
+static UncompressedImage
+DecodeError([[maybe_unused]] std::span<const std::byte> compressed)
+{
+  throw std::runtime_error("Corrupt image");
+}
+
+static bool
+Equals(const UncompressedImage &a, const UncompressedImage &b) noexcept
+{
+  return a.GetFormat() == b.GetFormat() &&
+    a.IsFlipped() == b.IsFlipped() &&
+    a.GetPitch() == b.GetPitch() &&
+    a.GetSize() == b.GetSize() &&
+    memcmp(a.GetData(), b.GetData(), a.GetPitch() * a.GetHeight()) == 0;
+}
+
+int
+main()
+{
+  plan_tests(14);
+
+  static constexpr std::byte compressed1[] = {
+    std::byte{1}, std::byte{2}, std::byte{3},
+  };
+  static constexpr std::byte compressed2[] = {
+    std::byte{1}, std::byte{2}, std::byte{4},
+  };
+
+  const auto image = MakeImage(13, 5);
+
+  /* disabled */
+  ResourceImageCache::Save(compressed1, image);
+  ok1(!ResourceImageCache::Load(compressed1).IsDefined());
+
+  Directory::Create(Path{_T("output")});
+  ClearCache();
+  ResourceImageCache::SetDirectory(cache_path);
+
+  /* miss */
+  ok1(!ResourceImageCache::Load(compressed1).IsDefined());
+
+  /* hit */
+  ResourceImageCache::Save(compressed1, image);
+  auto loaded = ResourceImageCache::Load(compressed1);
+  ok1(loaded.IsDefined());
+  ok1(Equals(loaded, image));
+
+  /* other data must not match */
+  ok1(!ResourceImageCache::Load(compressed2).IsDefined());
+
+  const auto image2 = MakeImage(3, 40);
+  ResourceImageCache::Save(compressed2, image2);
+  loaded = ResourceImageCache::Load(compressed2);
+  ok1(loaded.IsDefined() && Equals(loaded, image2));
+
+  loaded = ResourceImageCache::Load(compressed1);
+  ok1(loaded.IsDefined() && Equals(loaded, image));
+
+  /* background write */
+  static constexpr std::byte compressed3[] = {
+    std::byte{5}, std::byte{6},
+  };
+
+  ResourceImageCache::SaveAsync(compressed3, image2);
+  ResourceImageCache::Flush();
+  loaded = ResourceImageCache::Load(compressed3);
+  ok1(loaded.IsDefined() && Equals(loaded, image2));
+
+  /* prefetch: decoded in background, handed out once, but also
+     stored on disk */
+  static constexpr std::byte compressed4[] = {
+    std::byte{7}, std::byte{8},
+  };
+
+  ResourceImageCache::Prefetch(compressed4, DecodeFake);
+  ResourceImageCache::Flush();
+  loaded = ResourceImageCache::Load(compressed4);
+  ok1(loaded.IsDefined() && Equals(loaded, MakeImage(7, 7)));
+  loaded = ResourceImageCache::Load(compressed4);
+  ok1(loaded.IsDefined() && Equals(loaded, MakeImage(7, 7)));
+
+  /* prefetch from a cache file, the decoder is not used */
+  ResourceImageCache::Prefetch(compressed1, DecodeError);
+  ResourceImageCache::Flush();
+  loaded = ResourceImageCache::Load(compressed1);
+  ok1(loaded.IsDefined() && Equals(loaded, image));
+
+  /* decoder errors are ignored */
+  static constexpr std::byte compressed5[] = {
+    std::byte{9},
+  };
+
+  ResourceImageCache::Prefetch(compressed5, DecodeError);
+  ResourceImageCache::Flush();
+  ok1(!ResourceImageCache::Load(compressed5).IsDefined());
+
+  /* disabled again */
+  ResourceImageCache::SetDirectory(nullptr);
+  ok1(!ResourceImageCache::Load(compressed1).IsDefined());
+
+  /* no background writes while disabled */
+  ResourceImageCache::SaveAsync(compressed5, image);
+  ResourceImageCache::Flush();
+  ResourceImageCache::SetDirectory(cache_path);
+  ok1(!ResourceImageCache::Load(compressed5).IsDefined());
+  ResourceImageCache::SetDirectory(nullptr);
+
+  return exit_status();
+}
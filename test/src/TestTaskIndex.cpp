@@ -0,0 +1,181 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Task/TaskIndex.hpp"
+#include "Engine/Task/Factory/TaskFactoryType.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <cmath>
+
+static constexpr Path task_path{_T("test/data/apf-bug554.tsk")};
+static constexpr Path cup_path{_T("test/data/tasks.cup")};
+static constexpr Path bad_path{_T("output/TestTaskIndex.bad")};
+
+static void
+CheckIndex(const TaskIndex &index)
+{
+  ok1(index.size() == 1);
+  if (index.empty()) {
+    skip(7, 0, "no task");
+    return;
+  }
+
+  const auto &entry = index.front();
+  ok1(entry.name.empty());
+  ok1(entry.IsValid());
+  ok1(entry.n_points == 5);
+  ok1(entry.type == TaskFactoryType::FAI_GENERAL);
+  ok1(std::fabs(entry.distance_nominal - 132205) < 1);
+  ok1(entry.bounds.IsInside(GeoPoint(Angle::Degrees(6.98528),
+                                     Angle::Degrees(51.1408))));
+  ok1(!entry.xml.empty());
+}
+
+/**
+ * Load the task from the index instead of the task file.
+ */
+static void
+CheckIndexedTask(const TaskIndexEntry &entry,
+                 const TaskBehaviour &task_behaviour)
+{
+  std::unique_ptr<OrderedTask> task;
+  try {
+    task = LoadIndexedTask(entry, task_behaviour, nullptr);
+  } catch (...) {
+  }
+
+  ok1(task != nullptr);
+  if (task == nullptr) {
+    skip(3, 0, "no task");
+    return;
+  }
+
+  task->UpdateGeometry();
+  ok1(task->TaskSize() == entry.n_points);
+  ok1(task->GetFactoryType() == entry.type);
+  /* the coordinates in the index have six significant digits */
+  ok1(std::fabs(task->GetStats().distance_nominal -
+                entry.distance_nominal) < 50);
+}
+
+static void
+CheckCupIndex(const TaskIndex &index)
+{
+  ok1(index.size() == 3);
+  if (index.size() != 3) {
+    skip(9, 0, "wrong number of tasks");
+    return;
+  }
+
+  ok1(index[0].name == _T("Triangle"));
+  ok1(index[0].IsValid());
+  ok1(index[0].n_points == 4);
+  ok1(index[0].type == TaskFactoryType::RACING);
+
+  ok1(index[1].name == _T("AAT"));
+  ok1(index[1].type == TaskFactoryType::AAT);
+
+  /* refers to a waypoint which is not in the file */
+  ok1(index[2].name.empty());
+  ok1(!index[2].IsValid());
+  ok1(index[2].xml.empty());
+}
+
+static unsigned
+CountCacheFiles(Path cache_path) noexcept
+{
+  struct Visitor : public File::Visitor {
+    unsigned n = 0;
+
+    void Visit(Path, Path) override {
+      ++n;
+    }
+  } visitor;
+
+  Directory::VisitSpecificFiles(cache_path, _T("task-*"), visitor);
+  return visitor.n;
+}
+
+int main()
+{
+  plan_tests(3 * 8 + 2 * 10 + 2 * 4 + 2 + 2);
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  /* parse the file */
+  CheckIndex(BuildTaskIndex(task_path, task_behaviour));
+
+  Directory::Create(Path{_T("output")});
+  FileCache cache{AllocatedPath{_T("output/TestTaskIndex")}};
+
+  /* the first call creates the cache file, the second one loads
+     it */
+  CheckIndex(LoadTaskIndex(&cache, task_path, task_behaviour));
+
+  const auto index = LoadTaskIndex(&cache, task_path, task_behaviour);
+  CheckIndex(index);
+  if (!index.empty())
+    CheckIndexedTask(index.front(), task_behaviour);
+  else
+    skip(4, 0, "no task");
+
+  /* all tasks of a SeeYou file */
+  CheckCupIndex(BuildTaskIndex(cup_path, task_behaviour));
+
+  const auto cup_index = LoadTaskIndex(&cache, cup_path, task_behaviour);
+  CheckCupIndex(cup_index);
+  if (!cup_index.empty())
+    CheckIndexedTask(cup_index.front(), task_behaviour);
+  else
+    skip(4, 0, "no task");
+
+  /* a file which cannot be parsed gets one invalid entry, which is
+     cached, too */
+  {
+    FileOutputStream file(bad_path);
+    file.Write("garbage", 7);
+    file.Commit();
+  }
+
+  const auto bad_index = LoadTaskIndex(&cache, bad_path, task_behaviour);
+  ok1(bad_index.size() == 1);
+  ok1(!bad_index.empty() && !bad_index.front().IsValid());
+
+  /* the cached index of a task file which is gone gets deleted */
+  const Path cache_path{_T("output/TestTaskIndex")};
+  ok1(CountCacheFiles(cache_path) == 3);
+  const Path remaining[] = {task_path};
+  PruneTaskIndexes(cache, remaining);
+  ok1(CountCacheFiles(cache_path) == 1);
+
+  File::Delete(bad_path);
+
+  return exit_status();
+}
@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "thread/TaskScheduler.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * An #OperationEnvironment which reports cancellation after a
+ * certain number of IsCancelled() calls.
+ */
+class CancelAfterOperationEnvironment : public NullOperationEnvironment {
+  mutable std::atomic_uint remaining;
+
+public:
+  explicit CancelAfterOperationEnvironment(unsigned n) noexcept
+    :remaining(n) {}
+
+  bool IsCancelled() const noexcept override {
+    unsigned n = remaining.load();
+    while (n > 0 && !remaining.compare_exchange_weak(n, n - 1)) {}
+    return n == 0;
+  }
+};
+
+static unsigned
+Fibonacci(TaskScheduler &scheduler, unsigned n)
+{
+  if (n < 2)
+    return n;
+
+  unsigned a, b;
+  TaskScheduler::Group group(scheduler);
+  group.Spawn([&](){ a = Fibonacci(scheduler, n - 1); });
+  b = Fibonacci(scheduler, n - 2);
+  group.Wait();
+  return a + b;
+}
+
+static void
+TestParallelFor(TaskScheduler &scheduler)
+{
+  std::vector<unsigned> values(10000);
+  scheduler.ParallelFor(0, values.size(), 0,
+                        [&values](std::size_t begin, std::size_t end){
+                          for (std::size_t i = begin; i < end; ++i)
+                            values[i] = i;
+                        });
+
+  std::vector<unsigned> expected(values.size());
+  std::iota(expected.begin(), expected.end(), 0U);
+  ok1(values == expected);
+
+  std::atomic_uint count{0};
+  scheduler.ParallelFor(0, 1000, 7,
+                        [&count](std::size_t begin, std::size_t end){
+                          count += end - begin;
+                        }, nullptr, TaskScheduler::Priority::LOW);
+  ok1(count == 1000);
+
+  /* empty range */
+  scheduler.ParallelFor(5, 5, 0, [](std::size_t, std::size_t){});
+}
+
+static void
+TestException(TaskScheduler &scheduler)
+{
+  TaskScheduler::Group group(scheduler);
+  std::atomic_uint count{0};
+  for (unsigned i = 0; i < 64; ++i)
+    group.Spawn([&count, i](){
+      ++count;
+      if (i == 17)
+        throw std::runtime_error("error");
+    });
+
+  bool caught = false;
+  try {
+    group.Wait();
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+
+  ok1(caught);
+  ok1(count == 64);
+}
+
+static void
+TestCancel(TaskScheduler &scheduler)
+{
+  TaskScheduler::Group group(scheduler);
+  group.Cancel();
+
+  std::atomic_uint count{0};
+  for (unsigned i = 0; i < 16; ++i)
+    group.Spawn([&count](){ ++count; });
+  group.Wait();
+  ok1(count == 0);
+
+  CancelAfterOperationEnvironment env(10);
+  count = 0;
+  scheduler.ParallelFor(0, 100, 1,
+                        [&count](std::size_t, std::size_t){ ++count; },
+                        &env);
+  ok1(count == 10);
+}
+
+static void
+TestScheduler(TaskScheduler &scheduler)
+{
+  ok1(Fibonacci(scheduler, 20) == 6765);
+  TestParallelFor(scheduler);
+  TestException(scheduler);
+  TestCancel(scheduler);
+}
+
+int main()
+{
+  plan_tests(4 * 7 + 1);
+
+  /* no worker threads: everything runs inside Group::Wait() */
+  {
+    TaskScheduler scheduler(0);
+    ok1(scheduler.GetConcurrency() == 1);
+    TestScheduler(scheduler);
+  }
+
+  {
+    TaskScheduler scheduler(3);
+    scheduler.Start();
+    TestScheduler(scheduler);
+
+    /* tasks submitted while suspended are executed by the waiter */
+    scheduler.Suspend();
+    TestScheduler(scheduler);
+    scheduler.Resume();
+
+    TestScheduler(scheduler);
+    scheduler.Stop();
+  }
+
+  return exit_status();
+}
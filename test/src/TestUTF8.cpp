@@ -25,6 +25,7 @@
 #include "TestUtil.hpp"
 
 #include <cassert>
+#include <string>
 #include <string.h>
 
 static const char *const valid[] = {
@@ -146,6 +147,38 @@ TestTruncateString()
 
 #endif
 
+/**
+ * Check the SIMD/word-at-a-time code paths with strings longer than
+ * one vector, and a non-ASCII character at each possible position.
+ */
+static void
+TestFindNonASCII()
+{
+  std::string s(100, 'a');
+  ok1(FindNonASCII(s) == std::string_view::npos);
+  ok1(FindNonASCII({}) == std::string_view::npos);
+
+  bool find_ok = true, valid_ok = true, invalid_ok = true;
+  for (std::size_t i = 0; i + 1 < s.size(); ++i) {
+    std::string t = s;
+    t[i] = '\xc3';
+    t[i + 1] = '\xbc';
+    if (FindNonASCII(t) != i)
+      find_ok = false;
+    if (!ValidateUTF8(t) || !ValidateUTF8(t.c_str()))
+      valid_ok = false;
+
+    /* a leading byte without its continuation */
+    t[i + 1] = 'b';
+    if (ValidateUTF8(t) || ValidateUTF8(t.c_str()))
+      invalid_ok = false;
+  }
+
+  ok1(find_ok);
+  ok1(valid_ok);
+  ok1(invalid_ok);
+}
+
 int main()
 {
   plan_tests(2 * ARRAY_SIZE(valid) +
@@ -156,7 +189,7 @@ int main()
 #ifndef _UNICODE
              ARRAY_SIZE(truncate_string_tests) +
 #endif
-             9 + 27);
+             9 + 27 + 5);
 
   for (auto i : valid) {
     ok1(ValidateUTF8(i));
@@ -193,6 +226,8 @@ int main()
   TestTruncateString();
 #endif
 
+  TestFindNonASCII();
+
   {
     const char *p = "foo\xe7\x9b\xae";
     auto n = NextUTF8(p);
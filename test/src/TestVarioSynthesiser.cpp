@@ -0,0 +1,131 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Audio/VarioSynthesiser.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr unsigned sample_rate = 44100;
+
+using Clock = VarioSynthesiser::Clock;
+using std::chrono::milliseconds;
+
+/**
+ * Estimate the frequency of a tone by counting the zero crossings.
+ */
+static unsigned
+MeasureFrequency(const int16_t *buffer, size_t n)
+{
+  unsigned crossings = 0;
+  for (size_t i = 1; i < n; ++i)
+    if (buffer[i - 1] < 0 && buffer[i] >= 0)
+      ++crossings;
+
+  return crossings * sample_rate / n;
+}
+
+static bool
+IsNear(unsigned value, unsigned expected)
+{
+  return value * 10 >= expected * 9 && value * 10 <= expected * 11;
+}
+
+static void
+TestRamp()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  std::vector<int16_t> buffer(sample_rate / 10);
+
+  /* the first sample sets the tone right away */
+  const auto t0 = Clock::now() - std::chrono::seconds(1);
+  synthesiser.PushVario(0, t0);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsNear(MeasureFrequency(buffer.data(), buffer.size()), 500));
+
+  /* the next one 50ms later: the tone moves there during 50ms of
+     PCM data */
+  synthesiser.PushVario(-5, t0 + milliseconds(50));
+  const size_t ramp = sample_rate / 20;
+  synthesiser.Synthesise(buffer.data(), ramp);
+
+  const unsigned first = MeasureFrequency(buffer.data(), ramp / 4);
+  const unsigned last = MeasureFrequency(buffer.data() + ramp * 3 / 4,
+                                         ramp / 4);
+  ok1(first < 500 && first > last && last > 200);
+
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsNear(MeasureFrequency(buffer.data(), buffer.size()), 200));
+
+  const auto latency = synthesiser.GetQueueLatency();
+  ok1(latency.n_samples == 2);
+  ok1(latency.max >= milliseconds(950) && latency.max < milliseconds(10000));
+}
+
+static void
+TestLatest()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  std::vector<int16_t> buffer(sample_rate / 10);
+
+  /* samples which were not rendered yet are replaced */
+  const auto now = Clock::now();
+  synthesiser.PushVario(-5, now);
+  synthesiser.PushVario(0, now);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsNear(MeasureFrequency(buffer.data(), buffer.size()), 500));
+  ok1(synthesiser.GetQueueLatency().n_samples == 1);
+}
+
+static void
+TestClimb()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  std::vector<int16_t> buffer(sample_rate);
+
+  /* climbing: the tone is interrupted by silence */
+  synthesiser.PushVario(3);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+
+  const auto n_silent = std::count(buffer.begin(), buffer.end(), 0);
+  ok1(n_silent > (long)buffer.size() / 5);
+  ok1(n_silent < (long)buffer.size() / 2);
+
+  /* SetSilence() stops the tone after finishing the current sine
+     wave */
+  synthesiser.SetSilence();
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(std::count(buffer.begin() + sample_rate / 100, buffer.end(), 0) ==
+      (long)buffer.size() - sample_rate / 100);
+}
+
+int main()
+{
+  plan_tests(5 + 2 + 3);
+
+  TestRamp();
+  TestLatest();
+  TestClimb();
+
+  return exit_status();
+}
@@ -157,6 +157,22 @@ TestNamePrefixVisitor(const Waypoints &waypoints)
   TestNamePrefixVisitor(waypoints, _T("Field"), 51 - 8);
 }
 
+static void
+TestSearchName(const Waypoints &waypoints)
+{
+  /* too short for the n-gram index */
+  ok1(waypoints.SearchName(_T("#17"), 0, 10).size() == 2);
+
+  auto result = waypoints.SearchName(_T("Waypoint #5"), 0, 3);
+  ok1(result.size() == 3 && result.front()->name == _T("Waypoint #5"));
+
+  /* one typing error */
+  result = waypoints.SearchName(_T("airfeld 15"), 1, 10);
+  ok1(!result.empty() && result.front()->name == _T("Airfield #15"));
+
+  ok1(waypoints.SearchName(_T("airfeld 15"), 0, 10).empty());
+}
+
 class CloserThan
 {
   double distance;
@@ -237,6 +253,33 @@ TestGetNearest(const Waypoints &waypoints, const GeoPoint &center)
   ok1(waypoint->original_id == 6);
 }
 
+static void
+TestGetNearestN(const Waypoints &waypoints, const GeoPoint &center)
+{
+  auto result = waypoints.GetNearestN(center, 10000, 5);
+  ok1(result.size() == 5);
+  bool sorted = true;
+  for (unsigned i = 0; i < result.size(); ++i)
+    if (result[i]->original_id != i)
+      sorted = false;
+  ok1(sorted);
+
+  result = waypoints.GetNearestN(center, 2500, 10);
+  ok1(result.size() == 3);
+
+  result = waypoints.GetNearestN(center, 10000, 3, OriginalIDAbove5);
+  ok1(result.size() == 3);
+  ok1(result[0]->original_id == 6 && result[1]->original_id == 7 &&
+      result[2]->original_id == 8);
+
+  unsigned count = 0;
+  waypoints.VisitNearest(center, 150000, nullptr,
+                         [&count](const WaypointPtr &){
+                           return ++count < 20;
+                         });
+  ok1(count == 20);
+}
+
 static void
 TestIterator(const Waypoints &waypoints)
 {
@@ -304,7 +347,7 @@ main(int argc, char** argv)
   if (!ParseArgs(argc, argv))
     return 0;
 
-  plan_tests(52);
+  plan_tests(62);
 
   Waypoints waypoints;
   GeoPoint center(Angle::Degrees(51.4), Angle::Degrees(7.85));
@@ -318,8 +361,10 @@ main(int argc, char** argv)
 
   TestLookups(waypoints, center);
   TestNamePrefixVisitor(waypoints);
+  TestSearchName(waypoints);
   TestRangeVisitor(waypoints, center);
   TestGetNearest(waypoints, center);
+  TestGetNearestN(waypoints, center);
   TestIterator(waypoints);
 
   ok(TestCopy(waypoints), "waypoint copy", 0);
@@ -0,0 +1,177 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "XML/PullParser.hpp"
+#include "XML/Node.hpp"
+#include "util/StringAPI.hxx"
+#include "TestUtil.hpp"
+
+#include <stdexcept>
+
+using Event = XML::PullParser::Event;
+
+static bool
+IsStart(XML::PullParser &parser, const TCHAR *name)
+{
+  return parser.Next() == Event::START_ELEMENT &&
+    StringIsEqual(parser.GetName(), name);
+}
+
+static bool
+IsEnd(XML::PullParser &parser, const TCHAR *name)
+{
+  return parser.Next() == Event::END_ELEMENT &&
+    StringIsEqual(parser.GetName(), name);
+}
+
+static bool
+IsText(XML::PullParser &parser, const TCHAR *text)
+{
+  return parser.Next() == Event::TEXT &&
+    StringIsEqual(parser.GetText(), text);
+}
+
+static bool
+Throws(const TCHAR *xml)
+{
+  XML::PullParser parser(xml);
+
+  try {
+    while (parser.Next() != Event::END_DOCUMENT) {}
+    return false;
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+}
+
+static void
+TestEvents()
+{
+  XML::PullParser parser(_T("<?xml version=\"1.0\"?>\n"
+                            "<a x=\"1\" y='a &amp; b' z>"
+                            "<b/> foo &lt;bar&gt; <c>text</c>"
+                            "</a>"));
+
+  ok1(IsStart(parser, _T("a")));
+  ok1(parser.GetDepth() == 1);
+  ok1(parser.GetAttributes().size() == 3);
+  ok1(StringIsEqual(parser.GetAttribute(_T("x")), _T("1")));
+  ok1(StringIsEqual(parser.GetAttribute(_T("y")), _T("a & b")));
+  ok1(StringIsEqual(parser.GetAttribute(_T("z")), _T("")));
+  ok1(parser.GetAttribute(_T("w")) == nullptr);
+
+  ok1(IsStart(parser, _T("b")));
+  ok1(parser.GetDepth() == 2);
+  ok1(parser.GetAttributes().empty());
+  ok1(IsEnd(parser, _T("b")));
+  ok1(parser.GetDepth() == 1);
+
+  ok1(IsText(parser, _T("foo <bar>")));
+
+  ok1(IsStart(parser, _T("c")));
+  ok1(IsText(parser, _T("text")));
+  ok1(IsEnd(parser, _T("c")));
+
+  ok1(IsEnd(parser, _T("a")));
+  ok1(parser.GetDepth() == 0);
+  ok1(parser.Next() == Event::END_DOCUMENT);
+  ok1(parser.Next() == Event::END_DOCUMENT);
+}
+
+static void
+TestSkipElement()
+{
+  XML::PullParser parser(_T("<a><b><c/><d>x</d></b><e/></a>"));
+
+  ok1(IsStart(parser, _T("a")));
+  ok1(IsStart(parser, _T("b")));
+  parser.SkipElement();
+  ok1(parser.GetDepth() == 1);
+  ok1(IsStart(parser, _T("e")));
+  parser.SkipElement();
+  ok1(IsEnd(parser, _T("a")));
+  ok1(parser.Next() == Event::END_DOCUMENT);
+}
+
+static void
+TestReadElement()
+{
+  XML::PullParser parser(_T("<a><b x=\"1\"><c>y</c><d/></b><e/></a>"));
+
+  ok1(IsStart(parser, _T("a")));
+  ok1(IsStart(parser, _T("b")));
+
+  const XMLNode b = parser.ReadElement();
+  ok1(StringIsEqual(b.GetName(), _T("b")));
+  ok1(StringIsEqual(b.GetAttribute(_T("x")), _T("1")));
+
+  const XMLNode *c = b.GetChildNode(_T("c"));
+  ok1(c != nullptr);
+  ok1(b.GetChildNode(_T("d")) != nullptr);
+
+  ok1(IsStart(parser, _T("e")));
+}
+
+static void
+TestLenient()
+{
+  /* unclosed elements are closed by the end of the input */
+  XML::PullParser parser(_T("<a><b>"));
+  ok1(IsStart(parser, _T("a")));
+  ok1(IsStart(parser, _T("b")));
+  ok1(IsEnd(parser, _T("b")));
+  ok1(IsEnd(parser, _T("a")));
+  ok1(parser.Next() == Event::END_DOCUMENT);
+
+  /* an end tag may close unclosed inner elements */
+  XML::PullParser parser2(_T("<a><b><c></a>"));
+  ok1(IsStart(parser2, _T("a")));
+  ok1(IsStart(parser2, _T("b")));
+  ok1(IsStart(parser2, _T("c")));
+  ok1(IsEnd(parser2, _T("c")));
+  ok1(IsEnd(parser2, _T("b")));
+  ok1(IsEnd(parser2, _T("a")));
+  ok1(parser2.Next() == Event::END_DOCUMENT);
+}
+
+static void
+TestErrors()
+{
+  ok1(Throws(_T("<a></b>")));
+  ok1(Throws(_T("<a>&bogus;</a>")));
+  ok1(Throws(_T("<a =\"x\"/>")));
+  ok1(!Throws(_T("<a></a>")));
+}
+
+int main()
+{
+  plan_tests(20 + 6 + 7 + 12 + 4);
+
+  TestEvents();
+  TestSkipElement();
+  TestReadElement();
+  TestLenient();
+  TestErrors();
+
+  return exit_status();
+}
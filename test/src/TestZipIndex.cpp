@@ -0,0 +1,208 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2022 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "io/ZipArchive.hpp"
+#include "io/ZipIndex.hpp"
+#include "io/FileCache.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <zzip/util.h>
+
+#include <memory>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr Path map_path{_T("test/data/wp_parser/MBG08.xcm")};
+static constexpr const char *member = "roadltrans_line.shp";
+
+static std::vector<unsigned char>
+ReadMember(ZipArchive &archive, const char *name)
+{
+  ZZIP_FILE *file = zzip_open_rb(archive.get(), name);
+  if (file == nullptr)
+    return {};
+
+  std::vector<unsigned char> result;
+  unsigned char buffer[16384];
+  zzip_ssize_t nbytes;
+  while ((nbytes = zzip_file_read(file, buffer, sizeof(buffer))) > 0)
+    result.insert(result.end(), buffer, buffer + nbytes);
+
+  zzip_close(file);
+  return result;
+}
+
+/**
+ * Read random ranges of the member (in the order given by the seed)
+ * and compare them with the reference.
+ *
+ * @return the number of mismatches
+ */
+static unsigned
+RandomReads(ZipArchive &archive, const char *name,
+            const std::vector<unsigned char> &reference, unsigned seed)
+{
+  ZZIP_FILE *file = zzip_open_rb(archive.get(), name);
+  if (file == nullptr)
+    return 1;
+
+  /* a second file in the same archive, to verify switching between
+     files */
+  ZZIP_FILE *other = zzip_open_rb(archive.get(), "airspace.txt");
+
+  unsigned errors = 0;
+  unsigned char buffer[8192];
+
+  for (unsigned i = 0; i < 200; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const std::size_t offset = (seed >> 8) % reference.size();
+    std::size_t size = 1 + (seed >> 4) % sizeof(buffer);
+    if (offset + size > reference.size())
+      size = reference.size() - offset;
+
+    if (zzip_pread(file, buffer, size, offset) != size ||
+        memcmp(buffer, reference.data() + offset, size) != 0)
+      ++errors;
+
+    if (other != nullptr && i % 16 == 0)
+      zzip_file_read(other, buffer, 100);
+  }
+
+  /* seek to the end and back to the beginning */
+  if (zzip_seek(file, reference.size(), SEEK_SET) != (zzip_off_t)reference.size() ||
+      zzip_seek(file, 0, SEEK_SET) != 0 ||
+      zzip_file_read(file, buffer, 16) != 16 ||
+      memcmp(buffer, reference.data(), 16) != 0)
+    ++errors;
+
+  if (other != nullptr)
+    zzip_close(other);
+  zzip_close(file);
+  return errors;
+}
+
+static void
+TestBuild(const std::vector<unsigned char> &reference)
+{
+  ZipArchive archive(map_path);
+
+  /* the span must be large enough for the dictionary */
+  ok1(zzip_dir_index_build(archive.get(), member, 1024) == -1);
+
+  /* without an index */
+  ok1(RandomReads(archive, member, reference, 1) == 0);
+
+  ok1(zzip_dir_index_build(archive.get(), member, 65536) == 1);
+  /* already indexed */
+  ok1(zzip_dir_index_build(archive.get(), member, 65536) == 0);
+
+  ok1(RandomReads(archive, member, reference, 2) == 0);
+  ok1(RandomReads(archive, member, reference, 3) == 0);
+
+  /* all other large deflated members */
+  ok1(zzip_dir_index_build(archive.get(), nullptr, 65536) == 4);
+}
+
+static void
+TestExportImport(const std::vector<unsigned char> &reference)
+{
+  zzip_size_t size;
+  std::unique_ptr<void, decltype(&free)> data{nullptr, free};
+
+  {
+    ZipArchive archive(map_path);
+    ok1(zzip_dir_index_export(archive.get(), &size) == nullptr);
+
+    ok1(zzip_dir_index_build(archive.get(), member, 65536) == 1);
+    data.reset(zzip_dir_index_export(archive.get(), &size));
+    ok1(data != nullptr);
+    if (data == nullptr)
+      return;
+  }
+
+  ZipArchive archive(map_path);
+
+  /* corrupt data is rejected */
+  std::unique_ptr<unsigned char[]> copy{new unsigned char[size]};
+  memcpy(copy.get(), data.get(), size);
+  copy[0] ^= 0xff;
+  ok1(zzip_dir_index_import(archive.get(), copy.get(), size) == -1);
+  ok1(zzip_dir_index_import(archive.get(), data.get(), size - 1) == -1);
+
+  /* another archive is rejected */
+  ZipArchive other(Path{_T("test/data/benalla9.xcm")});
+  ok1(zzip_dir_index_import(other.get(), data.get(), size) == -1);
+
+  ok1(zzip_dir_index_import(archive.get(), data.get(), size) == 1);
+  ok1(zzip_dir_index_import(archive.get(), data.get(), size) == 0);
+  ok1(RandomReads(archive, member, reference, 4) == 0);
+}
+
+static void
+TestFileCache(const std::vector<unsigned char> &reference)
+{
+  Directory::Create(Path{_T("output")});
+  FileCache cache(AllocatedPath{_T("output")});
+  cache.Flush(_T("TestZipIndex"));
+
+  {
+    ZipArchive archive(map_path);
+    LoadZipIndex(archive, map_path, member, &cache, _T("TestZipIndex"));
+    ok1(File::Exists(Path{_T("output/TestZipIndex")}));
+  }
+
+  /* the second time, the index is loaded from the cache */
+  ZipArchive archive(map_path);
+  LoadZipIndex(archive, map_path, member, &cache, _T("TestZipIndex"));
+  ok1(zzip_dir_index_build(archive.get(), member, 65536) == 0);
+  ok1(RandomReads(archive, member, reference, 5) == 0);
+
+  /* a stored member is not indexed, but still works */
+  ZipArchive archive2(map_path);
+  const auto jp2 = ReadMember(archive2, "terrain.jp2");
+  ok1(zzip_dir_index_build(archive2.get(), "terrain.jp2", 65536) == 0);
+  ok1(RandomReads(archive2, "terrain.jp2", jp2, 6) == 0);
+}
+
+int main()
+try {
+  plan_tests(22);
+
+  ZipArchive archive(map_path);
+  const auto reference = ReadMember(archive, member);
+  ok1(reference.size() == 1017868);
+
+  TestBuild(reference);
+  TestExportImport(reference);
+  TestFileCache(reference);
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -20,25 +20,117 @@
 }
 */
 
+
 #include "Logger/GRecord.hpp"
 #include "system/Args.hpp"
+#include "system/FileUtil.hpp"
+#include "thread/TaskScheduler.hpp"
+#include "util/Exception.hxx"
 #include "util/PrintException.hxx"
 
+#include <chrono>
+#include <exception>
+#include <string>
+#include <vector>
+
 #include <stdio.h>
 
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+  AllocatedPath path;
+
+  /**
+   * The error message, or empty if the G record is valid.
+   */
+  std::string error;
+
+  uint64_t size = 0;
+
+  Clock::duration duration{};
+
+  explicit Result(Path _path) noexcept
+    :path(_path) {}
+};
+
+static void
+Verify(Result &result) noexcept
+{
+  const auto start = Clock::now();
+
+  try {
+    result.size = File::GetSize(result.path);
+
+    GRecord g;
+    g.Initialize();
+    g.VerifyGRecordInFile(result.path);
+  } catch (...) {
+    result.error = GetFullMessage(std::current_exception());
+  }
+
+  result.duration = Clock::now() - start;
+}
+
+static double
+ToMilliseconds(Clock::duration d) noexcept
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
 int
 main(int argc, char **argv)
 try {
-  Args args(argc, argv, "FILE.igc");
-  const auto path = args.ExpectNextPath();
-  args.ExpectEnd();
+  Args args(argc, argv, "FILE.igc ...");
+
+  std::vector<Result> results;
+  do {
+    results.emplace_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  /* each file is verified by a worker thread; the MD5 calculation
+     streams over the file, so memory usage does not depend on the
+     file size */
+  TaskScheduler scheduler(TaskScheduler::GetDefaultThreadCount());
+  scheduler.Start();
+
+  const auto start = Clock::now();
+
+  scheduler.ParallelFor(0, results.size(), 1,
+                        [&results](std::size_t begin, std::size_t end){
+                          for (std::size_t i = begin; i < end; ++i)
+                            Verify(results[i]);
+                        });
+
+  const auto duration = Clock::now() - start;
+  scheduler.Stop();
+
+  unsigned n_invalid = 0;
+  uint64_t total_size = 0;
+
+  for (const auto &i : results) {
+    total_size += i.size;
+
+    if (i.error.empty())
+      printf("%s: G record is ok (%.1f ms)\n",
+             i.path.c_str(), ToMilliseconds(i.duration));
+    else {
+      ++n_invalid;
+      printf("%s: %s\n", i.path.c_str(), i.error.c_str());
+    }
+  }
 
-  GRecord g;
-  g.Initialize();
+  if (results.size() > 1) {
+    const double seconds = std::chrono::duration<double>(duration).count();
+    printf("%u of %u files valid; %.1f ms, %.1f files/s, %.1f MB/s"
+           " (%u threads)\n",
+           unsigned(results.size() - n_invalid), unsigned(results.size()),
+           ToMilliseconds(duration),
+           seconds > 0 ? results.size() / seconds : 0.,
+           seconds > 0 ? total_size / seconds / (1024 * 1024) : 0.,
+           scheduler.GetConcurrency());
+  }
 
-  g.VerifyGRecordInFile(path);
-  fprintf(stderr, "G record is ok\n");
-  return EXIT_SUCCESS;
+  return n_invalid == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 } catch (...) {
   PrintException(std::current_exception());
   return EXIT_FAILURE;
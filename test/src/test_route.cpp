@@ -138,6 +138,12 @@ test_route(const unsigned n_airspaces, const RasterMap& map)
         printf("# route airspace size %d\n", size_4);
 
       ok(size_4 >= size_3, "grow as", 0);
+      ok(size_4 == size_1, "same as", 0);
+
+      // nothing changed
+      ok(!as_route.SynchroniseInRange(airspaces, vec.MidPoint(loc_start),
+                                      range, AirspacePredicateTrue),
+         "unchanged as", 0);
 
       scan_airspaces(state, as_route, perf, true, loc_end);
     }
@@ -209,7 +215,7 @@ try {
   } while (map.IsDirty());
   zzip_dir_close(dir);
 
-  plan_tests(4 + NUM_SOL);
+  plan_tests(6 + NUM_SOL);
   ok(test_route(28, map), "route 28", 0);
   return exit_status();
 } catch (const std::runtime_error &e) {